@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <functional>
 #include <initializer_list>
 
 #if _MSC_VER < 1900
@@ -13,6 +14,11 @@
 	#define JSON_NOEXCEPT noexcept
 #endif
 
+namespace flair { namespace utils { class ByteArray; } }
+namespace flair { namespace net { class FileReference; } }
+namespace flair { namespace desktop { class NativeApplication; } }
+namespace flair { namespace internal { namespace services { class IWorkerService; } } }
+
 namespace flair {
 
    class JSONValue;
@@ -119,6 +125,15 @@ namespace flair {
          std::string err;
          return parse(in, err);
       }
+      // Parse length bytes of in, which does not need to be null terminated.
+      static JSON parse(const char * in, size_t length, std::string & err);
+
+      // Parse on the worker service and deliver the result on the main thread. If parse fails,
+      // the callback receives JSON() and a non-empty error message.
+      typedef std::function<void(JSON result, const std::string & err)> ParseCallback;
+      static void parseAsync(std::shared_ptr<utils::ByteArray> bytes, ParseCallback callback);
+      // Load the file reference if required, then parse its data in place.
+      static void parseAsync(std::shared_ptr<net::FileReference> file, ParseCallback callback);
 
       bool operator==(const JSON &rhs) const;
       bool operator<(const JSON &rhs) const;
@@ -137,6 +152,11 @@ namespace flair {
 
    private:
       std::shared_ptr<JSONValue> m_ptr;
+
+   // Internal
+   protected:
+      friend class flair::desktop::NativeApplication;
+      static flair::internal::services::IWorkerService * workerService;
    };
 }
 
@@ -7,6 +7,10 @@
 namespace flair {
    
    class allocator;
+   
+   namespace system {
+      class MemoryCounter;
+   }
 
    class Object : public std::enable_shared_from_this<Object>
    {
@@ -27,6 +31,7 @@ namespace flair {
    // Internal
    private:
       std::shared_ptr<Object> _shared;
+      flair::system::MemoryCounter * _memoryCounter;
       
    protected:
       template<class T>
@@ -5,6 +5,10 @@
 #include "flair/display/Stage.h"
 #include "flair/events/IEventDispatcher.h"
 #include "flair/events/EventDispatcher.h"
+#include "flair/system/IOStats.h"
+
+#include <chrono>
+#include <vector>
 
 namespace flair {
    
@@ -21,7 +25,27 @@ namespace flair {
          class IAsyncIOService;
          class IFileService;
          class IWorkerService;
+         class ITimerService;
+         
+         namespace capture {
+            class RenderService;
+         }
+      }
+      
+      namespace input {
+         class InputLog;
       }
+      
+      namespace utils {
+         template <typename T> class MPSCQueue;
+      }
+   }
+   
+   namespace utils {
+      class ByteArray;
+   }
+   namespace display {
+      class PerformanceOverlay;
    }
    
    namespace desktop {
@@ -29,7 +53,47 @@ namespace flair {
       enum class SystemIdleMode
       {
          KEEP_AWAKE,
-         NORMAL
+         NORMAL,
+         ON_DEMAND
+      };
+      
+      // Timing of the last completed frame, in milliseconds. This does not measure input-to-present
+      // latency: SDL stamps an event when the frame pumps it, the time the OS received it is not
+      // available, so the wait before the pump is missing. The dispatch latencies run from that
+      // pump to the present of the frame that dispatched the event, the time the frame itself
+      // added on top of however long the input had already waited.
+      struct FrameStats
+      {
+         uint64_t frame;
+         float frameTime;
+         
+         // Input events dispatched by the frame, the latencies below are 0 when there were none
+         uint32_t inputEvents;
+         float minDispatchLatency;
+         float maxDispatchLatency;
+         float averageDispatchLatency;
+         
+         // Running average over frames that dispatched input, in milliseconds
+         float smoothedDispatchLatency;
+      };
+      
+      // One step of the startup, in milliseconds since the application was constructed
+      struct StartupPhase
+      {
+         std::string name;
+         float begin;
+         float end;
+         
+         // 0 for the main thread
+         uint32_t thread;
+      };
+      
+      // Complete once the first frame was presented. Set startupTrace in the application
+      // descriptor to a path to also get the phases as a chrome://tracing file.
+      struct StartupStats
+      {
+         float timeToFirstFrame;
+         std::vector<StartupPhase> phases;
       };
       
       class NativeApplication : public flair::events::IEventDispatcher
@@ -59,9 +123,13 @@ namespace flair {
          bool autoExit();
          bool autoExit(bool value);
          
+         // While the window is hidden or minimized nothing is rendered and frames are ticked four
+         // times a second, or at the full rate when executing in the background. Without
+         // executeInBackground the loop may also sleep, see systemIdleMode.
          bool executeInBackground();
          bool executeInBackground(bool value);
          
+         // Seconds without user input before USER_IDLE is dispatched, default 300
          int idleThreshold();
          int idleThreshold(int value);
          
@@ -78,10 +146,27 @@ namespace flair {
          
          static bool supportsMenu();
          
+         // With NORMAL the loop runs at the full rate while the window is visible. Hidden, it sleeps
+         // until the next input, timer, message or I/O completion whenever nothing listens for
+         // ENTER_FRAME, where KEEP_AWAKE keeps ticking. ON_DEMAND sleeps while visible too, so code
+         // that animates from a tick override has to ask for each frame with Stage::invalidate().
          SystemIdleMode systemIdleMode();
          SystemIdleMode systemIdleMode(SystemIdleMode value);
          
+         // Seconds since the last key, mouse, touch or gamepad input
          int timeSinceLastUserInput();
+         
+         const FrameStats & frameStats() const;
+         
+         // Frame rate, a frame time graph, draw calls, texture memory and I/O queue depth drawn
+         // over the stage, also shown with performanceOverlay: true in the application descriptor
+         bool performanceOverlay();
+         bool performanceOverlay(bool value);
+         
+         const StartupStats & startupStats() const;
+         
+         // Collected as requests are delivered, query and reset from the main thread
+         flair::system::IOStats ioStats();
       
          
       // Methods
@@ -102,6 +187,22 @@ namespace flair {
          
          void run();
          
+         // Records the input transitions of every following frame, with the frame delta, into log
+         void startRecording(std::shared_ptr<flair::utils::ByteArray> log);
+         void stopRecording();
+         
+         void resetIOStats();
+         
+         // Plays a recorded log back in place of the platform input, call before run(). Frames are
+         // ticked with the recorded deltas instead of the wall clock, so a session repeats exactly,
+         // and run() returns when the log ends. A headless replay skips the window and rendering.
+         void replay(std::shared_ptr<flair::utils::ByteArray> log, bool headless = false);
+         
+         // Safe from any thread. Queues event for target, or the stage when target is null, and
+         // dispatches it on the main thread before the input of the next frame. Everything posted
+         // by then goes out in one batch, in posting order per thread.
+         void postEvent(std::shared_ptr<flair::events::IEventDispatcher> target, std::shared_ptr<flair::events::Event> event);
+         
          
       // IEventDispatcher
       public:
@@ -150,6 +251,30 @@ namespace flair {
          SystemIdleMode _systemIdleMode;
          flair::JSON _applicationDescriptor;
          std::shared_ptr<flair::display::Stage> _stage;
+         FrameStats _frameStats;
+         std::shared_ptr<flair::display::PerformanceOverlay> _performanceOverlay;
+         
+         std::chrono::steady_clock::time_point _startupTime;
+         StartupStats _startupStats;
+         
+         StartupPhase startupPhase(const char * name, std::chrono::steady_clock::time_point begin, uint32_t thread = 0) const;
+         void writeStartupTrace(std::string const& path) const;
+         
+         flair::internal::input::InputLog * _recording;
+         flair::internal::input::InputLog * _replaying;
+         bool _headless;
+         
+         uint32_t _lastUserInput;
+         bool _userIdle;
+         
+         // How long the loop may block after a frame, 0 for not at all and negative for until
+         // the next event
+         int idleTimeout();
+         
+         typedef std::pair<std::shared_ptr<flair::events::IEventDispatcher>, std::shared_ptr<flair::events::Event>> PostedEvent;
+         flair::internal::utils::MPSCQueue<PostedEvent> * _postedEvents;
+         
+         void dispatchPostedEvents();
          
       private:
          flair::internal::services::IWindowService * windowService;
@@ -162,6 +287,18 @@ namespace flair {
          flair::internal::services::IAsyncIOService * asyncIOService;
          flair::internal::services::IFileService * fileService;
          flair::internal::services::IWorkerService * workerService;
+         flair::internal::services::ITimerService * timerService;
+         
+         // Set when the descriptor asks for a renderCapture, written to renderCapturePath once complete
+         // or with the frames captured so far when the application exits first
+         flair::internal::services::capture::RenderService * renderCapture;
+         std::string renderCapturePath;
+         
+         void writeRenderCapture();
+         
+         // Set when the descriptor asks for a profile, written after profileFrames frames or on exit
+         std::string profilePath;
+         uint64_t profileFrames;
          
       };
       
@@ -42,6 +42,8 @@ namespace display {
    public:
       void lock();
       
+      // Pixels holds rect.height() rows as wide as the whole bitmap, of which the rect columns
+      // are uploaded
       void setPixels(geom::Rectangle rect, std::shared_ptr<utils::ByteArray> pixels, BitmapDataFormat format = BitmapDataFormat::BGRA);
       
       void setPixels(geom::Rectangle rect, std::vector<uint32_t> pixels, BitmapDataFormat format = BitmapDataFormat::BGRA);
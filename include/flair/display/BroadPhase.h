@@ -0,0 +1,79 @@
+#ifndef flair_display_BroadPhase_h
+#define flair_display_BroadPhase_h
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flair/geom/Rectangle.h"
+#include "flair/geom/RectangleSet.h"
+
+namespace flair {
+   namespace display {
+      
+      class DisplayObject;
+      
+      // Tracks registered display objects and finds the overlapping pairs among them.
+      //
+      // Call update() once per frame (for example from an ENTER_FRAME listener). World bounds are
+      // refreshed and kept sorted by their left edge with an insertion sort, which is close to linear
+      // when objects move coherently between frames, and a sweep over the x extents only tests pairs
+      // that already overlap horizontally. Objects are held weakly and dropped once they expire.
+      class BroadPhase
+      {
+      public:
+         typedef std::pair<std::shared_ptr<DisplayObject>, std::shared_ptr<DisplayObject>> Pair;
+         
+         // Optional precise test run on every candidate pair, return false to reject the pair.
+         typedef std::function<bool(const std::shared_ptr<DisplayObject> & a, const std::shared_ptr<DisplayObject> & b)> NarrowPhase;
+         
+      public:
+         BroadPhase();
+         
+      // Properties
+      public:
+         size_t size() const;
+         
+         NarrowPhase narrowPhase() const;
+         NarrowPhase narrowPhase(NarrowPhase narrowPhase);
+         
+         // Overlapping pairs found by the last update
+         const std::vector<Pair> & pairs() const;
+         
+      // Methods
+      public:
+         void add(std::shared_ptr<DisplayObject> object);
+         void remove(std::shared_ptr<DisplayObject> object);
+         bool contains(std::shared_ptr<DisplayObject> object) const;
+         void clear();
+         
+         const std::vector<Pair> & update();
+         
+         // Appends the objects whose bounds (as of the last update) intersect bounds, returns the number appended.
+         size_t query(const geom::Rectangle & bounds, std::vector<std::shared_ptr<DisplayObject>> & objects) const;
+         
+      private:
+         void removeAt(uint32_t index);
+         
+      private:
+         std::vector<std::weak_ptr<DisplayObject>> _objects;
+         std::vector<DisplayObject *> _keys;
+         std::unordered_map<DisplayObject *, uint32_t> _indices;
+         geom::RectangleSet _bounds;
+         
+         std::vector<uint32_t> _order;
+         bool _orderDirty;
+         
+         NarrowPhase _narrowPhase;
+         std::vector<std::shared_ptr<DisplayObject>> _live;
+         std::vector<Pair> _pairs;
+         mutable std::vector<uint32_t> _queryIndices;
+      };
+      
+   }
+}
+
+#endif
@@ -21,6 +21,8 @@ namespace flair {
       class DisplayObject : public events::EventDispatcher
       {
          friend class DisplayObjectContainer;
+         friend class Stage;
+         friend class Inspector;
          
       protected:
          DisplayObject();
@@ -95,12 +97,21 @@ namespace flair {
          
          virtual std::shared_ptr<DisplayObject> hitTest(flair::geom::Point localPoint, bool forTouch = false) const;
          
+         virtual bool hitTestObject(std::shared_ptr<DisplayObject> object) const;
+         
          
       // Internal Methods
       protected:
          void setParent(std::shared_ptr<DisplayObjectContainer> parent);
          virtual void render(RenderSupport *support, float parentAlpha, geom::Matrix parentTransform);
          
+         // Marks the local transform as changed and every ancestor as holding a change
+         void invalidateWorld();
+         
+         // Recomputes the cached world transform, bounds and culling flag of this object and of its
+         // changed descendants. Only touches the subtree, so siblings can update in parallel.
+         virtual void updateWorld(const geom::Matrix & parentTransform, const geom::Rectangle & viewport, bool parentChanged);
+         
          
       protected:
          std::string _name;
@@ -128,6 +139,13 @@ namespace flair {
          
          bool _touchable;
          bool _visible;
+         
+         // World state cached by the Stage update phase before each render
+         flair::geom::Matrix _worldTransform;
+         flair::geom::Rectangle _worldBounds;
+         bool _culled;
+         bool _worldDirty;
+         bool _subtreeDirty;
       };
       
    }
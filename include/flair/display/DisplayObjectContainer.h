@@ -7,12 +7,15 @@
 #include <limits>
 
 #include "flair/display/DisplayObject.h"
+#include "flair/geom/RectangleSet.h"
 
 namespace flair {
    namespace display {
       
       class DisplayObjectContainer : public DisplayObject
       {
+         friend class Stage;
+         
       protected:
          DisplayObjectContainer();
          
@@ -28,6 +31,9 @@ namespace flair {
          float width() const override;
          float height() const override;
          
+         // The union of the bounds of the children, a point at the origin without any
+         geom::Rectangle getBounds(std::shared_ptr<DisplayObject> targetSpace) const override;
+         
          virtual bool contains(std::shared_ptr<DisplayObject> child);
          
          virtual std::shared_ptr<DisplayObject> addChild(std::shared_ptr<DisplayObject> child);
@@ -48,6 +54,20 @@ namespace flair {
          virtual void tick(float deltaSeconds);
          void render(RenderSupport * support, float parentAlpha, geom::Matrix parentTransform) override;
          
+      protected:
+         // Appends the world bounds of the visible, touchable leaves below this container in render
+         // order, so a higher index is drawn on top
+         void collectHitTargets(const geom::Matrix & parentTransform, geom::RectangleSet & bounds, std::vector<DisplayObject *> & objects) const;
+         
+         void updateWorld(const geom::Matrix & parentTransform, const geom::Rectangle & viewport, bool parentChanged) override;
+         
+         // The two halves of updateWorld around the children, so the Stage can split a container
+         // open and update its children in parallel. Returns whether the world transform changed.
+         bool updateWorldTransform(const geom::Matrix & parentTransform, bool parentChanged);
+         
+         // Merges the bounds of the children, the container is culled once all of them are
+         void finishWorld();
+         
       protected:
          std::vector<std::shared_ptr<DisplayObject>> _children;
       };
@@ -0,0 +1,124 @@
+#ifndef flair_display_Inspector_h
+#define flair_display_Inspector_h
+
+#include "flair/flair.h"
+#include "flair/JSON.h"
+#include "flair/geom/Matrix.h"
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace flair { namespace events { class EventDispatcher; } }
+
+namespace flair {
+namespace display {
+   
+   class DisplayObject;
+   class DisplayObjectContainer;
+   class RenderSupport;
+   class Stage;
+   
+   // One display object, with everything below it included
+   struct InspectorNode
+   {
+      std::string name;
+      std::string type;
+      
+      // The stage is at depth 0 and the root of the report has no parent
+      uint32_t depth;
+      int32_t parent;
+      
+      uint32_t objects;
+      uint64_t textureBytes;
+      
+      // Averages per frame over the sampled frames, times in milliseconds
+      float drawCalls;
+      float tickTime;
+      float renderTime;
+      float eventTime;
+      
+      flair::JSON toJSON() const;
+   };
+   
+   struct InspectorReport
+   {
+      // Frames the averages were taken over, 0 before the first frame was sampled
+      uint32_t frames;
+      
+      // Depth first, in render order
+      std::vector<InspectorNode> nodes;
+      
+      flair::JSON toJSON() const;
+   };
+   
+   // Samples what each object on a stage costs in tick, render and its event listeners. While
+   // sampling, every object costs two clock reads per phase, nothing is measured otherwise. The
+   // report walks the display list as it is, with the costs of the last complete window of frames.
+   class Inspector : public Object
+   {
+      friend class flair::allocator;
+      
+   protected:
+      Inspector(std::shared_ptr<Stage> stage, uint32_t frames = 60);
+      
+   public:
+      virtual ~Inspector();
+      
+   // Properties
+   public:
+      uint32_t frames() const;
+      
+      bool sampling() const;
+      
+   // Methods
+   public:
+      // One inspector samples at a time, starting one stops the last
+      void start();
+      void stop();
+      
+      InspectorReport report() const;
+      
+      flair::JSON toJSON() const;
+      
+   // Internal
+   public:
+      struct Sample
+      {
+         uint64_t tickTime;
+         uint64_t renderTime;
+         uint64_t eventTime;
+         uint64_t drawCalls;
+      };
+      
+      // Set while sampling, the display list reports to it
+      static std::atomic<Inspector*> active;
+      
+      static uint64_t now();
+      
+      // Called at the start of every stage tick
+      void frame(Stage const* stage);
+      
+      void tick(DisplayObjectContainer * child, float deltaSeconds);
+      void render(DisplayObject * child, RenderSupport * support, float parentAlpha, geom::Matrix const& transform);
+      
+   protected:
+      // Workers dispatch on their own threads, only the dispatches of the thread that started
+      // sampling are recorded
+      static void dispatched(events::EventDispatcher * dispatcher, uint64_t nanoseconds);
+      
+      std::weak_ptr<Stage> _stage;
+      uint32_t _frames;
+      
+      // Frames into the window being sampled
+      uint32_t _sampled;
+      std::unordered_map<const DisplayObject *, Sample> _current;
+      
+      uint32_t _reported;
+      std::unordered_map<const DisplayObject *, Sample> _last;
+   };
+   
+}}
+
+#endif
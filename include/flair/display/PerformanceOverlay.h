@@ -0,0 +1,76 @@
+#ifndef flair_display_PerformanceOverlay_h
+#define flair_display_PerformanceOverlay_h
+
+#include "flair/flair.h"
+#include "flair/display/DisplayObject.h"
+
+#include <string>
+#include <vector>
+
+namespace flair {
+namespace display {
+   
+   class BitmapData;
+   
+   // Frame rate, frame time, draw calls, texture memory and I/O queue depth over a scrolling
+   // frame time graph. Text and graph live in two bitmaps that are only patched where they
+   // changed, a frame adds one graph column, and the whole overlay takes at most three draws.
+   class PerformanceOverlay : public DisplayObject
+   {
+      friend class flair::allocator;
+      
+   protected:
+      PerformanceOverlay();
+      
+   public:
+      virtual ~PerformanceOverlay();
+      
+   // Properties
+   public:
+      // The numbers as last drawn, one string per line
+      std::vector<std::string> const& lines() const;
+      
+   // Methods
+   public:
+      // Whether the next frame redraws the numbers, four times a second
+      bool due() const;
+      
+      // Queued and in flight I/O requests, shown with the next numbers
+      void ioDepth(size_t queued, size_t inFlight);
+      
+      // Adds one frame, frame time in milliseconds and draw calls without the overlay's own
+      void frame(float frameTime, uint32_t drawCalls);
+      
+   // Internal
+   public:
+      void render(RenderSupport * support, float parentAlpha, geom::Matrix parentTransform) override;
+      
+   protected:
+      void refresh();
+      void drawLine(size_t line, std::string const& text);
+      
+      std::vector<std::string> _lines;
+      std::vector<uint32_t> _textPixels;
+      uint32_t _dirtyLines;
+      
+      std::vector<uint32_t> _graphPixels;
+      size_t _graphHead;
+      
+      // Added since the graph was last uploaded, up to all of them
+      size_t _graphColumns;
+      
+      std::shared_ptr<BitmapData> _text;
+      std::shared_ptr<BitmapData> _graph;
+      
+      // Since the numbers were last drawn
+      float _elapsed;
+      uint32_t _frames;
+      uint64_t _drawCalls;
+      
+      size_t _ioQueued;
+      size_t _ioInFlight;
+   };
+   
+}}
+
+#endif
@@ -3,10 +3,12 @@
 
 #include "flair/flair.h"
 #include "flair/geom/Matrix.h"
+#include "flair/geom/Rectangle.h"
 
 namespace flair { namespace desktop { class NativeApplication; } }
 namespace flair { namespace internal { namespace services { class IRenderService; } } }
 namespace flair { namespace display { class Bitmap; } }
+namespace flair { namespace display { class BitmapData; } }
 
 namespace flair {
 namespace display {
@@ -22,14 +24,24 @@ namespace display {
          virtual ~RenderSupport();
          
          
+      // Properties
+      public:
+         // Every draw submitted since startup, take the difference around what is measured
+         uint64_t drawCalls() const;
+         
       // Methods
       public:
          void renderBitmap(std::shared_ptr<Bitmap> bitmap, geom::Matrix transform);
          
+         // One draw of the source rect of bitmapData, placed by transform
+         void renderBitmapData(std::shared_ptr<BitmapData> bitmapData, geom::Rectangle source, geom::Matrix transform);
+         
          
       // Internal
       protected:
          static flair::internal::services::IRenderService * renderService;
+         
+         uint64_t _drawCalls;
       };
       
 }}
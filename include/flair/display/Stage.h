@@ -3,6 +3,9 @@
 
 #include "flair/flair.h"
 #include "flair/display/DisplayObjectContainer.h"
+#include "flair/geom/RectangleSet.h"
+
+#include <vector>
 
 namespace flair { namespace desktop { class NativeApplication; } }
 
@@ -27,14 +30,56 @@ namespace display {
       
    // Methods
    public:
+      using DisplayObjectContainer::addEventListener;
+      void addEventListener(std::string type, std::function<void(std::shared_ptr<events::Event>)> listener, bool useCapture = false, int32_t priority = 0, bool once = false) override;
+      
+      // Finds the topmost visible, touchable object under each of count stage points. The display
+      // list is walked once into a spatial index that all points are then tested against, and
+      // targets[i] is left empty where nothing was hit.
+      void hitTestPoints(const geom::Point * points, size_t count, std::shared_ptr<DisplayObject> * targets);
+      
+      // Asks for another frame. With SystemIdleMode::ON_DEMAND the application sleeps between
+      // frames, a tick that changed something calls this to be ticked again.
+      void invalidate();
       
    // Internal
    protected:
       friend class flair::desktop::NativeApplication;
       void tick(float deltaSeconds) override;
       
+      // Update phase, run between tick and render. Brings the cached world transforms, bounds and
+      // culling flags of everything that changed since the last frame up to date, spreading the
+      // changed subtrees over the worker threads.
+      void update();
+      
       int _stageWidth;
       int _stageHeight;
+      
+      // Set by invalidate(), cleared by the application once it decided whether to sleep
+      bool _frameRequested;
+      
+      // Set once anything listened for a gamepad event, the application opens the gamepads then
+      bool _gamepadListened;
+      
+      // A subtree handed to a worker, parent's world transform is final before the parallel pass
+      struct WorldUpdate
+      {
+         DisplayObject * object;
+         DisplayObject * parent;
+         bool parentChanged;
+      };
+      
+      geom::Rectangle _viewport;
+      std::vector<WorldUpdate> _worldUpdates;
+      std::vector<WorldUpdate> _worldNext;
+      
+      // Containers split open by the serial pass, in breadth first order
+      std::vector<DisplayObjectContainer *> _worldSplits;
+      
+      // Hit test index, kept between calls so repeated queries reuse the storage
+      geom::RectangleSet _hitBounds;
+      std::vector<DisplayObject *> _hitObjects;
+      std::vector<uint32_t> _hitIndices;
    };
 }}
 
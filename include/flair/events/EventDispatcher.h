@@ -5,9 +5,12 @@
 #include "flair/Object.h"
 #include "flair/events/IEventDispatcher.h"
 
+#include <atomic>
 #include <map>
 #include <functional>
 
+namespace flair { namespace display { class Inspector; } }
+
 namespace flair {
    namespace events {
       
@@ -55,14 +58,23 @@ namespace flair {
          
          bool willTrigger(std::string type) override;
          
+      // Internal
+      protected:
+         friend class flair::display::Inspector;
+         
+         // Set while the display list is inspected, gets the time spent in the listeners of each
+         // dispatch, without the dispatches they made themselves
+         static std::atomic<void (*)(EventDispatcher * dispatcher, uint64_t nanoseconds)> dispatchSampler;
+         
       private:
          struct EventListener
          {
-            EventListener(std::function<void(std::shared_ptr<Event>)>&& callback, bool useCapture, int32_t priority)
-               : callback(callback), useCapture(useCapture), priority(priority), once(false) {};
+            EventListener(std::function<void(std::shared_ptr<Event>)>&& callback, bool useCapture, int32_t priority, bool once)
+               : callback(std::make_shared<std::function<void(std::shared_ptr<Event>)>>(std::move(callback))), useCapture(useCapture), priority(priority), once(once) {};
             bool operator <(const EventListener& rhs) { return rhs.priority >= priority; }
             
-            std::function<void(std::shared_ptr<Event>)> callback;
+            // Shared with the dispatches in progress, so taking a snapshot doesn't copy closures
+            std::shared_ptr<std::function<void(std::shared_ptr<Event>)>> callback;
             bool useCapture;
             int32_t priority;
             bool once;
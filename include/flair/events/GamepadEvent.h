@@ -0,0 +1,57 @@
+#ifndef flair_events_GamepadEvent_h
+#define flair_events_GamepadEvent_h
+
+#include "flair/flair.h"
+#include "flair/events/Event.h"
+
+namespace flair {
+   namespace events {
+      
+      class GamepadEvent : public Event
+      {
+         friend class flair::allocator;
+         
+      protected:
+         GamepadEvent(const char * type, bool bubbles = false, bool cancelable = false, uint32_t device = 0, uint32_t code = 0, float value = 0.0f);
+         
+      public:
+         virtual ~GamepadEvent();
+      
+      
+      // Events
+      public:
+         static const char* DEVICE_ADDED;
+         static const char* DEVICE_REMOVED;
+         static const char* BUTTON_DOWN;
+         static const char* BUTTON_UP;
+         static const char* AXIS_MOVE;
+         
+      
+      // Properties
+      public:
+         // Device slot, from 0 to ui::Gamepad::MAX_DEVICES - 1
+         uint32_t device();
+         
+         // ui::Gamepad button or axis, depending on the event type
+         uint32_t code();
+         
+         // Axis value after the dead zone, 1 or 0 for buttons
+         float value();
+      
+      
+      // Methods
+      public:
+         std::shared_ptr<Event> clone() override;
+         
+         std::string toString() const override;
+      
+      
+      protected:
+         uint32_t _device;
+         uint32_t _code;
+         float _value;
+      };
+   }
+}
+
+#endif
@@ -4,12 +4,25 @@
 #include "flair/flair.h"
 #include "flair/events/Event.h"
 
+namespace flair { namespace desktop { class NativeApplication; } }
+
 namespace flair {
 namespace events {
    
    class MouseEvent : public Event
    {
       friend class flair::allocator;
+      friend class flair::desktop::NativeApplication;
+      
+   public:
+      // A single pointer motion reported by the platform, timestamp is in milliseconds
+      struct Sample {
+         float localX;
+         float localY;
+         float movementX;
+         float movementY;
+         uint32_t timestamp;
+      };
       
    protected:
       MouseEvent(const char * type, bool bubbles = false, bool cancelable = false, float localX = std::numeric_limits<float>::quiet_NaN(), float localY = std::numeric_limits<float>::quiet_NaN(), float movementX = std::numeric_limits<float>::quiet_NaN(), float movementY = std::numeric_limits<float>::quiet_NaN(), std::shared_ptr<Object> relatedObject = nullptr, bool buttonDown = false, int delta = 0, int clickCount = 0, bool ctrlKey = false, bool altKey = false, bool shiftKey = false, bool controlKey = false, bool commandKey = false);
@@ -70,6 +83,12 @@ namespace events {
       
       bool shiftKey();
       
+      // MOUSE_MOVE is dispatched once per frame with the accumulated movement. The motion samples
+      // behind it, oldest first, can be read here while the event is being dispatched.
+      size_t historyLength();
+      
+      const Sample & history(size_t index);
+      
       
    // Methods
    public:
@@ -94,6 +113,13 @@ namespace events {
       bool _controlKey;
       bool _ctrlKey;
       bool _shiftKey;
+      
+   // Internal
+   protected:
+      void history(const Sample * samples, size_t length);
+      
+      const Sample * _history;
+      size_t _historyLength;
    };
 }}
 
@@ -0,0 +1,36 @@
+#ifndef flair_events_TimerEvent_h
+#define flair_events_TimerEvent_h
+
+#include "flair/flair.h"
+#include "flair/events/Event.h"
+
+namespace flair {
+   namespace events {
+      
+      class TimerEvent : public Event
+      {
+         friend class flair::allocator;
+         
+      protected:
+         TimerEvent(const char * type, bool bubbles = false, bool cancelable = false);
+         
+      public:
+         virtual ~TimerEvent();
+      
+      
+      // Events
+      public:
+         static const char* TIMER;
+         static const char* TIMER_COMPLETE;
+      
+      
+      // Methods
+      public:
+         std::shared_ptr<Event> clone() override;
+         
+         std::string toString() const override;
+      };
+   }
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef flair_events_TouchEvent_h
+#define flair_events_TouchEvent_h
+
+#include "flair/flair.h"
+#include "flair/events/Event.h"
+
+#include <limits>
+
+namespace flair { namespace desktop { class NativeApplication; } }
+
+namespace flair {
+namespace events {
+   
+   class TouchEvent : public Event
+   {
+      friend class flair::allocator;
+      friend class flair::desktop::NativeApplication;
+      
+   protected:
+      TouchEvent(const char * type, bool bubbles = true, bool cancelable = false, int64_t touchPointID = 0, bool isPrimaryTouchPoint = false, float localX = std::numeric_limits<float>::quiet_NaN(), float localY = std::numeric_limits<float>::quiet_NaN(), float pressure = std::numeric_limits<float>::quiet_NaN());
+      
+   public:
+      virtual ~TouchEvent();
+      
+      
+   // Events
+   public:
+      static const char * TOUCH_BEGIN;
+      static const char * TOUCH_END;
+      static const char * TOUCH_MOVE;
+      
+      
+   // Properties
+   public:
+      bool isPrimaryTouchPoint();
+      
+      float localX();
+      
+      float localY();
+      
+      float pressure();
+      
+      float stageX();
+      
+      float stageY();
+      
+      int64_t touchPointID();
+      
+      // The touch events of a frame are dispatched together, after every point has been resolved
+      // to its target. These give the position of this event in that batch and the batch size.
+      size_t batchIndex();
+      
+      size_t batchLength();
+      
+      
+   // Methods
+   public:
+      std::shared_ptr<Event> clone() override;
+      
+      std::string toString() const override;
+      
+      
+   protected:
+      bool _isPrimaryTouchPoint;
+      float _localX;
+      float _localY;
+      float _pressure;
+      float _stageX;
+      float _stageY;
+      int64_t _touchPointID;
+      size_t _batchIndex;
+      size_t _batchLength;
+      
+   // Internal
+   protected:
+      // Refills a pooled event for the next dispatch instead of allocating a new one
+      void reset(const char * type, std::shared_ptr<Object> target, int64_t touchPointID, bool isPrimaryTouchPoint, float localX, float localY, float stageX, float stageY, float pressure, size_t batchIndex, size_t batchLength);
+   };
+}}
+
+#endif
@@ -12,36 +12,12 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <typeinfo>
 
 #include "flair/Object.h"
 #include "flair/JSON.h"
-
-namespace {
-   class TraceArgs
-   {
-   public:
-      std::string s;
-      
-   public:
-      TraceArgs(int value) { s = std::to_string(value); }
-      TraceArgs(unsigned int value) { s = std::to_string(value); }
-      TraceArgs(float value) { s = std::to_string(value); }
-      TraceArgs(double value) { s = std::to_string(value); }
-      TraceArgs(std::string value) { s = value; }
-      TraceArgs(const char* value) { s = std::string(value); }
-      
-      template <class T, class = flair::Object>
-      TraceArgs(std::shared_ptr<T> value) { s = value->toString(); }
-   };
-   
-   void doTrace(const TraceArgs* args, size_t num_args)
-   {
-      for (size_t i = 0; i < num_args; ++i) {
-         std::cout << (i > 0 ? " " : "") << args[i].s;
-      }
-      std::cout << std::endl;
-   }
-}
+#include "flair/system/Log.h"
+#include "flair/system/Memory.h"
 
 namespace flair {
 
@@ -51,6 +27,7 @@ namespace flair {
       static std::shared_ptr<T> make_shared()
       {
          auto ptr = new T();
+         count<T>(ptr);
          auto sharedPtr = std::static_pointer_cast<T>(static_cast<Object*>(ptr)->_shared);
          static_cast<Object*>(ptr)->_shared.reset();
          return sharedPtr;
@@ -60,10 +37,21 @@ namespace flair {
       static std::shared_ptr<T> make_shared(Ts... params)
       {
          auto ptr = new T(std::forward<Ts>(params)...);
+         count<T>(ptr);
          auto sharedPtr = std::static_pointer_cast<T>(static_cast<Object*>(ptr)->_shared);
          static_cast<Object*>(ptr)->_shared.reset();
          return sharedPtr;
       };
+      
+   private:
+      // Live objects per class, released by ~Object
+      template<typename T>
+      static void count(T * ptr)
+      {
+         static flair::system::MemoryCounter * counter = new flair::system::MemoryCounter(flair::system::MemoryCategory::OBJECT, typeid(T).name(), sizeof(T));
+         counter->acquire();
+         static_cast<Object*>(ptr)->_memoryCounter = counter;
+      }
    };
    
    template<typename T, typename... Ts>
@@ -80,11 +68,11 @@ namespace flair {
       return allocator::make_shared<T>();
    }
    
+   // Logged at INFO, see flair::system::log
    template <typename... Args>
    void trace(const Args&... args)
    {
-      TraceArgs argArray[] = {args...};
-      doTrace(argArray, sizeof...(Args));
+      flair::system::log<flair::system::LogLevel::INFO>(args...);
    }
    
    namespace display { class Stage; }
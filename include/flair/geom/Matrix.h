@@ -1,16 +1,19 @@
 #ifndef flair_geom_Matrix_h
 #define flair_geom_Matrix_h
 
+#include <cstddef>
+
 namespace flair {
    namespace geom {
       
       class Point;
       
+      // A 2x3 affine transform. Plain data, trivially copyable, and laid out as
+      // { a, b, c, d, tx, ty } so arrays of matrices can be fed to the batch kernels.
       class Matrix
       {
       public:
          Matrix(float a = 1.0f, float b = 0.0f, float c = 0.0f, float d = 1.0f, float tx = 0.0f, float ty = 0.0f);
-         virtual ~Matrix() {};
          
       // Properties
       public:
@@ -46,21 +49,29 @@ namespace flair {
          
          void setTo(float a, float b, float c, float d, float tx, float ty);
          
+      // Batch Methods
+      public:
+         // Transform count interleaved { x, y } points from points into out (may alias).
+         static void transformPoints(const Matrix & m, float const* points, float * out, size_t count);
+         
+         // Transform count { x, y, width, height } rectangles and write their axis aligned
+         // bounds as { x, y, width, height } into out (may alias).
+         static void transformRectangles(const Matrix & m, float const* rects, float * out, size_t count);
+         
+         // out[i] = parents[i] * children[i] for count pairs, out may alias either input.
+         static void concat(Matrix const* parents, Matrix const* children, Matrix * out, size_t count);
+         
       // Operators
       public:
-         Matrix & operator=(Matrix rhs);
          const Matrix operator*(const Matrix & rhs) const;
          
       private:
          float _a;
          float _b;
-         float _u;
          float _c;
          float _d;
-         float _v;
          float _tx;
          float _ty;
-         float _w;
       };
       
    }
@@ -0,0 +1,70 @@
+#ifndef flair_geom_RectangleSet_h
+#define flair_geom_RectangleSet_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace flair {
+   namespace geom {
+      
+      class Point;
+      class Rectangle;
+      
+      // A structure-of-arrays collection of rectangles, stored as separate left, top, right
+      // and bottom columns so culling and picking queries can test several bounds per instruction.
+      //
+      // Query results follow the edge rules of Rectangle::intersects and Rectangle::contains and are
+      // reported either as a bitmask (bit i of word i / 64 is set for a hit) or as a list of indices.
+      class RectangleSet
+      {
+      public:
+         RectangleSet();
+         
+      // Properties
+      public:
+         size_t size() const;
+         bool empty() const;
+         
+         float const* lefts() const;
+         float const* tops() const;
+         float const* rights() const;
+         float const* bottoms() const;
+         
+      // Methods
+      public:
+         uint32_t add(float x, float y, float width, float height);
+         uint32_t add(const Rectangle & r);
+         void set(uint32_t index, float x, float y, float width, float height);
+         void set(uint32_t index, const Rectangle & r);
+         Rectangle rectangle(uint32_t index) const;
+         
+         // Removes the rectangle at index by moving the last rectangle into its slot.
+         void removeAt(uint32_t index);
+         
+         void clear();
+         void reserve(size_t capacity);
+         
+         // Rectangles that intersect bounds, mask is resized to hold one bit per rectangle.
+         void intersectingMask(const Rectangle & bounds, std::vector<uint64_t> & mask) const;
+         
+         // Appends the indices of the rectangles that intersect bounds, returns the number appended.
+         size_t intersecting(const Rectangle & bounds, std::vector<uint32_t> & indices) const;
+         
+         // Rectangles that contain p, mask is resized to hold one bit per rectangle.
+         void containingMask(const Point & p, std::vector<uint64_t> & mask) const;
+         
+         // Appends the indices of the rectangles that contain p, returns the number appended.
+         size_t containing(const Point & p, std::vector<uint32_t> & indices) const;
+         
+      private:
+         std::vector<float> _left;
+         std::vector<float> _top;
+         std::vector<float> _right;
+         std::vector<float> _bottom;
+         
+      };
+   }
+}
+
+#endif
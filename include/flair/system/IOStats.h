@@ -0,0 +1,75 @@
+#ifndef flair_system_IOStats_h
+#define flair_system_IOStats_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flair {
+namespace system {
+   
+   // In milliseconds, percentiles are within 1/16 of the actual value
+   struct LatencyStats
+   {
+      uint64_t count;
+      float min;
+      float mean;
+      float p50;
+      float p90;
+      float p99;
+      float max;
+   };
+   
+   // Every trip of a request through the I/O thread counts, so a file read once per chunk
+   struct IORequestStats
+   {
+      std::string type;
+      uint64_t requests;
+      uint64_t errors;
+      uint64_t bytes;
+      
+      // From enqueue until the I/O thread picked the request up, for a worker job until a pool
+      // thread started it
+      LatencyStats wait;
+      
+      // From then until the result was back on the I/O thread
+      LatencyStats execute;
+      
+      // From then until the main thread dispatched it
+      LatencyStats delivery;
+      
+      LatencyStats total;
+   };
+   
+   // The I/O and worker pipeline, as collected since startup or the last reset
+   struct IOStats
+   {
+      // Requests waiting for the I/O thread and results waiting for the main thread at the time
+      // of the query, and every request between enqueue and delivery
+      size_t inboundDepth;
+      size_t outboundDepth;
+      size_t inFlight;
+      
+      // I/O contexts handed to libuv, out of the ones allocated
+      size_t contextsInUse;
+      size_t contexts;
+      
+      // Averaged over the last window of at least a second
+      float bytesPerSecond;
+      float requestsPerSecond;
+      float jobsPerSecond;
+      
+      // Worker jobs waiting for their callback
+      size_t pendingJobs;
+      
+      // Data parallel loops and how long the caller spent in them
+      LatencyStats parallelLoops;
+      
+      // Only the request types that were seen
+      std::vector<IORequestStats> requests;
+   };
+   
+}}
+
+#endif
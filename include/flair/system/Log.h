@@ -0,0 +1,127 @@
+#ifndef flair_system_Log_h
+#define flair_system_Log_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+// Messages below this level are compiled out, 0 keeps all of them. Set with --log-level.
+#ifndef FLAIR_LOG_LEVEL
+#define FLAIR_LOG_LEVEL 0
+#endif
+
+namespace flair {
+namespace system {
+   
+   enum class LogLevel
+   {
+      FINE,
+      INFO,
+      WARNING,
+      SEVERE
+   };
+   
+   // Messages below the level are dropped at runtime before anything is captured, default FINE
+   LogLevel logLevel();
+   LogLevel logLevel(LogLevel value);
+   
+   // Blocks until everything logged so far, from any thread, is written
+   void flushLog();
+   
+   // Messages dropped because the buffer of their thread was full
+   uint64_t droppedLogMessages();
+   
+   // One argument, captured by value and formatted later on the log thread. Strings are copied
+   // out of the caller's storage before log() returns, objects are captured as their toString().
+   class LogArgument
+   {
+   public:
+      enum class Type : uint8_t
+      {
+         INTEGER,
+         UNSIGNED,
+         REAL,
+         STRING
+      };
+      
+      template <class T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+      LogArgument(T value) : type(Type::INTEGER), integer(value) {}
+      
+      template <class T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, int>::type = 0>
+      LogArgument(T value) : type(Type::UNSIGNED), unsignedInteger(value) {}
+      
+      template <class T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+      LogArgument(T value) : type(Type::REAL), real(value) {}
+      
+      // Enumerations
+      LogArgument(int value) : type(Type::INTEGER), integer(value) {}
+      
+      LogArgument(const char * value) : type(Type::STRING), string(value), length(std::strlen(value)) {}
+      LogArgument(std::string const& value) : type(Type::STRING), string(value.data()), length(value.size()) {}
+      
+      template <class T>
+      LogArgument(std::shared_ptr<T> const& value) : type(Type::STRING), string(nullptr), length(0), owned(value->toString()) {}
+      
+   public:
+      Type type;
+      union
+      {
+         int64_t integer;
+         uint64_t unsignedInteger;
+         double real;
+         const char * string;
+      };
+      size_t length;
+      
+      // Used where string is null
+      std::string owned;
+   };
+   
+   // Internal, copies a message into the calling thread's buffer
+   void writeLog(LogLevel level, LogArgument const* arguments, size_t count);
+   bool logging(LogLevel level);
+   
+   // Writes the arguments separated by spaces on a line of their own. Nothing is formatted on
+   // the calling thread: the arguments are copied into a buffer of that thread, which a
+   // background thread drains, formats and writes to stdout in batches. When the buffer is full
+   // the message is dropped rather than the caller stalled.
+   template <LogLevel level, typename... Args>
+   void log(Args const&... args)
+   {
+      if (static_cast<int>(level) < FLAIR_LOG_LEVEL || !logging(level)) return;
+      
+      LogArgument arguments[] = { args... };
+      writeLog(level, arguments, sizeof...(Args));
+   }
+   
+}}
+
+// Unlike log(), these don't evaluate their arguments when compiled out
+#if FLAIR_LOG_LEVEL <= 0
+#define FLAIR_LOG_FINE(...) flair::system::log<flair::system::LogLevel::FINE>(__VA_ARGS__)
+#else
+#define FLAIR_LOG_FINE(...) ((void)0)
+#endif
+
+#if FLAIR_LOG_LEVEL <= 1
+#define FLAIR_LOG_INFO(...) flair::system::log<flair::system::LogLevel::INFO>(__VA_ARGS__)
+#else
+#define FLAIR_LOG_INFO(...) ((void)0)
+#endif
+
+#if FLAIR_LOG_LEVEL <= 2
+#define FLAIR_LOG_WARNING(...) flair::system::log<flair::system::LogLevel::WARNING>(__VA_ARGS__)
+#else
+#define FLAIR_LOG_WARNING(...) ((void)0)
+#endif
+
+#if FLAIR_LOG_LEVEL <= 3
+#define FLAIR_LOG_SEVERE(...) flair::system::log<flair::system::LogLevel::SEVERE>(__VA_ARGS__)
+#else
+#define FLAIR_LOG_SEVERE(...) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef flair_system_Memory_h
+#define flair_system_Memory_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flair {
+namespace system {
+   
+   enum class MemoryCategory
+   {
+      OBJECT,
+      BYTE_ARRAY,
+      TEXTURE,
+      IO_BUFFER,
+      EVENT_LISTENER
+   };
+   
+   // One kind of allocation, with the high-water marks since startup or resetMemoryPeaks()
+   struct MemoryUsage
+   {
+      MemoryCategory category;
+      std::string name;
+      int64_t count;
+      int64_t bytes;
+      int64_t peakCount;
+      int64_t peakBytes;
+   };
+   
+   struct MemoryStats
+   {
+      // Over every counter, the peak is that of the sum rather than the sum of the peaks
+      int64_t bytes;
+      int64_t peakBytes;
+      
+      // Every counter that was used so far, ordered by bytes
+      std::vector<MemoryUsage> usage;
+   };
+   
+   // Counts the live allocations of one kind from any thread. Objects made with make_shared
+   // are counted per class at their shallow size, textures at an estimate of what the renderer
+   // holds. Counters are never destroyed, create them once and keep them, usually as a leaked
+   // function static.
+   class MemoryCounter
+   {
+   public:
+      MemoryCounter(MemoryCategory category, const char * name, size_t objectSize = 0);
+      
+      MemoryCounter(MemoryCounter const&) = delete;
+      MemoryCounter& operator=(MemoryCounter const&) = delete;
+      
+   // Properties
+   public:
+      MemoryCategory category() const;
+      
+      // A type name for objects, demangled the first time the stats are taken
+      const char * name() const;
+      
+      int64_t count() const;
+      int64_t bytes() const;
+      
+   // Methods
+   public:
+      // Negative to release
+      void add(int64_t count, int64_t bytes);
+      
+      // One object of objectSize
+      void acquire()
+      {
+         add(1, _objectSize);
+      }
+      
+      void release()
+      {
+         add(-1, -_objectSize);
+      }
+      
+   private:
+      friend MemoryStats memoryStats();
+      friend void resetMemoryPeaks();
+      
+      // The name as shown in the stats
+      const char * readableName();
+      
+      MemoryCategory _category;
+      const char * _name;
+      int64_t _objectSize;
+      
+      std::atomic<int64_t> _count;
+      std::atomic<int64_t> _bytes;
+      std::atomic<int64_t> _peakCount;
+      std::atomic<int64_t> _peakBytes;
+      
+      // Demangled on first use and kept, like the counter itself
+      std::atomic<const char*> _readableName;
+      
+      MemoryCounter * _next;
+   };
+   
+   MemoryStats memoryStats();
+   
+   // Starts the high-water marks over from the current usage
+   void resetMemoryPeaks();
+   
+}}
+
+#endif
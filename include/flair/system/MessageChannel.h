@@ -0,0 +1,79 @@
+#ifndef flair_system_MessageChannel_h
+#define flair_system_MessageChannel_h
+
+#include "flair/flair.h"
+#include "flair/events/EventDispatcher.h"
+#include "flair/utils/ByteArray.h"
+
+#include <atomic>
+
+namespace flair { namespace internal { namespace utils { template <typename T> class MPSCQueue; } } }
+
+namespace flair {
+namespace system {
+   
+   class Worker;
+   
+   enum class MessageChannelState
+   {
+      OPEN,
+      CLOSING,
+      CLOSED
+   };
+   
+   // A one way channel between two workers. Any thread may send, only the receiving worker may
+   // receive. Messages queue without locks and only the first send after the receiver last woke
+   // up notifies it, so a burst of sends costs the receiver one wakeup and one batch.
+   class MessageChannel : public flair::events::EventDispatcher
+   {
+      friend class flair::allocator;
+      
+   protected:
+      MessageChannel(std::shared_ptr<Worker> receiver);
+      
+   public:
+      virtual ~MessageChannel();
+      
+   public:
+      // Either a JSON value or, when bytes is set, a ByteArray
+      struct Message
+      {
+         flair::JSON json;
+         std::shared_ptr<flair::utils::ByteArray> bytes;
+      };
+      
+   // Properties
+   public:
+      bool messageAvailable() const;
+      
+      MessageChannelState state() const;
+      
+      
+   // Methods
+   public:
+      // Returns false once the channel is closing
+      bool send(flair::JSON value);
+      
+      // Transfers the contents of bytes without copying them, bytes is left empty
+      bool send(std::shared_ptr<flair::utils::ByteArray> bytes);
+      
+      // Receiver only. Moves the oldest message into message, blocking until one arrives when
+      // asked to. Returns false if there was none, or the channel closed while blocking.
+      bool receive(Message & message, bool blockUntilReceived = false);
+      
+      // Stops further sends, the messages already sent can still be received
+      void close();
+      
+      
+   // Internal
+   protected:
+      bool push(Message && message);
+      
+      std::weak_ptr<Worker> _receiver;
+      std::atomic<MessageChannelState> _state;
+      flair::internal::utils::MPSCQueue<Message> * _messages;
+   };
+   
+}}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef flair_system_Worker_h
+#define flair_system_Worker_h
+
+#include "flair/flair.h"
+#include "flair/events/EventDispatcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace flair { namespace desktop { class NativeApplication; } }
+namespace flair { namespace internal { namespace services { class IWorkerService; } } }
+
+namespace flair {
+namespace system {
+   
+   class MessageChannel;
+   
+   enum class WorkerState
+   {
+      NEW,
+      RUNNING,
+      TERMINATED
+   };
+   
+   // A long lived background thread with its own message loop. The entry function runs once on
+   // the worker thread to set up listeners and state, afterwards the thread sleeps until one of
+   // its incoming channels has messages or one of its timers is due. Channel messages and timers
+   // are always dispatched on the receiving worker's thread. A started worker runs until it is
+   // terminated. The main thread is the primordial worker, its messages and timers are handled
+   // once per frame by the NativeApplication.
+   class Worker : public flair::events::EventDispatcher
+   {
+      friend class flair::allocator;
+      
+   protected:
+      Worker(std::function<void()> entry = nullptr);
+      
+   public:
+      virtual ~Worker();
+      
+   // Properties
+   public:
+      // The worker running the calling thread, threads not started by a Worker report the primordial worker
+      static std::shared_ptr<Worker> current();
+      
+      static bool isSupported();
+      
+      bool isPrimordial() const;
+      
+      WorkerState state() const;
+      
+      
+   // Methods
+   public:
+      // A channel from this worker to receiver, receiver dispatches CHANNEL_MESSAGE when it has messages
+      std::shared_ptr<MessageChannel> createMessageChannel(std::shared_ptr<Worker> receiver);
+      
+      void start();
+      
+      // Stops the message loop after the batch in progress and waits for the thread, returns false
+      // if the worker wasn't running. A worker can't terminate itself.
+      bool terminate();
+      
+      // Worker thread only. Calls callback on this worker after delay milliseconds, every delay
+      // milliseconds while repeat is set. Returns an id for clearTimer.
+      uint32_t setTimer(uint32_t delay, std::function<void()> callback, bool repeat = false);
+      void clearTimer(uint32_t id);
+      
+      // Runs body over [0, count) split into ranges on the worker threads and the calling thread,
+      // and returns once every range ran. A body that only writes its own indices gives the same
+      // result on any number of threads. A grain of 0 lets the pool pick the range size.
+      static void parallelFor(size_t count, std::function<void(size_t begin, size_t end)> body, size_t grain = 0);
+      
+      
+   // Internal
+   protected:
+      friend class MessageChannel;
+      void addChannel(std::shared_ptr<MessageChannel> channel);
+      void wake();
+      
+      // Blocks until woken or timeout, a negative timeout waits for the next wake
+      void wait(std::chrono::milliseconds timeout);
+      
+      friend class flair::desktop::NativeApplication;
+      static flair::internal::services::IWorkerService * workerService;
+      
+      // Dispatches CHANNEL_MESSAGE for every incoming channel holding messages and runs the due
+      // timers. Returns how long the loop may sleep, negative when there is no timer to wait for.
+      // Messages a listener leaves in its channel are offered again with the next wakeup.
+      std::chrono::milliseconds process();
+      
+      // How long until the next timer is due, negative when there is none
+      std::chrono::milliseconds nextTimer();
+      
+      // Called by every wake that would notify, for the primordial worker whose loop blocks in
+      // the window service instead of wait()
+      void wakeHandler(std::function<void()> handler);
+      
+      void loop();
+      
+   protected:
+      struct Timer
+      {
+         uint32_t id;
+         std::chrono::steady_clock::time_point due;
+         std::chrono::milliseconds interval;
+         bool repeat;
+         std::function<void()> callback;
+      };
+      
+      std::function<void()> _entry;
+      bool _primordial;
+      std::atomic<WorkerState> _state;
+      std::atomic<bool> _terminating;
+      std::thread _thread;
+      
+      // Wakeups are coalesced, only the first wake after the worker last woke up notifies
+      std::mutex _mutex;
+      std::condition_variable _condition;
+      std::atomic<bool> _signaled;
+      std::function<void()> _wakeHandler;
+      
+      // Incoming channels, added from the sending threads
+      std::mutex _channelsMutex;
+      std::vector<std::shared_ptr<MessageChannel>> _channels;
+      std::vector<std::shared_ptr<MessageChannel>> _pending;
+      
+      uint32_t _nextTimer;
+      std::vector<Timer> _timers;
+      std::vector<uint32_t> _dueTimers;
+   };
+   
+}}
+
+#endif
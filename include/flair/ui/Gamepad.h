@@ -0,0 +1,80 @@
+#ifndef flair_ui_Gamepad_h
+#define flair_ui_Gamepad_h
+
+#include <cstdint>
+
+namespace flair { namespace desktop { class NativeApplication; } }
+namespace flair { namespace internal { namespace services { class IGamepadService; } } }
+
+namespace flair {
+namespace ui {
+   
+   class Gamepad
+   {
+   public:
+      Gamepad() = delete;
+      Gamepad(Gamepad const&) = delete;
+      Gamepad& operator=(Gamepad const&) = delete;
+      
+      // Buttons
+      enum {
+         BUTTON_A,
+         BUTTON_B,
+         BUTTON_X,
+         BUTTON_Y,
+         BUTTON_BACK,
+         BUTTON_GUIDE,
+         BUTTON_START,
+         BUTTON_LEFT_STICK,
+         BUTTON_RIGHT_STICK,
+         BUTTON_LEFT_SHOULDER,
+         BUTTON_RIGHT_SHOULDER,
+         BUTTON_DPAD_UP,
+         BUTTON_DPAD_DOWN,
+         BUTTON_DPAD_LEFT,
+         BUTTON_DPAD_RIGHT,
+         
+         _BUTTON_COUNT // Internal for sizing the button mask
+      };
+      
+      // Axes, sticks range from -1 to 1 and triggers from 0 to 1
+      enum {
+         AXIS_LEFT_X,
+         AXIS_LEFT_Y,
+         AXIS_RIGHT_X,
+         AXIS_RIGHT_Y,
+         AXIS_TRIGGER_LEFT,
+         AXIS_TRIGGER_RIGHT,
+         
+         _AXIS_COUNT // Internal for sizing the axis array
+      };
+      
+      static const uint32_t MAX_DEVICES = 4;
+      
+   // Properties
+   public:
+      // Stick and trigger values below the dead zone read as 0, default 0.15
+      static float deadZone();
+      static float deadZone(float deadZone);
+      
+      // Polls the devices on a background thread so short presses between frames are not missed
+      static bool backgroundPolling();
+      static bool backgroundPolling(bool backgroundPolling);
+      
+   // Methods
+   public:
+      static bool connected(uint32_t device);
+      
+      static bool button(uint32_t device, uint32_t button);
+      
+      static float axis(uint32_t device, uint32_t axis);
+      
+   // Internal
+   protected:
+      friend class flair::desktop::NativeApplication;
+      static flair::internal::services::IGamepadService * gamepadService;
+   };
+   
+}}
+
+#endif
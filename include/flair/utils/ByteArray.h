@@ -8,6 +8,7 @@
 #include "flair/utils/Endian.h"
 
 namespace flair { namespace internal { namespace utils { class ByteArrayProxy; }}}
+namespace flair { namespace system { class MessageChannel; }}
 
 namespace flair {
 namespace utils {
@@ -114,6 +115,7 @@ namespace utils {
       Endian _endian;
       
       friend class flair::internal::utils::ByteArrayProxy;
+      friend class flair::system::MessageChannel;
       static const size_t BLOCK_SIZE = 1024;
       size_t _byteArrayLength;
       uint8_t * _byteArray;
@@ -0,0 +1,77 @@
+#ifndef flair_utils_Timer_h
+#define flair_utils_Timer_h
+
+#include "flair/flair.h"
+#include "flair/events/EventDispatcher.h"
+
+namespace flair { namespace desktop { class NativeApplication; } }
+namespace flair { namespace internal { namespace services { class ITimerService; } } }
+
+namespace flair {
+namespace utils {
+   
+   // Dispatches TimerEvent::TIMER every delay milliseconds of frame time, repeatCount times or
+   // until stopped when repeatCount is 0, followed by TimerEvent::TIMER_COMPLETE. Timers are
+   // checked once per frame, so a delay shorter than a frame fires once per frame.
+   class Timer : public flair::events::EventDispatcher
+   {
+      friend class flair::allocator;
+      
+   protected:
+      Timer(float delay, int repeatCount = 0);
+      
+   public:
+      virtual ~Timer();
+      
+   // Properties
+   public:
+      int currentCount() const;
+      
+      float delay() const;
+      float delay(float value);
+      
+      int repeatCount() const;
+      int repeatCount(int value);
+      
+      bool running() const;
+      
+      
+   // Methods
+   public:
+      void reset();
+      
+      void start();
+      
+      void stop();
+      
+      
+   // Internal
+   protected:
+      void onTimer();
+      
+      float _delay;
+      int _repeatCount;
+      int _currentCount;
+      uint32_t _id;
+      
+      friend class flair::desktop::NativeApplication;
+      friend uint32_t setTimeout(std::function<void()> closure, float delay);
+      friend uint32_t setInterval(std::function<void()> closure, float delay);
+      friend void clearTimeout(uint32_t id);
+      friend void clearInterval(uint32_t id);
+      static flair::internal::services::ITimerService * timerService;
+   };
+   
+   // Calls closure once after delay milliseconds of frame time, returns an id for clearTimeout
+   uint32_t setTimeout(std::function<void()> closure, float delay);
+   
+   // Calls closure every delay milliseconds of frame time until cleared
+   uint32_t setInterval(std::function<void()> closure, float delay);
+   
+   void clearTimeout(uint32_t id);
+   
+   void clearInterval(uint32_t id);
+   
+}}
+
+#endif
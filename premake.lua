@@ -30,6 +30,34 @@ newoption {
    }
 }
 
+newoption {
+   trigger     = "profile",
+   description = "Compile in the profiling zones, recorded when the application descriptor sets profile"
+}
+
+newoption {
+   trigger     = "log-level",
+   value       = "fine",
+   description = "Compile out the log messages below this level",
+   allowed = {
+      { "fine",    "Keep every message" },
+      { "info",    "Keep trace and up" },
+      { "warning", "Keep warnings and severe messages" },
+      { "severe",  "Keep severe messages only" },
+      { "none",    "Compile out all logging" }
+   }
+}
+
+newoption {
+   trigger     = "sanitize",
+   value       = "thread",
+   description = "Build with a sanitizer, for running the tests under it",
+   allowed = {
+      { "thread",  "ThreadSanitizer, checks the lock-free queues and the log rings for data races" },
+      { "address", "AddressSanitizer" }
+   }
+}
+
 if (not _OPTIONS["platform"]) then _OPTIONS["platform"] = "native" end
 if (not _OPTIONS["renderer"]) then _OPTIONS["renderer"] = "SDL" end
 if (not _OPTIONS["io"]) then _OPTIONS["io"] = "uv" end
@@ -61,6 +89,23 @@ solution "flair"
    -- Set our io
    defines { "FLAIR_IO_" .. string.upper(_OPTIONS["io"]); }
 
+   if _OPTIONS["profile"] then
+      defines { "FLAIR_PROFILE" }
+   end
+
+   -- Set the lowest log level compiled in
+   local logLevels = { fine = 0, info = 1, warning = 2, severe = 3, none = 4 }
+   if _OPTIONS["log-level"] then
+      defines { "FLAIR_LOG_LEVEL=" .. logLevels[_OPTIONS["log-level"]] }
+   end
+
+   if _OPTIONS["sanitize"] then
+      filter { "action:gmake*" }
+         buildoptions { "-fsanitize=" .. _OPTIONS["sanitize"] }
+         linkoptions { "-fsanitize=" .. _OPTIONS["sanitize"] }
+      filter { }
+   end
+
    filter { "action:xcode*" }
       xcodebuildsettings {
          ["CLANG_CXX_LANGUAGE_STANDARD"] = "c++11",
@@ -112,7 +157,7 @@ project "tests"
    language "C++"
    targetdir "bin/%{cfg.buildcfg}"
 
-   includedirs { "include", "vendor/googletest/include", "vendor/googletest/" }
+   includedirs { "include", "src", "vendor/googletest/include", "vendor/googletest/" }
 
    files { "tests/**.cc", "vendor/googletest/src/gtest_main.cc", "vendor/googletest/src/gtest-all.cc" }
 
@@ -155,3 +200,63 @@ project "reference"
    filter { "action:vs*" }
       links { "imm32", "oleaut32", "winmm", "version", "advapi32", "iphlpapi", "psapi", "shell32", "userenv", "ws2_32", "shlwapi" }
       postbuildcommands { "xcopy /E /S /Y \"$(ProjectDir)reference\\assets\" \"$(TargetDir)\"" }
+
+project "renderreplay"
+   kind "ConsoleApp"
+   language "C++"
+   targetdir "bin/%{cfg.buildcfg}"
+
+   includedirs { "include", "src" }
+
+   files { "tools/renderreplay/**.cc" }
+
+   links { "flair" }
+
+   filter { "action:xcode*" }
+      links {
+         "CoreVideo.framework",
+         "AudioToolbox.framework",
+         "AudioUnit.framework",
+         "Cocoa.framework",
+         "CoreAudio.framework",
+         "IOKit.framework",
+         "Carbon.framework",
+         "ForceFeedback.framework",
+         "CoreFoundation.framework"
+      }
+
+   filter { "action:gmake*" }
+      links { "dl", "m", "rt", "pthread" }
+
+   filter { "action:vs*" }
+      links { "imm32", "oleaut32", "winmm", "version", "advapi32", "iphlpapi", "psapi", "shell32", "userenv", "ws2_32", "shlwapi" }
+
+project "bench"
+   kind "ConsoleApp"
+   language "C++"
+   targetdir "bin/%{cfg.buildcfg}"
+
+   includedirs { "include", "src", "vendor/libuv/include" }
+
+   files { "tools/bench/**.h", "tools/bench/**.cc" }
+
+   links { "flair" }
+
+   filter { "action:xcode*" }
+      links {
+         "CoreVideo.framework",
+         "AudioToolbox.framework",
+         "AudioUnit.framework",
+         "Cocoa.framework",
+         "CoreAudio.framework",
+         "IOKit.framework",
+         "Carbon.framework",
+         "ForceFeedback.framework",
+         "CoreFoundation.framework"
+      }
+
+   filter { "action:gmake*" }
+      links { "dl", "m", "rt", "pthread" }
+
+   filter { "action:vs*" }
+      links { "imm32", "oleaut32", "winmm", "version", "advapi32", "iphlpapi", "psapi", "shell32", "userenv", "ws2_32", "shlwapi" }
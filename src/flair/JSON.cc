@@ -1,8 +1,17 @@
 #include "flair/JSON.h"
+#include "flair/utils/ByteArray.h"
+#include "flair/net/FileReference.h"
+#include "flair/events/Event.h"
+#include "flair/internal/services/IWorkerService.h"
+#include "flair/internal/utils/ByteArrayProxy.h"
 #include <cassert>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <algorithm>
 #include <limits>
+#include <map>
+#include <vector>
 
 #ifdef _MSC_VER
 	#define snprintf(str, size, format, ...) _snprintf_s(str, size, _TRUNCATE, format, __VA_ARGS__)
@@ -36,7 +45,6 @@ namespace flair {
       using std::string;
       using std::vector;
       using std::map;
-      using std::make_shared;
       using std::initializer_list;
       using std::move;
 
@@ -255,9 +263,9 @@ namespace flair {
    * Static globals - static-init-safe
    */
    struct Statics {
-      const std::shared_ptr<JSONValue> null = make_shared<JSONNull>();
-      const std::shared_ptr<JSONValue> t = make_shared<JSONBoolean>(true);
-      const std::shared_ptr<JSONValue> f = make_shared<JSONBoolean>(false);
+      const std::shared_ptr<JSONValue> null = std::make_shared<JSONNull>();
+      const std::shared_ptr<JSONValue> t = std::make_shared<JSONBoolean>(true);
+      const std::shared_ptr<JSONValue> f = std::make_shared<JSONBoolean>(false);
       const string empty_string;
       const vector<JSON> empty_vector;
       const map<string, JSON> empty_map;
@@ -283,16 +291,16 @@ namespace flair {
 
    JSON::JSON() JSON_NOEXCEPT : m_ptr(statics().null) {}
    JSON::JSON(std::nullptr_t) JSON_NOEXCEPT : m_ptr(statics().null) {}
-   JSON::JSON(double value) : m_ptr(make_shared<JSONDouble>(value)) {}
-   JSON::JSON(int value) : m_ptr(make_shared<JSONInt>(value)) {}
+   JSON::JSON(double value) : m_ptr(std::make_shared<JSONDouble>(value)) {}
+   JSON::JSON(int value) : m_ptr(std::make_shared<JSONInt>(value)) {}
    JSON::JSON(bool value) : m_ptr(value ? statics().t : statics().f) {}
-   JSON::JSON(const string &value) : m_ptr(make_shared<JSONString>(value)) {}
-   JSON::JSON(string &&value) : m_ptr(make_shared<JSONString>(move(value))) {}
-   JSON::JSON(const char * value) : m_ptr(make_shared<JSONString>(value)) {}
-   JSON::JSON(const JSON::Array &values) : m_ptr(make_shared<JSONArray>(values)) {}
-   JSON::JSON(JSON::Array &&values) : m_ptr(make_shared<JSONArray>(move(values))) {}
-   JSON::JSON(const JSON::Object &values) : m_ptr(make_shared<JSONObject>(values)) {}
-   JSON::JSON(JSON::Object &&values) : m_ptr(make_shared<JSONObject>(move(values))) {}
+   JSON::JSON(const string &value) : m_ptr(std::make_shared<JSONString>(value)) {}
+   JSON::JSON(string &&value) : m_ptr(std::make_shared<JSONString>(move(value))) {}
+   JSON::JSON(const char * value) : m_ptr(std::make_shared<JSONString>(value)) {}
+   JSON::JSON(const JSON::Array &values) : m_ptr(std::make_shared<JSONArray>(values)) {}
+   JSON::JSON(JSON::Array &&values) : m_ptr(std::make_shared<JSONArray>(move(values))) {}
+   JSON::JSON(const JSON::Object &values) : m_ptr(std::make_shared<JSONObject>(values)) {}
+   JSON::JSON(JSON::Object &&values) : m_ptr(std::make_shared<JSONObject>(move(values))) {}
 
    /* * * * * * * * * * * * * * * * * * * *
    * Accessors
@@ -384,11 +392,32 @@ namespace flair {
       {
          /* State
          */
-         const string &str;
+         const char * str;
+         size_t size;
          size_t i;
          string &err;
          bool failed;
 
+         /* at(pos)
+         *
+         * Return the character at pos, or 0 past the end of the input. The input is not
+         * required to be null terminated.
+         */
+         char at(size_t pos) const
+         {
+            return pos < size ? str[pos] : 0;
+         }
+
+         /* slice(pos, length)
+         *
+         * Copy up to length characters starting at pos, clamped to the end of the input.
+         */
+         string slice(size_t pos, size_t length) const
+         {
+            if (pos >= size) return string();
+            return string(str + pos, std::min(length, size - pos));
+         }
+
          /* fail(msg, err_ret = JSON())
          *
          * Mark this parse as failed.
@@ -412,7 +441,7 @@ namespace flair {
          * Advance until the current character is non-whitespace.
          */
          void consume_whitespace() {
-            while (str[i] == ' ' || str[i] == '\r' || str[i] == '\n' || str[i] == '\t')
+            while (at(i) == ' ' || at(i) == '\r' || at(i) == '\n' || at(i) == '\t')
                i++;
          }
 
@@ -424,7 +453,7 @@ namespace flair {
          char get_next_token()
          {
             consume_whitespace();
-            if (i == str.size())
+            if (i == size)
                return fail("unexpected end of input", 0);
 
             return str[i++];
@@ -468,7 +497,7 @@ namespace flair {
             string out;
             long last_escaped_codepoint = -1;
             while (true) {
-               if (i == str.size())
+               if (i == size)
                   return fail("unexpected end of input in string", "");
 
                char ch = str[i++];
@@ -490,17 +519,17 @@ namespace flair {
                }
 
                // Handle escapes
-               if (i == str.size())
+               if (i == size)
                   return fail("unexpected end of input in string", "");
 
                ch = str[i++];
 
                if (ch == 'u') {
                   // Extract 4-byte escape sequence
-                  string esc = str.substr(i, 4);
-                  for (int j = 0; j < 4; j++) {
-                     if (!in_range(esc[j], 'a', 'f') && !in_range(esc[j], 'A', 'F')
-                        && !in_range(esc[j], '0', '9'))
+                  string esc = slice(i, 4);
+                  for (size_t j = 0; j < 4; j++) {
+                     if (j >= esc.size() || (!in_range(esc[j], 'a', 'f') && !in_range(esc[j], 'A', 'F')
+                        && !in_range(esc[j], '0', '9')))
                         return fail("bad \\u escape: " + esc, "");
                   }
 
@@ -554,6 +583,16 @@ namespace flair {
             }
          }
 
+         /* number(start_pos)
+         *
+         * Copy the number ending at the current position so it can be handed to atoi/strtod
+         * without reading past the end of the input.
+         */
+         string number(size_t start_pos) const
+         {
+            return string(str + start_pos, i - start_pos);
+         }
+
          /* parse_number()
          *
          * Parse a double.
@@ -562,54 +601,54 @@ namespace flair {
          {
             size_t start_pos = i;
 
-            if (str[i] == '-')
+            if (at(i) == '-')
                i++;
 
             // Integer part
-            if (str[i] == '0') {
+            if (at(i) == '0') {
                i++;
-               if (in_range(str[i], '0', '9'))
+               if (in_range(at(i), '0', '9'))
                   return fail("leading 0s not permitted in numbers");
             }
-            else if (in_range(str[i], '1', '9')) {
+            else if (in_range(at(i), '1', '9')) {
                i++;
-               while (in_range(str[i], '0', '9'))
+               while (in_range(at(i), '0', '9'))
                   i++;
             }
             else {
-               return fail("invalid " + esc(str[i]) + " in number");
+               return fail("invalid " + esc(at(i)) + " in number");
             }
 
-            if (str[i] != '.' && str[i] != 'e' && str[i] != 'E'
+            if (at(i) != '.' && at(i) != 'e' && at(i) != 'E'
                && (i - start_pos) <= static_cast<size_t>(std::numeric_limits<int>::digits10)) {
-               return std::atoi(str.c_str() + start_pos);
+               return std::atoi(number(start_pos).c_str());
             }
 
             // Decimal part
-            if (str[i] == '.') {
+            if (at(i) == '.') {
                i++;
-               if (!in_range(str[i], '0', '9'))
+               if (!in_range(at(i), '0', '9'))
                   return fail("at least one digit required in fractional part");
 
-               while (in_range(str[i], '0', '9'))
+               while (in_range(at(i), '0', '9'))
                   i++;
             }
 
             // Exponent part
-            if (str[i] == 'e' || str[i] == 'E') {
+            if (at(i) == 'e' || at(i) == 'E') {
                i++;
 
-               if (str[i] == '+' || str[i] == '-')
+               if (at(i) == '+' || at(i) == '-')
                   i++;
 
-               if (!in_range(str[i], '0', '9'))
+               if (!in_range(at(i), '0', '9'))
                   return fail("at least one digit required in exponent");
 
-               while (in_range(str[i], '0', '9'))
+               while (in_range(at(i), '0', '9'))
                   i++;
             }
 
-            return std::strtod(str.c_str() + start_pos, nullptr);
+            return std::strtod(number(start_pos).c_str(), nullptr);
          }
 
          /* expect(str, res)
@@ -621,12 +660,12 @@ namespace flair {
          {
             assert(i != 0);
             i--;
-            if (str.compare(i, expected.length(), expected) == 0) {
+            if (size - i >= expected.length() && std::memcmp(str + i, expected.data(), expected.length()) == 0) {
                i += expected.length();
                return res;
             }
             else {
-               return fail("parse error: expected " + expected + ", got " + str.substr(i, expected.length()));
+               return fail("parse error: expected " + expected + ", got " + slice(i, expected.length()));
             }
          }
 
@@ -725,17 +764,135 @@ namespace flair {
 
    JSON JSON::parse(const string &in, string &err)
    {
-      JSONParser parser{ in, 0, err, false };
+      return parse(in.data(), in.size(), err);
+   }
+
+   JSON JSON::parse(const char * in, size_t length, string &err)
+   {
+      JSONParser parser{ in, length, 0, err, false };
       JSON result = parser.parse_JSON(0);
 
       // Check for any trailing garbage
       parser.consume_whitespace();
-      if (parser.i != in.size())
+      if (parser.i != length)
          return parser.fail("unexpected trailing " + esc(in[parser.i]));
 
       return result;
    }
 
+   /* * * * * * * * * * * * * * * * * * * *
+   * Async parsing
+   */
+
+   flair::internal::services::IWorkerService * JSON::workerService = nullptr;
+
+   void JSON::parseAsync(std::shared_ptr<utils::ByteArray> bytes, ParseCallback callback)
+   {
+      using namespace flair::internal::services;
+
+      struct JSONWorkerResult : IAsyncWorkerRequest::IWorkerResult
+      {
+         JSON result;
+         string err;
+      };
+
+      auto parseBytes = [bytes]() -> std::shared_ptr<IAsyncWorkerRequest::IWorkerResult> {
+         // Parse the backing store in place, the bytes are never copied into a string
+         flair::internal::utils::ByteArrayProxy proxy(bytes);
+         auto parsed = std::make_shared<JSONWorkerResult>();
+         parsed->result = parse(reinterpret_cast<const char *>(proxy.bytes()), proxy.length(), parsed->err);
+         return parsed;
+      };
+
+      // Without a worker service (tests, headless tools) parse on the calling thread
+      if (!workerService) {
+         auto parsed = std::static_pointer_cast<JSONWorkerResult>(parseBytes());
+         callback(parsed->result, parsed->err);
+         return;
+      }
+
+      workerService->execute(parseBytes, [callback](std::shared_ptr<IAsyncWorkerRequest> request) {
+         auto parsed = std::static_pointer_cast<JSONWorkerResult>(request->result());
+         if (request->error() != 0 || !parsed) {
+            callback(JSON(), "worker error");
+            return;
+         }
+
+         callback(parsed->result, parsed->err);
+      });
+   }
+
+   namespace {
+      typedef std::vector<JSON::ParseCallback> ParseCallbacks;
+
+      // Parses waiting for a file to load. Listeners are told apart by their type only, so a
+      // file gets one pair of listeners however many parses wait on it.
+      std::map<net::FileReference *, std::weak_ptr<ParseCallbacks>> & loadingFiles()
+      {
+         static std::map<net::FileReference *, std::weak_ptr<ParseCallbacks>> files;
+         return files;
+      }
+
+      // Listens for both the end and the failure of a load and removes both listeners with the
+      // first. Holds the file weakly, the file holds the listener.
+      struct FileParse
+      {
+         std::weak_ptr<net::FileReference> file;
+         std::shared_ptr<ParseCallbacks> callbacks;
+
+         void operator()(std::shared_ptr<events::Event> event)
+         {
+            auto loaded = file.lock();
+            if (!loaded) return;
+
+            auto & files = loadingFiles();
+            auto entry = files.find(loaded.get());
+            if (entry != files.end() && entry->second.lock() == callbacks) files.erase(entry);
+
+            // Whatever the listener is built from, removal only looks at its type
+            loaded->removeEventListener(events::Event::COMPLETE, FileParse());
+            loaded->removeEventListener(events::Event::ERROR, FileParse());
+
+            auto waiting = callbacks;
+            if (event->type() != string(events::Event::COMPLETE)) {
+               for (auto const& callback : *waiting) callback(JSON(), "unable to load " + loaded->name());
+               return;
+            }
+
+            JSON::parseAsync(loaded->data(), [waiting](JSON result, const std::string & err) {
+               for (auto const& callback : *waiting) callback(result, err);
+            });
+         }
+      };
+   }
+
+   void JSON::parseAsync(std::shared_ptr<net::FileReference> file, ParseCallback callback)
+   {
+      using flair::events::Event;
+
+      // A file being loaded already has its data, just not all of it
+      auto & entry = loadingFiles()[file.get()];
+      if (auto waiting = entry.lock()) {
+         waiting->push_back(callback);
+         return;
+      }
+
+      auto data = file->data();
+      if (data) {
+         loadingFiles().erase(file.get());
+         parseAsync(data, callback);
+         return;
+      }
+
+      auto waiting = std::make_shared<ParseCallbacks>(1, callback);
+      entry = waiting;
+
+      file->addEventListener(Event::ERROR, FileParse{ file, waiting }, false, 0, true);
+      file->addEventListener(Event::COMPLETE, FileParse{ file, waiting }, false, 0, true);
+
+      file->load();
+   }
+
    /* * * * * * * * * * * * * * * * * * * *
    * Shape-checking
    */
@@ -1,15 +1,16 @@
 #include "flair/Object.h"
+#include "flair/system/Memory.h"
 
 namespace flair {
    
-   Object::Object()
+   Object::Object() : _memoryCounter(nullptr)
    {
       _shared = std::shared_ptr<Object>(this);
    }
 
    Object::~Object()
    {
-      
+      if (_memoryCounter) _memoryCounter->release();
    }
    
    std::string Object::toString() const
@@ -1,12 +1,18 @@
 #include "flair/desktop/NativeApplication.h"
 #include "flair/ui/Keyboard.h"
+#include "flair/ui/Gamepad.h"
 #include "flair/events/Event.h"
 #include "flair/events/KeyboardEvent.h"
 #include "flair/events/MouseEvent.h"
+#include "flair/events/GamepadEvent.h"
+#include "flair/events/TouchEvent.h"
 #include "flair/net/FileReference.h"
 #include "flair/net/URLRequest.h"
 #include "flair/display/BitmapData.h"
+#include "flair/display/PerformanceOverlay.h"
 #include "flair/system/LoaderContext.h"
+#include "flair/system/Worker.h"
+#include "flair/utils/Timer.h"
 #include "flair/display/RenderSupport.h"
 #include "flair/internal/services/IWindowService.h"
 #include "flair/internal/services/IRenderService.h"
@@ -17,12 +23,20 @@
 #include "flair/internal/services/IAsyncIOService.h"
 #include "flair/internal/services/IFileService.h"
 #include "flair/internal/services/IPlatformService.h"
+#include "flair/internal/services/base/TimerService.h"
+#include "flair/internal/input/InputLog.h"
+#include "flair/internal/utils/MPSCQueue.h"
+#include "flair/internal/utils/Profiler.h"
+#include "flair/internal/services/capture/RenderService.h"
+#include "flair/utils/ByteArray.h"
 
 #ifdef FLAIR_PLATFORM_SDL
 #include "flair/internal/services/sdl/WindowService.h"
 #include "flair/internal/services/sdl/RenderService.h"
 #include "flair/internal/services/sdl/KeyboardService.h"
 #include "flair/internal/services/sdl/MouseService.h"
+#include "flair/internal/services/sdl/GamepadService.h"
+#include "flair/internal/services/sdl/TouchService.h"
 #endif
 
 #ifdef FLAIR_IO_UV
@@ -39,7 +53,19 @@
 #include "flair/internal/services/windows/PlatformService.h"
 #endif
 
+#include <algorithm>
 #include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+   // Milliseconds between the frames of a hidden window. One that executes in the background
+   // keeps its frame rate, otherwise it only runs slow frames while it animates or is kept awake.
+   const int BACKGROUND_EXECUTION_INTERVAL = 16;
+   const int HIDDEN_KEEP_AWAKE_INTERVAL = 250;
+}
 
 namespace flair {
 namespace desktop {
@@ -49,7 +75,7 @@ namespace desktop {
    using namespace flair::display;
    using namespace flair::events;
    
-   NativeApplication::NativeApplication(flair::JSON applicationDescriptor, std::shared_ptr<flair::display::Stage> stage) : _applicationDescriptor(applicationDescriptor), _stage(stage), _autoExit(true), _executeInBackground(false), _idleThreshold(300), _systemIdleMode(SystemIdleMode::NORMAL), _running(false)
+   NativeApplication::NativeApplication(flair::JSON applicationDescriptor, std::shared_ptr<flair::display::Stage> stage) : _applicationDescriptor(applicationDescriptor), _stage(stage), _autoExit(true), _executeInBackground(false), _idleThreshold(300), _systemIdleMode(SystemIdleMode::NORMAL), _running(false), _frameStats(), _recording(nullptr), _replaying(nullptr), _headless(false), _lastUserInput(0), _userIdle(false), _postedEvents(new flair::internal::utils::MPSCQueue<PostedEvent>())
    {
       windowService = nullptr;
       renderService = nullptr;
@@ -61,23 +87,54 @@ namespace desktop {
       asyncIOService = nullptr;
       fileService = nullptr;
       workerService = nullptr;
+      renderCapture = nullptr;
+      
+      _startupTime = std::chrono::steady_clock::now();
+      _startupStats.timeToFirstFrame = 0.0f;
+      
+      // Optionally record a profile from here on, zones only exist in builds with FLAIR_PROFILE
+      JSON profileOptions = _applicationDescriptor["profile"];
+      profileFrames = 0;
+      if (profileOptions.isObject() && profileOptions["path"].isString()) {
+         profilePath = profileOptions["path"].string_value();
+         profileFrames = profileOptions["frames"].isNumber() ? profileOptions["frames"].int_value() : 0;
+         flair::internal::utils::Profiler::start();
+      }
+      
+      if (_applicationDescriptor["performanceOverlay"].bool_value()) performanceOverlay(true);
+      FLAIR_PROFILE_ZONE("NativeApplication::NativeApplication");
+      
+      // The services that don't touch the platform come up on another thread, SDL and the
+      // platform services want the main thread
+      StartupPhase ioPhase;
+      std::thread ioStartup([this, &ioPhase]() {
+         FLAIR_PROFILE_ZONE("io services");
+         auto begin = std::chrono::steady_clock::now();
+         timerService = new base::TimerService();
+         
+#ifdef FLAIR_IO_UV
+         asyncIOService = new uv::AsyncIOService();
+         fileService = new uv::FileService();
+         workerService = new uv::WorkerService();
+#endif
+         
+         ioPhase = startupPhase("io services", begin, 1);
+      });
+      
+      auto begin = std::chrono::steady_clock::now();
       
 #ifdef FLAIR_PLATFORM_SDL
       windowService = new sdl::WindowService();
       keyboardService = new sdl::KeyboardService();
       mouseService = new sdl::MouseService();
+      touchService = new sdl::TouchService();
+      gamepadService = new sdl::GamepadService();
 #endif
       
 #ifdef FLAIR_RENDERER_SDL
       renderService = new sdl::RenderService();
 #endif
       
-#ifdef FLAIR_IO_UV
-      asyncIOService = new uv::AsyncIOService();
-      fileService = new uv::FileService();
-      workerService = new uv::WorkerService();
-#endif
-      
 #ifdef FLAIR_PLATFORM_MAC
       platformService = new mac::PlatformService();
 #endif
@@ -87,38 +144,83 @@ namespace desktop {
       #undef DOUBLE_CLICK // Win32 define conflict
 #endif
       
+      _startupStats.phases.push_back(startupPhase("platform services", begin));
+      ioStartup.join();
+      _startupStats.phases.push_back(ioPhase);
+      
+      // Optionally record the render calls of the first frames, see tools/renderreplay
+      JSON captureOptions = _applicationDescriptor["renderCapture"];
+      if (captureOptions.isObject() && captureOptions["path"].isString()) {
+         uint32_t frames = captureOptions["frames"].isNumber() ? captureOptions["frames"].int_value() : 60;
+         renderCapture = new capture::RenderService(renderService, flair::make_shared<flair::utils::ByteArray>(), frames);
+         renderCapturePath = captureOptions["path"].string_value();
+         renderService = renderCapture;
+      }
+      
       // Setup dependency services
       fileService->init(asyncIOService);
       workerService->init(asyncIOService);
+      asyncIOService->notify([this]() { windowService->wake(); });
       
       // Inject services into the public api
       ui::Keyboard::keyboardService = keyboardService;
+      ui::Gamepad::gamepadService = gamepadService;
       net::FileReference::fileService = fileService;
       net::FileReference::platformService = platformService;
       net::URLRequest::platformService = platformService;
       display::BitmapData::renderService = renderService;
       display::RenderSupport::renderService = renderService;
       system::LoaderContext::workerService = workerService;
+      system::Worker::workerService = workerService;
+      JSON::workerService = workerService;
+      flair::utils::Timer::timerService = timerService;
    }
    
    NativeApplication::~NativeApplication()
    {
+      // A session that ended before the requested frames were captured still leaves a capture
+      if (renderCapture) {
+         renderCapture->finish();
+         writeRenderCapture();
+      }
+      
+      // The display list goes while the services its objects use are still there, timers and
+      // bitmaps held elsewhere find no service after this
+      _stage.reset();
+      flair::utils::Timer::timerService = nullptr;
+      
+      delete _recording;
+      delete _replaying;
+      delete _postedEvents;
+      delete static_cast<base::TimerService*>(timerService);
+      
+      // The I/O thread wakes the window, so it stops before the window goes
+      asyncIOService->notify(nullptr);
+      
+#ifdef FLAIR_IO_UV
+      delete static_cast<uv::AsyncIOService*>(asyncIOService);
+      delete static_cast<uv::FileService*>(fileService);
+      delete static_cast<uv::WorkerService*>(workerService);
+#endif
+      
 #ifdef FLAIR_PLATFORM_SDL
       delete static_cast<sdl::WindowService*>(windowService);
+      windowService = nullptr;
       delete static_cast<sdl::KeyboardService*>(keyboardService);
       delete static_cast<sdl::MouseService*>(mouseService);
+      delete static_cast<sdl::TouchService*>(touchService);
+      delete static_cast<sdl::GamepadService*>(gamepadService);
 #endif
       
+      if (renderCapture) {
+         renderService = renderCapture->target();
+         delete renderCapture;
+      }
+      
 #ifdef FLAIR_RENDERER_SDL
       delete static_cast<sdl::RenderService*>(renderService);
 #endif
       
-#ifdef FLAIR_IO_UV
-      delete static_cast<uv::AsyncIOService*>(asyncIOService);
-      delete static_cast<uv::FileService*>(fileService);
-      delete static_cast<uv::WorkerService*>(workerService);
-#endif
-      
 #ifdef FLAIR_PLATFORM_MAC
       delete static_cast<mac::PlatformService*>(platformService);
 #endif
@@ -204,8 +306,38 @@ namespace desktop {
    
    int NativeApplication::timeSinceLastUserInput()
    {
-      // TODO: Return time since last update in seconds
-      return 0;
+      if (!_running) return 0;
+      return (windowService->ticks() - _lastUserInput) / 1000;
+   }
+   
+   const FrameStats & NativeApplication::frameStats() const
+   {
+      return _frameStats;
+   }
+   
+   bool NativeApplication::performanceOverlay()
+   {
+      return _performanceOverlay != nullptr;
+   }
+   
+   bool NativeApplication::performanceOverlay(bool value)
+   {
+      if (value && !_performanceOverlay) _performanceOverlay = flair::make_shared<PerformanceOverlay>();
+      if (!value) _performanceOverlay = nullptr;
+      return value;
+   }
+   
+   const StartupStats & NativeApplication::startupStats() const
+   {
+      return _startupStats;
+   }
+   
+   flair::system::IOStats NativeApplication::ioStats()
+   {
+      flair::system::IOStats stats;
+      asyncIOService->stats(stats);
+      workerService->stats(stats);
+      return stats;
    }
    
    void NativeApplication::activate(int * window)
@@ -243,6 +375,147 @@ namespace desktop {
       // TODO: Send selectAll command to active element
    }
    
+   void NativeApplication::startRecording(std::shared_ptr<flair::utils::ByteArray> log)
+   {
+      delete _recording;
+      _recording = new input::InputLog(log);
+      _recording->begin();
+   }
+   
+   void NativeApplication::stopRecording()
+   {
+      delete _recording;
+      _recording = nullptr;
+   }
+   
+   void NativeApplication::resetIOStats()
+   {
+      asyncIOService->resetStats();
+      workerService->resetStats();
+   }
+   
+   void NativeApplication::replay(std::shared_ptr<flair::utils::ByteArray> log, bool headless)
+   {
+      if (_running) throw std::logic_error("A replay has to be set up before run()");
+      
+      delete _replaying;
+      _replaying = new input::InputLog(log);
+      if (!_replaying->open()) {
+         delete _replaying;
+         _replaying = nullptr;
+         throw std::invalid_argument("Not an input log");
+      }
+      _headless = headless;
+   }
+   
+   void NativeApplication::postEvent(std::shared_ptr<IEventDispatcher> target, std::shared_ptr<Event> event)
+   {
+      // Only the first event of a batch has to wake the loop, and nothing is left to wake once the
+      // window is gone
+      if (_postedEvents->push(PostedEvent(target, event)) && windowService) windowService->wake();
+   }
+   
+   void NativeApplication::dispatchPostedEvents()
+   {
+      FLAIR_PROFILE_ZONE("NativeApplication::dispatchPostedEvents");
+      _postedEvents->drain([this](PostedEvent & posted) {
+         if (posted.first) {
+            posted.first->dispatchEvent(posted.second);
+         }
+         else {
+            _stage->dispatchEvent(posted.second);
+         }
+      });
+   }
+   
+   StartupPhase NativeApplication::startupPhase(const char * name, std::chrono::steady_clock::time_point begin, uint32_t thread) const
+   {
+      typedef std::chrono::duration<float, std::milli> milliseconds;
+      
+      StartupPhase phase;
+      phase.name = name;
+      phase.begin = std::chrono::duration_cast<milliseconds>(begin - _startupTime).count();
+      phase.end = std::chrono::duration_cast<milliseconds>(std::chrono::steady_clock::now() - _startupTime).count();
+      phase.thread = thread;
+      return phase;
+   }
+   
+   void NativeApplication::writeRenderCapture()
+   {
+      if (renderCapturePath.empty()) return;
+      
+      auto bytes = renderCapture->capture();
+      std::ofstream file(renderCapturePath, std::ios::binary);
+      bytes->position(0);
+      std::vector<uint8_t> contents(bytes->length());
+      bytes->readBytes(contents.data(), 0, contents.size());
+      file.write((const char *)contents.data(), contents.size());
+      renderCapturePath.clear();
+   }
+   
+   void NativeApplication::writeStartupTrace(std::string const& path) const
+   {
+      // Complete events of the trace event format, timestamps in microseconds
+      JSON::Array events;
+      for (auto const& phase : _startupStats.phases) {
+         events.push_back(JSON::Object {
+            { "name", phase.name },
+            { "cat", "startup" },
+            { "ph", "X" },
+            { "ts", phase.begin * 1000.0 },
+            { "dur", (phase.end - phase.begin) * 1000.0 },
+            { "pid", 1 },
+            { "tid", (int)phase.thread }
+         });
+      }
+      
+      std::ofstream file(path);
+      file << JSON(JSON::Object { { "traceEvents", events } }).stringify();
+   }
+   
+   int NativeApplication::idleTimeout()
+   {
+      // A frame asked for during this one only counts for the next
+      bool requested = _stage->_frameRequested;
+      _stage->_frameRequested = false;
+      
+      // Replays and headless runs go as fast as they can
+      if (_headless || _replaying) return 0;
+      
+      // An event posted while the last drain ran found the queue not empty and didn't wake the
+      // loop, it is dispatched next frame instead. Posts after this check do wake it.
+      if (_postedEvents->size_approx() > 0) return 0;
+      
+      // Tick overrides animate without telling anyone, so a visible window only sleeps when the
+      // application asks for its frames. Otherwise only an event, a timer or a message can change
+      // anything, and all of them end the wait.
+      bool visible = windowService->visible();
+      bool animating = requested || _stage->hasEventListener(Event::ENTER_FRAME);
+      
+      int timeout = 0;
+      if (visible) {
+         if (!animating && _systemIdleMode == SystemIdleMode::ON_DEMAND) timeout = -1;
+      }
+      else if (_executeInBackground) {
+         timeout = BACKGROUND_EXECUTION_INTERVAL;
+      }
+      else {
+         timeout = animating || _systemIdleMode == SystemIdleMode::KEEP_AWAKE ? HIDDEN_KEEP_AWAKE_INTERVAL : -1;
+      }
+      if (timeout == 0) return 0;
+      
+      // Wake up in time for whatever comes due first
+      auto until = [&timeout](int64_t due) {
+         if (due >= 0 && (timeout < 0 || due < timeout)) timeout = static_cast<int>(due);
+      };
+      until(timerService->next());
+      until(flair::system::Worker::current()->nextTimer().count());
+      if (!_userIdle && _idleThreshold > 0 && _stage->hasEventListener(Event::USER_IDLE)) {
+         until(std::max<int64_t>(0, int64_t(_idleThreshold) * 1000 - (windowService->ticks() - _lastUserInput)));
+      }
+      return timeout;
+   }
+   
    void NativeApplication::run()
    {
       if (_running) return;
@@ -271,48 +544,94 @@ namespace desktop {
       
       auto renderSupport = new RenderSupport();
       
-      windowService->create(title, geom::Rectangle(x, y, width, height), flags, true);
-      renderService->create(windowService, vsync);
-      
-      windowService->activate();
+      if (!_headless) {
+         auto begin = std::chrono::steady_clock::now();
+         windowService->create(title, geom::Rectangle(x, y, width, height), flags, true);
+         _startupStats.phases.push_back(startupPhase("window", begin));
+         
+         begin = std::chrono::steady_clock::now();
+         renderService->create(windowService, vsync);
+         _startupStats.phases.push_back(startupPhase("renderer", begin));
+         
+         windowService->activate();
+      }
       _stage->_stageWidth = width;
       _stage->_stageHeight = height;
+      
+      auto activateBegin = std::chrono::steady_clock::now();
       _stage->dispatchEvent(flair::make_shared<Event>(Event::ACTIVATE, false, false));
+      _startupStats.phases.push_back(startupPhase("activate", activateBegin));
+      
+      // Event timestamps dispatched this frame, measured against the present
+      std::vector<uint32_t> inputTimestamps;
+      inputTimestamps.reserve(64);
+      
+      // Touch batches reuse their events and hit test storage, a pooled event is only replaced
+      // when a listener kept a reference to it
+      std::vector<std::shared_ptr<TouchEvent>> touchEvents(ITouchService::MAX_CHANGED_POINTS);
+      std::vector<geom::Point> touchLocations(ITouchService::MAX_CHANGED_POINTS);
+      std::vector<std::shared_ptr<DisplayObject>> touchTargets(ITouchService::MAX_CHANGED_POINTS);
+      
+      // Messages and timers of the main thread's worker are handled once per frame, a message
+      // arriving while the loop is idle wakes it up
+      auto primordialWorker = flair::system::Worker::current();
+      FLAIR_PROFILE_THREAD("main");
+      primordialWorker->wakeHandler([this]() { windowService->wake(); });
+      
+      _lastUserInput = windowService->ticks();
+      
+      // Gamepads are opened on first use, SDL only looks for devices from then on
+      bool gamepadOpen = false;
       
       auto previousTime = std::chrono::high_resolution_clock::now();
+      double timerTime = static_cast<double>(timerService->now());
+      auto firstFrameBegin = std::chrono::steady_clock::now();
       while (!windowService->quiting()) {
+         FLAIR_PROFILE_ZONE("frame");
+         inputTimestamps.clear();
          asyncIOService->poll();
-         windowService->poll(gamepadService, touchService, mouseService, keyboardService);
+         dispatchPostedEvents();
+         primordialWorker->process();
+         
+         float replayDelta = 0.0f;
+         if (_replaying) {
+            // Only pump the window, the input comes from the log
+            windowService->poll(nullptr, nullptr, nullptr, nullptr);
+            if (!_replaying->replay(&replayDelta, keyboardService, mouseService, gamepadService, touchService)) break;
+         }
+         else {
+            windowService->poll(gamepadService, touchService, mouseService, keyboardService);
+         }
          
          // Dispatch keyboard events
          {
-            int shift = 0, alt = 0, ctrl = 0, os = 0;
-            keyboardService->modifiers(&shift, &alt, &ctrl, &os);
-            keyboardService->activeKeys([&](uint32_t keyCode, int keyState) {
-               _stage->dispatchEvent(flair::make_shared<KeyboardEvent>(keyState < 0 ? KeyboardEvent::KEY_DOWN : KeyboardEvent::KEY_UP, true, false, keyCode, keyCode, 0, ctrl != 0, alt != 0, shift != 0, ctrl !=0 || os != 0, os != 0));
+            FLAIR_PROFILE_ZONE("keyboard events");
+            keyboardService->transitions([&](const IKeyboardService::KeyTransition & key) {
+               inputTimestamps.push_back(key.timestamp);
+               _stage->dispatchEvent(flair::make_shared<KeyboardEvent>(key.state < 0 ? KeyboardEvent::KEY_DOWN : KeyboardEvent::KEY_UP, true, false, key.keyCode, key.keyCode, 0, key.ctrl != 0, key.alt != 0, key.shift != 0, key.ctrl != 0 || key.os != 0, key.os != 0));
             });
          }
          
          // Dispatch mouse events
          {
+            FLAIR_PROFILE_ZONE("mouse events");
             int shift = 0, alt = 0, ctrl = 0, os = 0;
             bool primaryButtonDown = false;
             keyboardService->modifiers(&shift, &alt, &ctrl, &os);
-            mouseService->buttonStates([&](uint32_t buttonCode, int currentState, int prevState) {
+            
+            int movementX, movementY;
+            mouseService->movement(&movementX, &movementY);
+            
+            mouseService->buttonTransitions([&](const IMouseService::ButtonTransition & button) {
                const char * mouseEventType = nullptr;
-               
-               int localX, localY, movementX, movementY;
-               mouseService->location(&localX, &localY);
-               mouseService->movement(&movementX, &movementY);
-               
+               inputTimestamps.push_back(button.timestamp);
                
                // Button Up / Down Events
-               mouseEventType = nullptr;
-               if (currentState < 0) {
-                  if (buttonCode == IMouseService::MIDDLE_BUTTON) {
+               if (button.state < 0) {
+                  if (button.buttonCode == IMouseService::MIDDLE_BUTTON) {
                      mouseEventType = MouseEvent::MIDDLE_MOUSE_DOWN;
                   }
-                  else if (buttonCode == IMouseService::RIGHT_BUTTON) {
+                  else if (button.buttonCode == IMouseService::RIGHT_BUTTON) {
                      mouseEventType = MouseEvent::RIGHT_MOUSE_DOWN;
                   }
                   else {
@@ -320,59 +639,237 @@ namespace desktop {
                      primaryButtonDown = true;
                   }
                }
-               else if (currentState > 0) {
-                  if (buttonCode == IMouseService::MIDDLE_BUTTON) {
+               else if (button.state > 0) {
+                  if (button.buttonCode == IMouseService::MIDDLE_BUTTON) {
                      mouseEventType = MouseEvent::MIDDLE_MOUSE_UP;
                   }
-                  else if (buttonCode == IMouseService::RIGHT_BUTTON) {
+                  else if (button.buttonCode == IMouseService::RIGHT_BUTTON) {
                      mouseEventType = MouseEvent::RIGHT_MOUSE_UP;
                   }
                   else {
                      mouseEventType = MouseEvent::MOUSE_UP;
+                     primaryButtonDown = false;
                   }
                }
                
                if (mouseEventType) {
-                  _stage->dispatchEvent(flair::make_shared<MouseEvent>(mouseEventType, true, false, (float)localX, (float)localY, (float)movementX, (float)movementY, nullptr, primaryButtonDown, 0, std::abs(currentState), ctrl != 0, alt != 0, shift != 0, ctrl !=0 || os != 0, os != 0));
+                  _stage->dispatchEvent(flair::make_shared<MouseEvent>(mouseEventType, true, false, (float)button.X, (float)button.Y, (float)movementX, (float)movementY, nullptr, primaryButtonDown, 0, std::abs(button.state), ctrl != 0, alt != 0, shift != 0, ctrl !=0 || os != 0, os != 0));
                }
                
                
                // Click / Double Click Events
                mouseEventType = nullptr;
-               if (prevState >= 0 && currentState < 0) {
-                  if (buttonCode == IMouseService::MIDDLE_BUTTON) {
+               if (button.previousState >= 0 && button.state < 0) {
+                  if (button.buttonCode == IMouseService::MIDDLE_BUTTON) {
                      mouseEventType = MouseEvent::MIDDLE_CLICK;
                   }
-                  else if (buttonCode == IMouseService::RIGHT_BUTTON) {
+                  else if (button.buttonCode == IMouseService::RIGHT_BUTTON) {
                      mouseEventType = MouseEvent::RIGHT_CLICK;
                   }
                   else {
-                     mouseEventType = (currentState == -2 ? MouseEvent::DOUBLE_CLICK : MouseEvent::CLICK);
+                     mouseEventType = (button.state == -2 ? MouseEvent::DOUBLE_CLICK : MouseEvent::CLICK);
                   }
                }
                
                if (mouseEventType) {
-                  _stage->dispatchEvent(flair::make_shared<MouseEvent>(mouseEventType, true, false, (float)localX, (float)localY, (float)movementX, (float)movementY, nullptr, primaryButtonDown, 0, std::abs(currentState), ctrl != 0, alt != 0, shift != 0, ctrl !=0 || os != 0, os != 0));
+                  _stage->dispatchEvent(flair::make_shared<MouseEvent>(mouseEventType, true, false, (float)button.X, (float)button.Y, (float)movementX, (float)movementY, nullptr, primaryButtonDown, 0, std::abs(button.state), ctrl != 0, alt != 0, shift != 0, ctrl !=0 || os != 0, os != 0));
                }
+            });
+            
+            // Movement Events, coalesced into one per frame with the samples attached for the dispatch
+            MouseEvent::Sample const* samples = nullptr;
+            size_t sampleCount = 0;
+            mouseService->history(&samples, &sampleCount);
+            
+            if (sampleCount > 0 || movementX != 0 || movementY != 0) {
+               int localX, localY;
+               mouseService->location(&localX, &localY);
+               
+               auto moveEvent = flair::make_shared<MouseEvent>(MouseEvent::MOUSE_MOVE, true, false, (float)localX, (float)localY, (float)movementX, (float)movementY, nullptr, primaryButtonDown, 0, 0, ctrl != 0, alt != 0, shift != 0, ctrl !=0 || os != 0, os != 0);
+               moveEvent->history(samples, sampleCount);
+               _stage->dispatchEvent(moveEvent);
+               moveEvent->history(nullptr, 0);
                
+               if (sampleCount > 0) {
+                  inputTimestamps.push_back(samples[sampleCount - 1].timestamp);
+               }
+            }
+         }
+         
+         // Dispatch touch events, every point of the batch is resolved with one hit test pass first
+         {
+            FLAIR_PROFILE_ZONE("touch events");
+            TouchPoint const* points = nullptr;
+            size_t pointCount = 0;
+            touchService->points(&points, &pointCount);
+            
+            if (pointCount > 0) {
+               for (size_t i = 0; i < pointCount; ++i) {
+                  touchLocations[i].setTo(points[i].X, points[i].Y);
+               }
+               _stage->hitTestPoints(touchLocations.data(), pointCount, touchTargets.data());
                
-               // Movement Events
-               if (movementX != 0 || movementY != 0) {
-                  _stage->dispatchEvent(flair::make_shared<MouseEvent>(MouseEvent::MOUSE_MOVE, true, false, (float)localX, (float)localY, (float)movementX, (float)movementY, nullptr, primaryButtonDown, 0, std::abs(currentState), ctrl != 0, alt != 0, shift != 0, ctrl !=0 || os != 0, os != 0));
+               for (size_t i = 0; i < pointCount; ++i) {
+                  const TouchPoint & point = points[i];
+                  auto & target = touchTargets[i];
+                  
+                  const char * touchEventType = point.phase == TouchPoint::BEGIN ? TouchEvent::TOUCH_BEGIN : point.phase == TouchPoint::END ? TouchEvent::TOUCH_END : TouchEvent::TOUCH_MOVE;
+                  
+                  geom::Point local = touchLocations[i];
+                  if (target) {
+                     geom::Matrix toLocal = target->getTransformationMatrix(nullptr);
+                     toLocal.invert();
+                     local = toLocal.transformPoint(local);
+                  }
+                  
+                  auto & touchEvent = touchEvents[i];
+                  if (!touchEvent || touchEvent.use_count() > 1) touchEvent = flair::make_shared<TouchEvent>(touchEventType);
+                  touchEvent->reset(touchEventType, target ? std::static_pointer_cast<Object>(target) : std::static_pointer_cast<Object>(_stage), point.touchId, point.primary, local.x(), local.y(), point.X, point.Y, point.pressure, i, pointCount);
+                  
+                  inputTimestamps.push_back(point.timestamp);
+                  if (target) target->dispatchEvent(touchEvent);
+                  _stage->dispatchEvent(touchEvent);
+                  target.reset();
+               }
+            }
+         }
+         
+         // Open the gamepads once someone listens
+         if (!gamepadOpen && _stage->_gamepadListened) {
+            gamepadService->open();
+            gamepadOpen = true;
+         }
+         
+         // Dispatch gamepad events, only the diffed transitions allocate
+         {
+            FLAIR_PROFILE_ZONE("gamepad events");
+            gamepadService->transitions([&](const GamepadTransition & transition) {
+               const char * gamepadEventType = nullptr;
+               switch (transition.type) {
+                  case GamepadTransition::CONNECTED: gamepadEventType = GamepadEvent::DEVICE_ADDED; break;
+                  case GamepadTransition::DISCONNECTED: gamepadEventType = GamepadEvent::DEVICE_REMOVED; break;
+                  case GamepadTransition::BUTTON_DOWN: gamepadEventType = GamepadEvent::BUTTON_DOWN; break;
+                  case GamepadTransition::BUTTON_UP: gamepadEventType = GamepadEvent::BUTTON_UP; break;
+                  case GamepadTransition::AXIS: gamepadEventType = GamepadEvent::AXIS_MOVE; break;
                }
+               
+               inputTimestamps.push_back(transition.timestamp);
+               _stage->dispatchEvent(flair::make_shared<GamepadEvent>(gamepadEventType, true, false, transition.device, transition.code, transition.value));
             });
          }
          
+         // User presence follows the platform input only, a replay stays deterministic
+         if (!_replaying) {
+            uint32_t ticks = windowService->ticks();
+            if (!inputTimestamps.empty()) {
+               _lastUserInput = ticks;
+               if (_userIdle) {
+                  _userIdle = false;
+                  _stage->dispatchEvent(flair::make_shared<Event>(Event::USER_PRESENT));
+               }
+            }
+            else if (!_userIdle && _idleThreshold > 0 && ticks - _lastUserInput >= uint32_t(_idleThreshold) * 1000) {
+               _userIdle = true;
+               _stage->dispatchEvent(flair::make_shared<Event>(Event::USER_IDLE));
+            }
+         }
+         
          auto currentTime = std::chrono::high_resolution_clock::now();
          auto deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - previousTime).count();
+         float frameTime = std::chrono::duration<float, std::milli>(currentTime - previousTime).count();
          previousTime = std::chrono::high_resolution_clock::now();
-         _stage->tick(deltaTime / 1000.0f);
          
-         renderService->clear();
-         _stage->render(renderSupport, _stage->alpha(), geom::Matrix());
-         renderService->present();
+         float deltaSeconds = _replaying ? replayDelta : deltaTime / 1000.0f;
+         if (_recording) _recording->record(deltaSeconds, keyboardService, mouseService, gamepadService, touchService);
+         
+         // Timers run on frame time, so they stay in step with tick and with a replay. Whole
+         // milliseconds would drop the fraction of every frame and let timers fall behind.
+         timerTime += _replaying ? replayDelta * 1000.0 : frameTime;
+         timerService->update(static_cast<uint64_t>(timerTime));
+         _stage->tick(deltaSeconds);
+         _stage->update();
+         
+         uint32_t frameDrawCalls = 0;
+         if (!_headless && windowService->visible()) {
+            FLAIR_PROFILE_ZONE("render");
+            renderService->clear();
+            uint64_t drawCalls = renderSupport->drawCalls();
+            _stage->render(renderSupport, _stage->alpha(), geom::Matrix());
+            frameDrawCalls = static_cast<uint32_t>(renderSupport->drawCalls() - drawCalls);
+            if (_performanceOverlay) _performanceOverlay->render(renderSupport, 1.0f, geom::Matrix());
+            renderService->present();
+         }
+         
+         if (renderCapture && renderCapture->finished()) writeRenderCapture();
+         
+         if (profileFrames && _frameStats.frame + 1 == profileFrames) {
+            flair::internal::utils::Profiler::stop();
+            flair::internal::utils::Profiler::write(profilePath);
+            profilePath.clear();
+         }
+         
+         // Startup ends with the first present
+         if (_frameStats.frame == 0) {
+            _startupStats.phases.push_back(startupPhase("first frame", firstFrameBegin));
+            _startupStats.timeToFirstFrame = _startupStats.phases.back().end;
+            
+            JSON startupTrace = _applicationDescriptor["startupTrace"];
+            if (startupTrace.isString()) writeStartupTrace(startupTrace.string_value());
+         }
+         
+         // Replayed timestamps come from the recording session, they say nothing about this one
+         if (_replaying) inputTimestamps.clear();
+         
+         // Frame stats
+         {
+            _frameStats.frame++;
+            _frameStats.frameTime = frameTime;
+            _frameStats.inputEvents = (uint32_t)inputTimestamps.size();
+            _frameStats.minDispatchLatency = _frameStats.maxDispatchLatency = _frameStats.averageDispatchLatency = 0.0f;
+            
+            if (!inputTimestamps.empty()) {
+               uint32_t presented = windowService->ticks();
+               uint32_t minLatency = UINT32_MAX, maxLatency = 0;
+               uint64_t totalLatency = 0;
+               for (auto timestamp : inputTimestamps) {
+                  uint32_t latency = presented - timestamp;
+                  minLatency = std::min(minLatency, latency);
+                  maxLatency = std::max(maxLatency, latency);
+                  totalLatency += latency;
+               }
+               
+               _frameStats.minDispatchLatency = (float)minLatency;
+               _frameStats.maxDispatchLatency = (float)maxLatency;
+               _frameStats.averageDispatchLatency = (float)totalLatency / inputTimestamps.size();
+               _frameStats.smoothedDispatchLatency += (_frameStats.averageDispatchLatency - _frameStats.smoothedDispatchLatency) * 0.1f;
+            }
+         }
+         
+         // The queue depth is only collected when the overlay is about to show it
+         if (_performanceOverlay) {
+            if (_performanceOverlay->due()) {
+               auto stats = ioStats();
+               _performanceOverlay->ioDepth(stats.inboundDepth + stats.outboundDepth + stats.pendingJobs, stats.inFlight);
+            }
+            _performanceOverlay->frame(frameTime, frameDrawCalls);
+         }
+         
+         // Sleep through the frames that could not change anything
+         int timeout = idleTimeout();
+         if (timeout != 0) {
+            FLAIR_PROFILE_ZONE("idle");
+            windowService->wait(timeout);
+         }
+      }
+      
+      if (!profilePath.empty()) {
+         flair::internal::utils::Profiler::stop();
+         flair::internal::utils::Profiler::write(profilePath);
+         profilePath.clear();
       }
       
+      primordialWorker->wakeHandler(nullptr);
+      
       _stage->dispatchEvent(flair::make_shared<Event>(Event::DEACTIVATE, false, false));
       
       delete renderSupport;
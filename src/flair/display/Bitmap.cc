@@ -21,7 +21,13 @@ namespace display {
    
    std::shared_ptr<BitmapData> Bitmap::bitmapData(std::shared_ptr<BitmapData> value)
    {
-      return _bitmapData = value;
+      _bitmapData = value;
+      
+      // The drawn size decides the bounds and culling, so they are recomputed on the next update
+      _width = _bitmapData ? _bitmapData->width() : 0.0f;
+      _height = _bitmapData ? _bitmapData->height() : 0.0f;
+      invalidateWorld();
+      return _bitmapData;
    }
    
    void Bitmap::render(RenderSupport * support, float parentAlpha, geom::Matrix parentTransform)
@@ -2,6 +2,23 @@
 #include "flair/internal/services/IRenderService.h"
 #include "flair/internal/rendering/ITexture.h"
 #include "flair/internal/utils/ByteArrayProxy.h"
+#include "flair/internal/utils/Profiler.h"
+
+namespace {
+   using flair::display::BitmapDataFormat;
+   
+   // 0 where a compressed format leaves it to the data
+   size_t bytesPerPixel(BitmapDataFormat format)
+   {
+      switch (format) {
+         case BitmapDataFormat::BGRA: return 4;
+         case BitmapDataFormat::BGRA_PACKED: return 4;
+         case BitmapDataFormat::BGR_PACKED: return 3;
+         case BitmapDataFormat::RGBA_HALF_FLOAT: return 8;
+         default: return 0;
+      }
+   }
+}
 
 namespace flair {
 namespace display {
@@ -39,26 +56,26 @@ namespace display {
    {
       flair::internal::utils::ByteArrayProxy proxy(pixels);
       
-      int bytesPerPixel = 8; // TODO: Correct format calculation
-      assert(rect.width() * rect.height() * bytesPerPixel <= proxy.length() && "Pixel buffer is not large enough for this texture");
+      assert(texture->width() * rect.height() * bytesPerPixel(format) <= proxy.length() && "Pixel buffer is not large enough for this texture");
       
+      FLAIR_PROFILE_ZONE("texture upload");
       texture->update(rect, proxy.bytes());
    }
    
    void BitmapData::setPixels(geom::Rectangle rect, std::vector<uint32_t> pixels, BitmapDataFormat format)
    {
-      int bytesPerPixel = 8; // TODO: Correct format calculation
-      assert(rect.width() * rect.height() * bytesPerPixel <= pixels.size() * 4 && "Pixel buffer is not large enough for this texture");
+      assert(texture->width() * rect.height() * bytesPerPixel(format) <= pixels.size() * 4 && "Pixel buffer is not large enough for this texture");
       
       auto bytes = (uint8_t*)pixels.data();
+      FLAIR_PROFILE_ZONE("texture upload");
       texture->update(rect, bytes);
    }
    
    void BitmapData::setPixels(geom::Rectangle rect, uint8_t const* pixels, size_t length, BitmapDataFormat format)
    {
-      int bytesPerPixel = 8; // TODO: Correct format calculation
-      assert(rect.width() * rect.height() * bytesPerPixel <= length && "Pixel buffer is not large enough for this texture");
+      assert(texture->width() * rect.height() * bytesPerPixel(format) <= length && "Pixel buffer is not large enough for this texture");
       
+      FLAIR_PROFILE_ZONE("texture upload");
       texture->update(rect, pixels);
    }
    
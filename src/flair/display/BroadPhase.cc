@@ -0,0 +1,176 @@
+#include <algorithm>
+
+#include "flair/display/BroadPhase.h"
+#include "flair/display/DisplayObject.h"
+
+using flair::geom::Rectangle;
+
+namespace flair {
+   namespace display {
+      
+      BroadPhase::BroadPhase() : _orderDirty(false) {}
+      
+      size_t BroadPhase::size() const
+      {
+         return _objects.size();
+      }
+      
+      BroadPhase::NarrowPhase BroadPhase::narrowPhase() const
+      {
+         return _narrowPhase;
+      }
+      
+      BroadPhase::NarrowPhase BroadPhase::narrowPhase(NarrowPhase narrowPhase)
+      {
+         return _narrowPhase = narrowPhase;
+      }
+      
+      const std::vector<BroadPhase::Pair> & BroadPhase::pairs() const
+      {
+         return _pairs;
+      }
+      
+      void BroadPhase::add(std::shared_ptr<DisplayObject> object)
+      {
+         if (!object) {
+            return;
+         }
+         
+         // The address of an expired object may have been reused by this one
+         auto it = _indices.find(object.get());
+         if (it != _indices.end()) {
+            if (!_objects[it->second].expired()) {
+               return;
+            }
+            removeAt(it->second);
+         }
+         
+         _indices[object.get()] = static_cast<uint32_t>(_objects.size());
+         _objects.push_back(object);
+         _keys.push_back(object.get());
+         _bounds.add(object->getBounds(nullptr));
+         _orderDirty = true;
+      }
+      
+      void BroadPhase::remove(std::shared_ptr<DisplayObject> object)
+      {
+         auto it = _indices.find(object.get());
+         if (it != _indices.end()) {
+            removeAt(it->second);
+         }
+      }
+      
+      bool BroadPhase::contains(std::shared_ptr<DisplayObject> object) const
+      {
+         auto it = _indices.find(object.get());
+         return it != _indices.end() && !_objects[it->second].expired();
+      }
+      
+      void BroadPhase::clear()
+      {
+         _objects.clear();
+         _keys.clear();
+         _indices.clear();
+         _bounds.clear();
+         _order.clear();
+         _live.clear();
+         _pairs.clear();
+         _orderDirty = false;
+      }
+      
+      const std::vector<BroadPhase::Pair> & BroadPhase::update()
+      {
+         _pairs.clear();
+         _live.clear();
+         
+         // Drop expired objects first so the remaining indices are stable for this frame
+         for (uint32_t i = 0; i < _objects.size();) {
+            if (_objects[i].expired()) {
+               removeAt(i);
+            }
+            else {
+               ++i;
+            }
+         }
+         
+         size_t count = _objects.size();
+         _live.reserve(count);
+         for (uint32_t i = 0; i < count; ++i) {
+            _live.push_back(_objects[i].lock());
+            _bounds.set(i, _live[i]->getBounds(nullptr));
+         }
+         
+         float const* left = _bounds.lefts();
+         float const* top = _bounds.tops();
+         float const* right = _bounds.rights();
+         float const* bottom = _bounds.bottoms();
+         
+         if (_orderDirty) {
+            _order.resize(count);
+            for (uint32_t i = 0; i < count; ++i) {
+               _order[i] = i;
+            }
+            std::sort(_order.begin(), _order.end(), [left](uint32_t a, uint32_t b) { return left[a] < left[b]; });
+            _orderDirty = false;
+         }
+         else {
+            // Frame to frame the order barely changes, so insertion sort is close to linear
+            for (size_t i = 1; i < count; ++i) {
+               uint32_t index = _order[i];
+               size_t j = i;
+               while (j > 0 && left[_order[j - 1]] > left[index]) {
+                  _order[j] = _order[j - 1];
+                  --j;
+               }
+               _order[j] = index;
+            }
+         }
+         
+         // Sweep: only objects starting before the current one ends can overlap it
+         for (size_t i = 0; i < count; ++i) {
+            uint32_t a = _order[i];
+            for (size_t j = i + 1; j < count && left[_order[j]] < right[a]; ++j) {
+               uint32_t b = _order[j];
+               if (left[a] < right[b] && top[a] < bottom[b] && top[b] < bottom[a]) {
+                  if (!_narrowPhase || _narrowPhase(_live[a], _live[b])) {
+                     _pairs.push_back(Pair(_live[a], _live[b]));
+                  }
+               }
+            }
+         }
+         
+         return _pairs;
+      }
+      
+      size_t BroadPhase::query(const Rectangle & bounds, std::vector<std::shared_ptr<DisplayObject>> & objects) const
+      {
+         _queryIndices.clear();
+         _bounds.intersecting(bounds, _queryIndices);
+         
+         size_t start = objects.size();
+         for (auto index : _queryIndices) {
+            if (auto object = _objects[index].lock()) {
+               objects.push_back(object);
+            }
+         }
+         return objects.size() - start;
+      }
+      
+      void BroadPhase::removeAt(uint32_t index)
+      {
+         uint32_t last = static_cast<uint32_t>(_objects.size() - 1);
+         
+         _indices.erase(_keys[index]);
+         if (index != last) {
+            _objects[index] = _objects[last];
+            _keys[index] = _keys[last];
+            _indices[_keys[index]] = index;
+         }
+         
+         _objects.pop_back();
+         _keys.pop_back();
+         _bounds.removeAt(index);
+         _orderDirty = true;
+      }
+   }
+}
@@ -11,7 +11,7 @@ using flair::geom::Point;
 namespace flair {
    namespace display {
       
-      DisplayObject::DisplayObject() : _x(0.0f), _y(0.0f), _rotation(0.0f), _scaleX(1.0f), _scaleY(1.0f), _alpha(1.0f), _width(0.0f), _height(0.0f)
+      DisplayObject::DisplayObject() : _x(0.0f), _y(0.0f), _rotation(0.0f), _scaleX(1.0f), _scaleY(1.0f), _alpha(1.0f), _width(0.0f), _height(0.0f), _touchable(true), _visible(true), _culled(false), _worldDirty(true), _subtreeDirty(false)
       {
          _parent = std::weak_ptr<DisplayObjectContainer>();
       }
@@ -60,6 +60,7 @@ namespace flair {
       {
          if (_height > 0.0f) {
             _scaleY = height / _height;
+            invalidateWorld();
          }
          return this->height();
       }
@@ -73,6 +74,7 @@ namespace flair {
       {
          if (_width > 0.0f) {
             _scaleX = width / _width;
+            invalidateWorld();
          }
          return this->width();
       }
@@ -84,6 +86,7 @@ namespace flair {
       
       float DisplayObject::x(float x)
       {
+         invalidateWorld();
          return _x = x;
       }
       
@@ -94,6 +97,7 @@ namespace flair {
       
       float DisplayObject::y(float y)
       {
+         invalidateWorld();
          return _y = y;
       }
       
@@ -136,6 +140,7 @@ namespace flair {
       Matrix DisplayObject::transformationMatrix(Matrix m)
       {
          // TODO: Set the x, y, rotation, scale, skew
+         invalidateWorld();
          return _transformationMatrix = m;
       }
       
@@ -156,6 +161,7 @@ namespace flair {
       
       float DisplayObject::rotation(float rotation)
       {
+         invalidateWorld();
          return _rotation = rotation;
       }
       
@@ -166,6 +172,7 @@ namespace flair {
       
       float DisplayObject::scaleX(float scaleX)
       {
+         invalidateWorld();
          return _scaleX = scaleX;
       }
       
@@ -176,6 +183,7 @@ namespace flair {
       
       float DisplayObject::scaleY(float scaleY)
       {
+         invalidateWorld();
          return _scaleY = scaleY;
       }
       
@@ -186,6 +194,7 @@ namespace flair {
       
       float DisplayObject::skewX(float skewX)
       {
+         invalidateWorld();
          return _skewX = skewX;
       }
       
@@ -196,6 +205,7 @@ namespace flair {
       
       float DisplayObject::skewY(float skewY)
       {
+         invalidateWorld();
          return _skewY = skewY;
       }
       
@@ -221,14 +231,34 @@ namespace flair {
       
       Rectangle DisplayObject::getBounds(std::shared_ptr<DisplayObject> targetSpace) const
       {
-         Rectangle r;
-         return r;
+         float bounds[4] = { 0.0f, 0.0f, _width, _height };
+         Matrix::transformRectangles(getTransformationMatrix(targetSpace), bounds, bounds, 1);
+         return Rectangle(bounds[0], bounds[1], bounds[2], bounds[3]);
       }
       
       Matrix DisplayObject::getTransformationMatrix(std::shared_ptr<DisplayObject> targetSpace) const
       {
-         Matrix m;
-         return m;
+         if (targetSpace.get() == this) {
+            return Matrix();
+         }
+         
+         // Concatenate up the parent chain, stopping early when targetSpace is an ancestor
+         Matrix m = transformationMatrix();
+         for (auto ancestor = parent(); ancestor; ancestor = ancestor->parent()) {
+            if (ancestor == targetSpace) {
+               return m;
+            }
+            m = ancestor->transformationMatrix() * m;
+         }
+         
+         if (!targetSpace) {
+            return m;
+         }
+         
+         // Not an ancestor, go through the shared root space
+         Matrix target = targetSpace->getTransformationMatrix(nullptr);
+         target.invert();
+         return target * m;
       }
       
       Point DisplayObject::globalToLocal(Point localPoint) const
@@ -242,6 +272,11 @@ namespace flair {
          return std::shared_ptr<DisplayObject>();
       }
       
+      bool DisplayObject::hitTestObject(std::shared_ptr<DisplayObject> object) const
+      {
+         return object && getBounds(nullptr).intersects(object->getBounds(nullptr));
+      }
+      
       void DisplayObject::setParent(std::shared_ptr<DisplayObjectContainer> parent)
       {
          std::shared_ptr<DisplayObject> ancestor = parent;
@@ -253,7 +288,10 @@ namespace flair {
             throw std::invalid_argument("An object cannot be added as a child to itself or one of its children (or children's children, etc.)");
          }
          else {
+            // The old parent loses a child, the object itself moves
+            if (auto previous = _parent.lock()) previous->invalidateWorld();
             _parent = parent;
+            invalidateWorld();
          }
       }
       
@@ -262,5 +300,31 @@ namespace flair {
          
       }
       
+      void DisplayObject::invalidateWorld()
+      {
+         _worldDirty = true;
+         
+         // Stops at the first marked ancestor, everything above it is marked already
+         for (auto ancestor = parent(); ancestor && !ancestor->_subtreeDirty; ancestor = ancestor->parent()) {
+            ancestor->_subtreeDirty = true;
+         }
+      }
+      
+      void DisplayObject::updateWorld(const Matrix & parentTransform, const Rectangle & viewport, bool parentChanged)
+      {
+         if (parentChanged || _worldDirty) {
+            _worldTransform = parentTransform * transformationMatrix();
+            
+            float bounds[4] = { 0.0f, 0.0f, _width, _height };
+            Matrix::transformRectangles(_worldTransform, bounds, bounds, 1);
+            _worldBounds.setTo(bounds[0], bounds[1], bounds[2], bounds[3]);
+         }
+         
+         // Without a size the drawn area isn't known, so only sized objects are culled
+         _culled = _width > 0.0f && _height > 0.0f && !viewport.intersects(_worldBounds);
+         _worldDirty = false;
+         _subtreeDirty = false;
+      }
+      
    }
 }
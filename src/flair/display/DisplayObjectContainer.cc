@@ -1,4 +1,6 @@
 #include "flair/display/DisplayObjectContainer.h"
+#include "flair/display/Inspector.h"
+#include "flair/geom/Point.h"
 
 #include <stdexcept>
 #include <algorithm>
@@ -32,6 +34,23 @@ namespace flair {
          return height * _scaleY;
       }
       
+      geom::Rectangle DisplayObjectContainer::getBounds(std::shared_ptr<DisplayObject> targetSpace) const
+      {
+         geom::Rectangle bounds;
+         bool found = false;
+         for (auto const& child : _children) {
+            geom::Rectangle childBounds = child->getBounds(targetSpace);
+            if (childBounds.width() == 0.0f || childBounds.height() == 0.0f) continue;
+            
+            bounds = found ? bounds.merge(childBounds) : childBounds;
+            found = true;
+         }
+         if (found) return bounds;
+         
+         geom::Point origin = getTransformationMatrix(targetSpace).transformPoint(geom::Point());
+         return geom::Rectangle(origin.x(), origin.y(), 0.0f, 0.0f);
+      }
+      
       int DisplayObjectContainer::numChildren() const
       {
          return _children.size();
@@ -171,7 +190,10 @@ namespace flair {
       {
          for (auto child : _children) {
             auto animated = std::dynamic_pointer_cast<DisplayObjectContainer>(child);
-            if (animated) animated->tick(deltaSeconds);
+            if (!animated) continue;
+            
+            if (auto inspector = Inspector::active.load(std::memory_order_acquire)) inspector->tick(animated.get(), deltaSeconds);
+            else animated->tick(deltaSeconds);
          }
       }
       
@@ -179,9 +201,77 @@ namespace flair {
       {
          geom::Matrix transform = parentTransform * transformationMatrix();
          for (auto child : _children) {
+            if (child->_culled) continue;
+            
             auto renderable = std::dynamic_pointer_cast<DisplayObject>(child);
-            if (renderable) renderable->render(support, parentAlpha, transform);
+            if (!renderable) continue;
+            
+            if (auto inspector = Inspector::active.load(std::memory_order_acquire)) inspector->render(renderable.get(), support, parentAlpha, transform);
+            else renderable->render(support, parentAlpha, transform);
+         }
+      }
+      
+      void DisplayObjectContainer::collectHitTargets(const geom::Matrix & parentTransform, geom::RectangleSet & bounds, std::vector<DisplayObject *> & objects) const
+      {
+         geom::Matrix transform = parentTransform * transformationMatrix();
+         for (auto const& child : _children) {
+            if (!child->_visible || !child->_touchable) continue;
+            
+            auto container = dynamic_cast<const DisplayObjectContainer *>(child.get());
+            if (container) {
+               container->collectHitTargets(transform, bounds, objects);
+               continue;
+            }
+            
+            float rect[4] = { 0.0f, 0.0f, child->_width, child->_height };
+            geom::Matrix::transformRectangles(transform * child->transformationMatrix(), rect, rect, 1);
+            bounds.add(rect[0], rect[1], rect[2], rect[3]);
+            objects.push_back(child.get());
+         }
+      }
+      
+      void DisplayObjectContainer::updateWorld(const geom::Matrix & parentTransform, const geom::Rectangle & viewport, bool parentChanged)
+      {
+         bool changed = updateWorldTransform(parentTransform, parentChanged);
+         for (auto const& child : _children) {
+            if (changed || child->_worldDirty || child->_subtreeDirty) child->updateWorld(_worldTransform, viewport, changed);
+         }
+         finishWorld();
+      }
+      
+      bool DisplayObjectContainer::updateWorldTransform(const geom::Matrix & parentTransform, bool parentChanged)
+      {
+         bool changed = parentChanged || _worldDirty;
+         if (changed) _worldTransform = parentTransform * transformationMatrix();
+         _worldDirty = false;
+         return changed;
+      }
+      
+      void DisplayObjectContainer::finishWorld()
+      {
+         float left = std::numeric_limits<float>::max(), top = left;
+         float right = -left, bottom = -left;
+         bool culled = !_children.empty();
+         
+         for (auto const& child : _children) {
+            culled = culled && child->_culled;
+            
+            auto const& bounds = child->_worldBounds;
+            if (bounds.width() <= 0.0f || bounds.height() <= 0.0f) continue;
+            left = std::min(left, bounds.left());
+            top = std::min(top, bounds.top());
+            right = std::max(right, bounds.right());
+            bottom = std::max(bottom, bounds.bottom());
+         }
+         
+         if (left <= right) {
+            _worldBounds.setTo(left, top, right - left, bottom - top);
+         }
+         else {
+            _worldBounds.setEmpty();
          }
+         _culled = culled;
+         _subtreeDirty = false;
       }
       
    }
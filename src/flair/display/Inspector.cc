@@ -0,0 +1,235 @@
+#include "flair/display/Inspector.h"
+#include "flair/display/Bitmap.h"
+#include "flair/display/BitmapData.h"
+#include "flair/display/RenderSupport.h"
+#include "flair/display/Stage.h"
+#include "flair/events/EventDispatcher.h"
+#include "flair/internal/utils/TypeName.h"
+
+#include <chrono>
+#include <typeinfo>
+#include <unordered_set>
+
+namespace {
+   using namespace flair::display;
+   
+   // The inspector started on this thread, the one whose dispatches are recorded
+   thread_local Inspector * startedHere = nullptr;
+   
+   // Every BitmapData is backed by a BGRA texture
+   const uint64_t TEXTURE_BYTES_PER_PIXEL = 4;
+   
+   struct Subtree
+   {
+      std::unordered_set<const BitmapData *> textures;
+      uint64_t eventTime;
+   };
+   
+   struct Walk
+   {
+      std::unordered_map<const DisplayObject *, Inspector::Sample> const& samples;
+      uint32_t frames;
+      InspectorReport & report;
+      
+      // Adds the object and everything below it
+      Subtree visit(DisplayObject * object, int32_t parent, uint32_t depth)
+      {
+         int32_t index = static_cast<int32_t>(report.nodes.size());
+         report.nodes.push_back(InspectorNode());
+         
+         Inspector::Sample sample = { 0, 0, 0, 0 };
+         auto it = samples.find(object);
+         if (it != samples.end()) sample = it->second;
+         
+         Subtree subtree = { {}, sample.eventTime };
+         auto bitmap = dynamic_cast<Bitmap *>(object);
+         if (bitmap && bitmap->bitmapData()) subtree.textures.insert(bitmap->bitmapData().get());
+         
+         uint32_t objects = 1;
+         Inspector::Sample children = { 0, 0, 0, 0 };
+         
+         auto container = dynamic_cast<DisplayObjectContainer *>(object);
+         for (int i = 0; container && i < container->numChildren(); ++i) {
+            size_t child = report.nodes.size();
+            auto below = visit(container->getChildAt(i).get(), index, depth + 1);
+            subtree.textures.insert(below.textures.begin(), below.textures.end());
+            subtree.eventTime += below.eventTime;
+            objects += report.nodes[child].objects;
+            
+            auto found = samples.find(container->getChildAt(i).get());
+            if (found == samples.end()) continue;
+            children.tickTime += found->second.tickTime;
+            children.renderTime += found->second.renderTime;
+            children.drawCalls += found->second.drawCalls;
+         }
+         
+         // Nothing times the root from above, it costs what its children do
+         if (parent < 0) {
+            sample.tickTime = children.tickTime;
+            sample.renderTime = children.renderTime;
+            sample.drawCalls = children.drawCalls;
+         }
+         
+         uint64_t textureBytes = 0;
+         for (auto texture : subtree.textures) {
+            textureBytes += static_cast<uint64_t>(texture->width()) * static_cast<uint64_t>(texture->height()) * TEXTURE_BYTES_PER_PIXEL;
+         }
+         
+         double scale = frames ? 1.0 / frames : 0.0;
+         auto & node = report.nodes[index];
+         node.name = object->name();
+         node.type = flair::internal::utils::typeName(typeid(*object).name());
+         node.depth = depth;
+         node.parent = parent;
+         node.objects = objects;
+         node.textureBytes = textureBytes;
+         node.drawCalls = static_cast<float>(sample.drawCalls * scale);
+         node.tickTime = static_cast<float>(sample.tickTime * scale / 1000000.0);
+         node.renderTime = static_cast<float>(sample.renderTime * scale / 1000000.0);
+         node.eventTime = static_cast<float>(subtree.eventTime * scale / 1000000.0);
+         return subtree;
+      }
+   };
+}
+
+namespace flair {
+namespace display {
+   
+   std::atomic<Inspector*> Inspector::active(nullptr);
+   
+   flair::JSON InspectorNode::toJSON() const
+   {
+      return flair::JSON::Object {
+         { "name", name },
+         { "type", type },
+         { "depth", static_cast<int>(depth) },
+         { "parent", static_cast<int>(parent) },
+         { "objects", static_cast<int>(objects) },
+         { "textureBytes", static_cast<double>(textureBytes) },
+         { "drawCalls", drawCalls },
+         { "tickTime", tickTime },
+         { "renderTime", renderTime },
+         { "eventTime", eventTime }
+      };
+   }
+   
+   flair::JSON InspectorReport::toJSON() const
+   {
+      return flair::JSON::Object {
+         { "frames", static_cast<int>(frames) },
+         { "nodes", nodes }
+      };
+   }
+   
+   Inspector::Inspector(std::shared_ptr<Stage> stage, uint32_t frames) : _stage(stage), _frames(frames ? frames : 1), _sampled(0), _reported(0)
+   {
+      
+   }
+   
+   Inspector::~Inspector()
+   {
+      stop();
+   }
+   
+   uint32_t Inspector::frames() const
+   {
+      return _frames;
+   }
+   
+   bool Inspector::sampling() const
+   {
+      return active.load(std::memory_order_relaxed) == this;
+   }
+   
+   void Inspector::start()
+   {
+      Inspector * previous = active.load(std::memory_order_relaxed);
+      if (previous == this) return;
+      if (previous) previous->stop();
+      
+      _sampled = 0;
+      _current.clear();
+      _reported = 0;
+      _last.clear();
+      
+      startedHere = this;
+      active.store(this, std::memory_order_release);
+      events::EventDispatcher::dispatchSampler.store(&Inspector::dispatched, std::memory_order_release);
+   }
+   
+   void Inspector::stop()
+   {
+      if (active.load(std::memory_order_relaxed) != this) return;
+      
+      active.store(nullptr, std::memory_order_release);
+      events::EventDispatcher::dispatchSampler.store(nullptr, std::memory_order_release);
+      if (startedHere == this) startedHere = nullptr;
+   }
+   
+   InspectorReport Inspector::report() const
+   {
+      InspectorReport report;
+      report.frames = _reported ? _reported : _sampled;
+      
+      auto stage = _stage.lock();
+      if (!stage) return report;
+      
+      Walk walk = { _reported ? _last : _current, report.frames, report };
+      walk.visit(stage.get(), -1, 0);
+      return report;
+   }
+   
+   flair::JSON Inspector::toJSON() const
+   {
+      return report().toJSON();
+   }
+   
+   uint64_t Inspector::now()
+   {
+      auto time = std::chrono::steady_clock::now().time_since_epoch();
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+   }
+   
+   void Inspector::frame(Stage const* stage)
+   {
+      if (stage != _stage.lock().get()) return;
+      
+      // The window rolls over once its last frame is complete
+      if (_sampled == _frames) {
+         std::swap(_last, _current);
+         _current.clear();
+         _reported = _sampled;
+         _sampled = 0;
+      }
+      ++_sampled;
+   }
+   
+   void Inspector::tick(DisplayObjectContainer * child, float deltaSeconds)
+   {
+      uint64_t begin = now();
+      child->tick(deltaSeconds);
+      _current[child].tickTime += now() - begin;
+   }
+   
+   void Inspector::render(DisplayObject * child, RenderSupport * support, float parentAlpha, geom::Matrix const& transform)
+   {
+      uint64_t drawCalls = support->drawCalls();
+      uint64_t begin = now();
+      child->render(support, parentAlpha, transform);
+      
+      auto & sample = _current[child];
+      sample.renderTime += now() - begin;
+      sample.drawCalls += support->drawCalls() - drawCalls;
+   }
+   
+   void Inspector::dispatched(events::EventDispatcher * dispatcher, uint64_t nanoseconds)
+   {
+      // Never set on other threads, and no longer active once stopped from elsewhere
+      Inspector * inspector = startedHere;
+      if (!inspector || inspector != active.load(std::memory_order_acquire)) return;
+      
+      auto object = dynamic_cast<DisplayObject *>(dispatcher);
+      if (object) inspector->_current[object].eventTime += nanoseconds;
+   }
+   
+}}
@@ -0,0 +1,222 @@
+#include "flair/display/PerformanceOverlay.h"
+#include "flair/display/BitmapData.h"
+#include "flair/display/RenderSupport.h"
+#include "flair/system/Memory.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+   const size_t COLUMNS = 16;
+   const size_t LINES = 4;
+   const size_t CELL_WIDTH = 4;
+   const size_t CELL_HEIGHT = 6;
+   const size_t TEXT_WIDTH = COLUMNS * CELL_WIDTH;
+   const size_t TEXT_HEIGHT = LINES * CELL_HEIGHT;
+   const float TEXT_SCALE = 2.0f;
+   
+   const size_t GRAPH_WIDTH = 128;
+   const size_t GRAPH_HEIGHT = 40;
+   
+   // Frame time at the top of the graph and the budget marked in it, in milliseconds
+   const float GRAPH_RANGE = 50.0f;
+   const float GRAPH_BUDGET = 1000.0f / 60.0f;
+   
+   const float REFRESH_INTERVAL = 250.0f;
+   
+   // Pixels are BGRA in memory, 0xAARRGGBB as little endian words
+   const uint32_t BACKGROUND = 0xc0000000;
+   const uint32_t FOREGROUND = 0xffffffff;
+   const uint32_t BUDGET = 0xff808080;
+   const uint32_t FAST = 0xff40c040;
+   const uint32_t SLOW = 0xffe0c040;
+   const uint32_t DROPPED = 0xffe04040;
+   
+   // 3x5 pixels, one octal digit per row from the top with the high bit on the left
+   struct Glyph
+   {
+      char character;
+      uint16_t rows;
+   };
+   
+   const Glyph GLYPHS[] = {
+      { '0', 075557 }, { '1', 026227 }, { '2', 071747 }, { '3', 071717 }, { '4', 055711 },
+      { '5', 074717 }, { '6', 074757 }, { '7', 071111 }, { '8', 075757 }, { '9', 075717 },
+      { '.', 000002 }, { '/', 011244 }, { 'A', 025755 }, { 'B', 065656 }, { 'D', 065556 },
+      { 'E', 074647 }, { 'F', 074644 }, { 'G', 034553 }, { 'I', 072227 }, { 'K', 055655 },
+      { 'M', 057755 }, { 'O', 025552 }, { 'P', 065644 }, { 'R', 065655 }, { 'S', 034216 },
+      { 'T', 072222 }, { 'W', 055775 }, { 'X', 055255 }
+   };
+   
+   uint16_t glyph(char character)
+   {
+      for (auto const& glyph : GLYPHS) {
+         if (glyph.character == character) return glyph.rows;
+      }
+      return 0;
+   }
+   
+   std::string format(const char * format, double a, double b = 0.0)
+   {
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), format, a, b);
+      return buffer;
+   }
+   
+   std::string formatBytes(int64_t bytes)
+   {
+      if (bytes < (1 << 20)) return format("%.0fKB", bytes / 1024.0);
+      if (bytes < (1 << 30)) return format("%.1fMB", bytes / 1048576.0);
+      return format("%.2fGB", bytes / 1073741824.0);
+   }
+}
+
+namespace flair {
+namespace display {
+   
+   PerformanceOverlay::PerformanceOverlay() : _lines(LINES), _textPixels(TEXT_WIDTH * TEXT_HEIGHT, BACKGROUND), _dirtyLines(0),
+      _graphPixels(GRAPH_WIDTH * GRAPH_HEIGHT, BACKGROUND), _graphHead(0), _graphColumns(GRAPH_WIDTH), _elapsed(0.0f), _frames(0), _drawCalls(0),
+      _ioQueued(0), _ioInFlight(0)
+   {
+      _width = TEXT_WIDTH * TEXT_SCALE;
+      _height = TEXT_HEIGHT * TEXT_SCALE + GRAPH_HEIGHT;
+      _touchable = false;
+      
+      size_t budget = GRAPH_HEIGHT - static_cast<size_t>(GRAPH_BUDGET / GRAPH_RANGE * GRAPH_HEIGHT);
+      std::fill_n(_graphPixels.begin() + budget * GRAPH_WIDTH, GRAPH_WIDTH, BUDGET);
+   }
+   
+   PerformanceOverlay::~PerformanceOverlay()
+   {
+   
+   }
+   
+   std::vector<std::string> const& PerformanceOverlay::lines() const
+   {
+      return _lines;
+   }
+   
+   bool PerformanceOverlay::due() const
+   {
+      return _elapsed >= REFRESH_INTERVAL;
+   }
+   
+   void PerformanceOverlay::ioDepth(size_t queued, size_t inFlight)
+   {
+      _ioQueued = queued;
+      _ioInFlight = inFlight;
+   }
+   
+   void PerformanceOverlay::frame(float frameTime, uint32_t drawCalls)
+   {
+      if (due()) refresh();
+      
+      _elapsed += frameTime;
+      _frames++;
+      _drawCalls += drawCalls;
+      
+      // One column, the budget line shows through above the bar
+      size_t budget = GRAPH_HEIGHT - static_cast<size_t>(GRAPH_BUDGET / GRAPH_RANGE * GRAPH_HEIGHT);
+      size_t bar = static_cast<size_t>(std::min(frameTime / GRAPH_RANGE, 1.0f) * GRAPH_HEIGHT + 0.5f);
+      uint32_t color = frameTime <= GRAPH_BUDGET * 1.05f ? FAST : frameTime <= GRAPH_BUDGET * 2.0f ? SLOW : DROPPED;
+      
+      for (size_t y = 0; y < GRAPH_HEIGHT; ++y) {
+         uint32_t pixel = y >= GRAPH_HEIGHT - bar ? color : y == budget ? BUDGET : BACKGROUND;
+         _graphPixels[y * GRAPH_WIDTH + _graphHead] = pixel;
+      }
+      _graphHead = (_graphHead + 1) % GRAPH_WIDTH;
+      _graphColumns = std::min(_graphColumns + 1, GRAPH_WIDTH);
+   }
+   
+   void PerformanceOverlay::refresh()
+   {
+      float frameTime = _elapsed / _frames;
+      float fps = _frames * 1000.0f / _elapsed;
+      
+      int64_t textureBytes = 0;
+      for (auto const& usage : flair::system::memoryStats().usage) {
+         if (usage.category == flair::system::MemoryCategory::TEXTURE) textureBytes += usage.bytes;
+      }
+      
+      drawLine(0, format("%.0f FPS ", fps) + format(frameTime < 100.0f ? "%.1fMS" : "%.0fMS", frameTime));
+      drawLine(1, format("DRAW %.0f", static_cast<double>(_drawCalls) / _frames));
+      drawLine(2, "TEX " + formatBytes(textureBytes));
+      drawLine(3, format("IO %.0f/%.0f", static_cast<double>(_ioQueued), static_cast<double>(_ioInFlight)));
+      
+      _elapsed = 0.0f;
+      _frames = 0;
+      _drawCalls = 0;
+   }
+   
+   void PerformanceOverlay::drawLine(size_t line, std::string const& text)
+   {
+      std::string const& previous = _lines[line];
+      
+      // Only the cells whose character changed
+      for (size_t column = 0; column < COLUMNS; ++column) {
+         char character = column < text.size() ? text[column] : ' ';
+         char drawn = column < previous.size() ? previous[column] : ' ';
+         if (character == drawn) continue;
+         
+         uint16_t rows = glyph(character);
+         for (size_t y = 0; y < CELL_HEIGHT; ++y) {
+            uint32_t * pixels = &_textPixels[(line * CELL_HEIGHT + y) * TEXT_WIDTH + column * CELL_WIDTH];
+            for (size_t x = 0; x < CELL_WIDTH; ++x) {
+               bool set = y >= 1 && x >= 1 && (rows >> ((5 - y) * 3 + (3 - x))) & 1;
+               pixels[x] = set ? FOREGROUND : BACKGROUND;
+            }
+         }
+         _dirtyLines |= 1 << line;
+      }
+      
+      _lines[line] = text.substr(0, COLUMNS);
+   }
+   
+   void PerformanceOverlay::render(RenderSupport * support, float parentAlpha, geom::Matrix parentTransform)
+   {
+      if (!_text) {
+         _text = flair::make_shared<BitmapData>(TEXT_WIDTH, TEXT_HEIGHT);
+         _graph = flair::make_shared<BitmapData>(GRAPH_WIDTH, GRAPH_HEIGHT);
+         _dirtyLines = (1 << LINES) - 1;
+         _graphColumns = GRAPH_WIDTH;
+      }
+      
+      // Whole rows go up, so a text line at a time
+      for (size_t line = 0; line < LINES; ++line) {
+         if (!(_dirtyLines & (1 << line))) continue;
+         
+         auto pixels = reinterpret_cast<uint8_t const*>(&_textPixels[line * CELL_HEIGHT * TEXT_WIDTH]);
+         _text->setPixels(geom::Rectangle(0, line * CELL_HEIGHT, TEXT_WIDTH, CELL_HEIGHT), pixels, TEXT_WIDTH * CELL_HEIGHT * 4);
+      }
+      _dirtyLines = 0;
+      
+      // Only the new columns of the graph, which wrap around its right edge at most once
+      if (_graphColumns > 0) {
+         auto pixels = reinterpret_cast<uint8_t const*>(_graphPixels.data());
+         size_t length = _graphPixels.size() * 4;
+         size_t first = (_graphHead + GRAPH_WIDTH - _graphColumns) % GRAPH_WIDTH;
+         
+         if (_graphColumns == GRAPH_WIDTH) {
+            _graph->setPixels(geom::Rectangle(0, 0, GRAPH_WIDTH, GRAPH_HEIGHT), pixels, length);
+         } else if (first < _graphHead) {
+            _graph->setPixels(geom::Rectangle(first, 0, _graphColumns, GRAPH_HEIGHT), pixels, length);
+         } else {
+            _graph->setPixels(geom::Rectangle(first, 0, GRAPH_WIDTH - first, GRAPH_HEIGHT), pixels, length);
+            if (_graphHead > 0) _graph->setPixels(geom::Rectangle(0, 0, _graphHead, GRAPH_HEIGHT), pixels, length);
+         }
+         _graphColumns = 0;
+      }
+      
+      geom::Matrix transform = parentTransform * transformationMatrix();
+      support->renderBitmapData(_text, geom::Rectangle(0, 0, TEXT_WIDTH, TEXT_HEIGHT), transform * geom::Matrix(TEXT_SCALE, 0.0f, 0.0f, TEXT_SCALE));
+      
+      // The graph is a ring, oldest column first
+      float top = TEXT_HEIGHT * TEXT_SCALE;
+      float older = static_cast<float>(GRAPH_WIDTH - _graphHead);
+      support->renderBitmapData(_graph, geom::Rectangle(_graphHead, 0, older, GRAPH_HEIGHT), transform * geom::Matrix(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, top));
+      if (_graphHead > 0) {
+         support->renderBitmapData(_graph, geom::Rectangle(0, 0, _graphHead, GRAPH_HEIGHT), transform * geom::Matrix(1.0f, 0.0f, 0.0f, 1.0f, older, top));
+      }
+   }
+   
+}}
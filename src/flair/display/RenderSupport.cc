@@ -10,7 +10,7 @@ namespace display {
    
    flair::internal::services::IRenderService * RenderSupport::renderService = nullptr;
    
-   RenderSupport::RenderSupport()
+   RenderSupport::RenderSupport() : _drawCalls(0)
    {
       
    }
@@ -20,10 +20,22 @@ namespace display {
       
    }
    
+   uint64_t RenderSupport::drawCalls() const
+   {
+      return _drawCalls;
+   }
+   
    void RenderSupport::renderBitmap(std::shared_ptr<Bitmap> bitmap, geom::Matrix transform)
    {      
       geom::Rectangle src(0, 0, bitmap->width(), bitmap->height());
       renderService->renderTexture(bitmap->bitmapData()->texture, src, transform);
+      ++_drawCalls;
+   }
+   
+   void RenderSupport::renderBitmapData(std::shared_ptr<BitmapData> bitmapData, geom::Rectangle source, geom::Matrix transform)
+   {
+      renderService->renderTexture(bitmapData->texture, source, transform);
+      ++_drawCalls;
    }
    
 }}
@@ -1,23 +1,15 @@
 #include "flair/display/Stage.h"
+#include "flair/display/Inspector.h"
 #include "flair/events/Event.h"
+#include "flair/events/GamepadEvent.h"
+#include "flair/system/Worker.h"
+#include "flair/internal/utils/Profiler.h"
+
+#include <algorithm>
 
 namespace {
-   static unsigned int fps = 0;
-   static unsigned int fpsCount = 0;
-   static float fpsInterval = 0.0f;
-   
-   void updateFps(float deltaSeconds)
-   {
-      fpsCount++;
-      if (fpsInterval >= 1.0f) {
-         fps = fpsCount;
-         fpsCount = 0;
-         fpsInterval = 0.0f;
-         
-         std::cout << "FPS: " << fps << std::endl;
-      }
-      fpsInterval += deltaSeconds;
-   }
+   // Independent subtrees the update phase aims for before going parallel
+   const size_t PARALLEL_SUBTREES = 64;
 }
 
 namespace flair {
@@ -25,7 +17,7 @@ namespace flair {
       
       using flair::events::Event;
       
-      Stage::Stage() : DisplayObjectContainer(), _stageWidth(0), _stageHeight(0)
+      Stage::Stage() : DisplayObjectContainer(), _stageWidth(0), _stageHeight(0), _frameRequested(false), _gamepadListened(false)
       {
 
       }
@@ -45,15 +37,107 @@ namespace flair {
          return _stageHeight;
       }
       
+      void Stage::addEventListener(std::string type, std::function<void(std::shared_ptr<Event>)> listener, bool useCapture, int32_t priority, bool once)
+      {
+         using flair::events::GamepadEvent;
+         if (type == GamepadEvent::DEVICE_ADDED || type == GamepadEvent::DEVICE_REMOVED || type == GamepadEvent::BUTTON_DOWN || type == GamepadEvent::BUTTON_UP || type == GamepadEvent::AXIS_MOVE) {
+            _gamepadListened = true;
+         }
+         
+         DisplayObjectContainer::addEventListener(type, std::move(listener), useCapture, priority, once);
+      }
+      
+      void Stage::hitTestPoints(const geom::Point * points, size_t count, std::shared_ptr<DisplayObject> * targets)
+      {
+         if (count == 0) return;
+         
+         _hitBounds.clear();
+         _hitObjects.clear();
+         if (_visible && _touchable) collectHitTargets(geom::Matrix(), _hitBounds, _hitObjects);
+         
+         for (size_t i = 0; i < count; ++i) {
+            _hitIndices.clear();
+            _hitBounds.containing(points[i], _hitIndices);
+            
+            if (_hitIndices.empty()) {
+               targets[i].reset();
+               continue;
+            }
+            
+            uint32_t topmost = *std::max_element(_hitIndices.begin(), _hitIndices.end());
+            targets[i] = std::static_pointer_cast<DisplayObject>(_hitObjects[topmost]->shared_from_this());
+         }
+      }
+      
+      void Stage::invalidate()
+      {
+         _frameRequested = true;
+      }
+      
       void Stage::tick(float deltaSeconds)
       {
+         FLAIR_PROFILE_ZONE("Stage::tick");
+         
+         if (auto inspector = Inspector::active.load(std::memory_order_acquire)) inspector->frame(this);
+         
          DisplayObjectContainer::tick(deltaSeconds);
          
          // TODO: Testing
          dispatchEvent(flair::make_shared<Event>(Event::ENTER_FRAME));
+      }
+      
+      void Stage::update()
+      {
+         FLAIR_PROFILE_ZONE("Stage::update");
          
-         // TODO: Testing
-         updateFps(deltaSeconds);
+         // A resize moves the culling edges under every object
+         geom::Rectangle viewport(0.0f, 0.0f, _stageWidth, _stageHeight);
+         bool resized = viewport != _viewport;
+         _viewport = viewport;
+         if (!resized && !_worldDirty && !_subtreeDirty) return;
+         
+         // Split the changed part of the tree open level by level until there are enough subtrees
+         // to go around. The containers split open get their transforms here, serially.
+         _worldSplits.clear();
+         _worldUpdates.clear();
+         _worldUpdates.push_back(WorldUpdate{ this, nullptr, resized });
+         
+         const geom::Matrix identity;
+         while (_worldUpdates.size() < PARALLEL_SUBTREES) {
+            _worldNext.clear();
+            bool split = false;
+            
+            for (auto const& update : _worldUpdates) {
+               auto container = dynamic_cast<DisplayObjectContainer *>(update.object);
+               if (!container || container->_children.empty()) {
+                  _worldNext.push_back(update);
+                  continue;
+               }
+               
+               bool changed = container->updateWorldTransform(update.parent ? update.parent->_worldTransform : identity, update.parentChanged);
+               for (auto const& child : container->_children) {
+                  if (changed || child->_worldDirty || child->_subtreeDirty) _worldNext.push_back(WorldUpdate{ child.get(), container, changed });
+               }
+               _worldSplits.push_back(container);
+               split = true;
+            }
+            
+            std::swap(_worldUpdates, _worldNext);
+            if (!split) break;
+         }
+         
+         // Every subtree only writes to its own objects
+         flair::system::Worker::parallelFor(_worldUpdates.size(), [this, &viewport, &identity](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+               auto const& update = _worldUpdates[i];
+               update.object->updateWorld(update.parent ? update.parent->_worldTransform : identity, viewport, update.parentChanged);
+            }
+         });
+         
+         // Deterministic join, the split containers merge their children deepest level first
+         for (auto it = _worldSplits.rbegin(); it != _worldSplits.rend(); ++it) {
+            (*it)->finishWorld();
+         }
       }
       
    }
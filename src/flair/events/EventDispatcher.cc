@@ -1,8 +1,42 @@
 #include "flair/events/EventDispatcher.h"
+#include "flair/display/Inspector.h"
+#include "flair/internal/utils/Profiler.h"
+#include "flair/system/Memory.h"
+
+#include <vector>
+
+namespace {
+   // Listeners that outlived what they listen for, such as weak listeners whose target is gone,
+   // show up as a count that only grows
+   flair::system::MemoryCounter & listenerCounter()
+   {
+      static flair::system::MemoryCounter * counter = new flair::system::MemoryCounter(flair::system::MemoryCategory::EVENT_LISTENER, "event listeners");
+      return *counter;
+   }
+   
+   typedef std::shared_ptr<std::function<void(std::shared_ptr<flair::events::Event>)>> Callback;
+   
+   // Listeners of the dispatches in progress on this thread, taken before any is called so that
+   // listeners can add and remove listeners, nested dispatches stack on top. Once it has grown
+   // to the deepest nesting a dispatch only counts references.
+   thread_local std::vector<Callback> dispatching;
+   
+   // Drops what a dispatch stacked, also when a listener throws
+   struct DispatchScope
+   {
+      DispatchScope(std::vector<Callback> & callbacks) : callbacks(callbacks), base(callbacks.size()) {}
+      ~DispatchScope() { callbacks.resize(base); }
+      
+      std::vector<Callback> & callbacks;
+      size_t base;
+   };
+}
 
 namespace flair {
    namespace events {
-            
+      
+      std::atomic<void (*)(EventDispatcher *, uint64_t)> EventDispatcher::dispatchSampler(nullptr);
+      
       EventDispatcher::EventDispatcher(std::shared_ptr<EventDispatcher> target)
       {
          
@@ -20,30 +54,65 @@ namespace flair {
          }
          
          if (hint == listeners.end()) {
-            listeners.insert(std::make_pair(type, EventListener(std::move(listener), useCapture, priority)));
+            listeners.insert(std::make_pair(type, EventListener(std::move(listener), useCapture, priority, once)));
          }
          else {
-            listeners.insert(hint, std::make_pair(type, EventListener(std::move(listener), useCapture, priority)));
+            listeners.insert(hint, std::make_pair(type, EventListener(std::move(listener), useCapture, priority, once)));
          }
+         listenerCounter().add(1, 0);
       }
       
       EventDispatcher::~EventDispatcher()
       {
+         listenerCounter().add(-static_cast<int64_t>(listeners.size()), 0);
          listeners.clear();
       }
       
       bool EventDispatcher::dispatchEvent(std::shared_ptr<Event> event)
       {
-         bool dispatched = false;
+         FLAIR_PROFILE_ZONE_DETAIL("dispatchEvent", event->type());
+         
+         // Nested dispatches add to the time of the enclosing one. Workers dispatch their channel
+         // messages on their own threads, so each thread keeps its own nesting.
+         static thread_local uint64_t nested = 0;
+         uint64_t outer = nested;
+         uint64_t begin = 0;
+         if (dispatchSampler.load(std::memory_order_relaxed)) {
+            nested = 0;
+            begin = flair::display::Inspector::now();
+         }
+         
+         auto & callbacks = dispatching;
+         DispatchScope scope(callbacks);
+         
          auto range = listeners.equal_range(event->type());
-         for (auto it = range.first; it != range.second; ++it) {
-            auto eventListener = it->second;
-            eventListener.callback(event);
+         for (auto it = range.first; it != range.second; ) {
+            callbacks.push_back(it->second.callback);
             
-            dispatched = true;
+            // Gone before it runs, so a listener that dispatches again is not called twice
+            if (it->second.once) {
+               it = listeners.erase(it);
+               listenerCounter().add(-1, 0);
+            }
+            else {
+               ++it;
+            }
+         }
+         
+         size_t end = callbacks.size();
+         bool dispatched = end > scope.base;
+         for (size_t i = scope.base; i < end; ++i) {
+            // Nested dispatches may grow the stack while this one runs
+            Callback callback = std::move(callbacks[i]);
+            (*callback)(event);
             //if (event->preventDefault()) dispatched = false;
-            
-            if (eventListener.once) it = listeners.erase(it);
+         }
+         
+         auto sampler = dispatchSampler.load(std::memory_order_acquire);
+         if (sampler && begin) {
+            uint64_t elapsed = flair::display::Inspector::now() - begin;
+            sampler(this, elapsed > nested ? elapsed - nested : 0);
+            nested = outer + elapsed;
          }
          
          return dispatched;
@@ -61,6 +130,7 @@ namespace flair {
          for (auto it = range.first; it != range.second; ) {
             auto const& eventListener = it->second;
             bool target = isTarget(eventListener, listener, useCapture);
+            if (target) listenerCounter().add(-1, 0);
             it = target ? listeners.erase(it) : ++it;
          }
       }
@@ -74,8 +144,8 @@ namespace flair {
       bool EventDispatcher::isTarget(EventListener const& targetListener, std::function<void(std::shared_ptr<Event>)> const& listener, bool useCapture)
       {
          return targetListener.useCapture == useCapture &&
-                targetListener.callback.target_type() == listener.target_type() &&
-                targetListener.callback.target<void(std::shared_ptr<Event>)>() == listener.target<void(std::shared_ptr<Event>)>();
+                targetListener.callback->target_type() == listener.target_type() &&
+                targetListener.callback->target<void(std::shared_ptr<Event>)>() == listener.target<void(std::shared_ptr<Event>)>();
       }
    }
 }
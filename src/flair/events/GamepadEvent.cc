@@ -0,0 +1,48 @@
+#include "flair/events/GamepadEvent.h"
+
+namespace flair {
+   namespace events {
+      
+      GamepadEvent::GamepadEvent(const char* type, bool bubbles, bool cancelable, uint32_t device, uint32_t code, float value)
+         : Event(type, bubbles, cancelable), _device(device), _code(code), _value(value)
+      {
+         
+      }
+      
+      GamepadEvent::~GamepadEvent()
+      {
+         
+      }
+      
+      uint32_t GamepadEvent::device()
+      {
+         return _device;
+      }
+      
+      uint32_t GamepadEvent::code()
+      {
+         return _code;
+      }
+      
+      float GamepadEvent::value()
+      {
+         return _value;
+      }
+      
+      std::shared_ptr<Event> GamepadEvent::clone()
+      {
+         return std::static_pointer_cast<Event>(flair::make_shared<GamepadEvent>(_type.c_str(), _bubbles, _cancelable, _device, _code, _value));
+      }
+      
+      std::string GamepadEvent::toString() const
+      {
+         return "[flair.events.GamepadEvent GamepadEvent]";
+      }
+      
+      const char* GamepadEvent::DEVICE_ADDED = "deviceAdded";
+      const char* GamepadEvent::DEVICE_REMOVED = "deviceRemoved";
+      const char* GamepadEvent::BUTTON_DOWN = "buttonDown";
+      const char* GamepadEvent::BUTTON_UP = "buttonUp";
+      const char* GamepadEvent::AXIS_MOVE = "axisMove";
+   }
+}
@@ -1,11 +1,14 @@
 #include "flair/events/MouseEvent.h"
 
+#include <stdexcept>
+
 namespace flair {
 namespace events {
    
    MouseEvent::MouseEvent(const char * type, bool bubbles, bool cancelable, float localX, float localY, float movementX, float movementY, std::shared_ptr<Object> relatedObject, bool buttonDown, int delta, int clickCount, bool ctrlKey, bool altKey, bool shiftKey, bool controlKey, bool commandKey)
       : Event(type, bubbles, cancelable), _localX(localX), _localY(localY), _movementX(movementX), _movementY(movementY), _stageX(localX), _stageY(localY), _relatedObject(relatedObject),
-         _buttonDown(buttonDown), _delta(delta), _clickCount(clickCount), _ctrlKey(ctrlKey), _altKey(altKey), _shiftKey(shiftKey), _controlKey(controlKey), _commandKey(commandKey)
+         _buttonDown(buttonDown), _delta(delta), _clickCount(clickCount), _ctrlKey(ctrlKey), _altKey(altKey), _shiftKey(shiftKey), _controlKey(controlKey), _commandKey(commandKey),
+         _history(nullptr), _historyLength(0)
    {
       
    }
@@ -90,6 +93,25 @@ namespace events {
       return _shiftKey;
    }
    
+   size_t MouseEvent::historyLength()
+   {
+      return _historyLength;
+   }
+   
+   const MouseEvent::Sample & MouseEvent::history(size_t index)
+   {
+      if (index >= _historyLength) {
+         throw std::out_of_range("The index specified is outside the motion history");
+      }
+      return _history[index];
+   }
+   
+   void MouseEvent::history(const Sample * samples, size_t length)
+   {
+      _history = samples;
+      _historyLength = length;
+   }
+   
    std::shared_ptr<Event> MouseEvent::clone()
    {
       return std::static_pointer_cast<Event>(flair::make_shared<MouseEvent>(_type.c_str(), _bubbles, _cancelable, _localX, _localY, _movementX, _movementY, _relatedObject, _buttonDown, _delta, _clickCount, _ctrlKey, _altKey, _shiftKey, _controlKey, _commandKey));
@@ -0,0 +1,29 @@
+#include "flair/events/TimerEvent.h"
+
+namespace flair {
+   namespace events {
+      
+      TimerEvent::TimerEvent(const char* type, bool bubbles, bool cancelable) : Event(type, bubbles, cancelable)
+      {
+         
+      }
+      
+      TimerEvent::~TimerEvent()
+      {
+         
+      }
+      
+      std::shared_ptr<Event> TimerEvent::clone()
+      {
+         return std::static_pointer_cast<Event>(flair::make_shared<TimerEvent>(_type.c_str(), _bubbles, _cancelable));
+      }
+      
+      std::string TimerEvent::toString() const
+      {
+         return "[flair.events.TimerEvent TimerEvent]";
+      }
+      
+      const char* TimerEvent::TIMER = "timer";
+      const char* TimerEvent::TIMER_COMPLETE = "timerComplete";
+   }
+}
@@ -0,0 +1,98 @@
+#include "flair/events/TouchEvent.h"
+
+namespace flair {
+namespace events {
+   
+   TouchEvent::TouchEvent(const char * type, bool bubbles, bool cancelable, int64_t touchPointID, bool isPrimaryTouchPoint, float localX, float localY, float pressure)
+      : Event(type, bubbles, cancelable), _isPrimaryTouchPoint(isPrimaryTouchPoint), _localX(localX), _localY(localY), _pressure(pressure),
+         _stageX(localX), _stageY(localY), _touchPointID(touchPointID), _batchIndex(0), _batchLength(1)
+   {
+      
+   }
+   
+   TouchEvent::~TouchEvent()
+   {
+      
+   }
+   
+   bool TouchEvent::isPrimaryTouchPoint()
+   {
+      return _isPrimaryTouchPoint;
+   }
+   
+   float TouchEvent::localX()
+   {
+      return _localX;
+   }
+   
+   float TouchEvent::localY()
+   {
+      return _localY;
+   }
+   
+   float TouchEvent::pressure()
+   {
+      return _pressure;
+   }
+   
+   float TouchEvent::stageX()
+   {
+      return _stageX;
+   }
+   
+   float TouchEvent::stageY()
+   {
+      return _stageY;
+   }
+   
+   int64_t TouchEvent::touchPointID()
+   {
+      return _touchPointID;
+   }
+   
+   size_t TouchEvent::batchIndex()
+   {
+      return _batchIndex;
+   }
+   
+   size_t TouchEvent::batchLength()
+   {
+      return _batchLength;
+   }
+   
+   void TouchEvent::reset(const char * type, std::shared_ptr<Object> target, int64_t touchPointID, bool isPrimaryTouchPoint, float localX, float localY, float stageX, float stageY, float pressure, size_t batchIndex, size_t batchLength)
+   {
+      _type = type;
+      _target = target;
+      _preventDefault = false;
+      _stopImmediatePropegation = false;
+      _stopPropigation = false;
+      
+      _touchPointID = touchPointID;
+      _isPrimaryTouchPoint = isPrimaryTouchPoint;
+      _localX = localX;
+      _localY = localY;
+      _stageX = stageX;
+      _stageY = stageY;
+      _pressure = pressure;
+      _batchIndex = batchIndex;
+      _batchLength = batchLength;
+   }
+   
+   std::shared_ptr<Event> TouchEvent::clone()
+   {
+      auto event = flair::make_shared<TouchEvent>(_type.c_str(), _bubbles, _cancelable, _touchPointID, _isPrimaryTouchPoint, _localX, _localY, _pressure);
+      event->_stageX = _stageX;
+      event->_stageY = _stageY;
+      return std::static_pointer_cast<Event>(event);
+   }
+   
+   std::string TouchEvent::toString() const
+   {
+      return "[flair.events.TouchEvent TouchEvent]";
+   }
+   
+   const char * TouchEvent::TOUCH_BEGIN = "touchBegin";
+   const char * TouchEvent::TOUCH_END = "touchEnd";
+   const char * TouchEvent::TOUCH_MOVE = "touchMove";
+}}
@@ -1,13 +1,19 @@
 #include <cmath>
+#include <algorithm>
+#include <type_traits>
 
 #include "flair/geom/Matrix.h"
 #include "flair/geom/Point.h"
+#include "flair/internal/utils/SIMD.h"
 
 namespace flair {
    namespace geom {
       
+      static_assert(std::is_trivially_copyable<Matrix>::value, "Matrix must stay plain data");
+      static_assert(sizeof(Matrix) == sizeof(float) * 6, "Matrix must be tightly packed for the batch kernels");
+      
       Matrix::Matrix(float a, float b, float c, float d, float tx, float ty)
-         : _a(a), _b(b), _c(c), _d(d), _tx(tx), _ty(ty), _u(0.0f), _v(0.0f), _w(1.0f) {};
+         : _a(a), _b(b), _c(c), _d(d), _tx(tx), _ty(ty) {};
       
       float Matrix::a() const
       {
@@ -89,15 +95,12 @@ namespace flair {
       {
          _a = 1.0f;
          _b = 0.0f;
-         _u = 0.0f;
          
          _c = 0.0f;
          _d = 1.0f;
-         _v = 0.0f;
          
          _tx = 0.0f;
          _ty = 0.0f;
-         _w = 1.0f;
       }
       
       void Matrix::invert()
@@ -115,8 +118,15 @@ namespace flair {
       
       void Matrix::rotate(float angle)
       {
-         Matrix rotation(cosf(angle), sinf(angle), -sinf(angle), cosf(angle));
-         *this = *this * rotation;
+         float cos = cosf(angle);
+         float sin = sinf(angle);
+         float a = _a, b = _b, c = _c, d = _d;
+         
+         // Post multiply by the rotation, the translation is untouched by the 2x2 product
+         _a = a * cos + c * sin;
+         _b = b * cos + d * sin;
+         _c = c * cos - a * sin;
+         _d = d * cos - b * sin;
          
          // Apply the operation to the translation vector
          float x = _a * _tx + _c * _ty;
@@ -127,8 +137,10 @@ namespace flair {
       
       void Matrix::scale(float x, float y)
       {
-         Matrix scale(x, 0.0f, 0.0f, y);
-         *this = *this * scale;
+         _a *= x;
+         _b *= x;
+         _c *= y;
+         _d *= y;
          
          // Apply the operation to the translation vector
          float tx = _a * _tx + _c * _ty;
@@ -147,49 +159,159 @@ namespace flair {
       {
          _a = a;
          _b = b;
-         _u = 0.0f;
          
          _c = c;
          _d = d;
-         _v = 0.0f;
          
          _tx = tx;
          _ty = ty;
-         _w = 1.0f;
       }
       
-      Matrix & Matrix::operator=(Matrix rhs)
+      void Matrix::transformPoints(const Matrix & m, float const* points, float * out, size_t count)
       {
-         _a = rhs._a;
-         _b = rhs._b;
-         _u = rhs._u;
+         size_t i = 0;
+         
+#if defined(FLAIR_SIMD_SSE2)
+         // Two points per register: [x0, y0, x1, y1]
+         const __m128 ab = _mm_setr_ps(m._a, m._b, m._a, m._b);
+         const __m128 cd = _mm_setr_ps(m._c, m._d, m._c, m._d);
+         const __m128 t = _mm_setr_ps(m._tx, m._ty, m._tx, m._ty);
+         for (; i + 2 <= count; i += 2) {
+            __m128 p = _mm_loadu_ps(&points[i * 2]);
+            __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+            __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+            _mm_storeu_ps(&out[i * 2], _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, ab), _mm_mul_ps(y, cd)), t));
+         }
+#elif defined(FLAIR_SIMD_NEON)
+         const float abValues[4] = { m._a, m._b, m._a, m._b };
+         const float cdValues[4] = { m._c, m._d, m._c, m._d };
+         const float tValues[4] = { m._tx, m._ty, m._tx, m._ty };
+         const float32x4_t ab = vld1q_f32(abValues);
+         const float32x4_t cd = vld1q_f32(cdValues);
+         const float32x4_t t = vld1q_f32(tValues);
+         for (; i + 2 <= count; i += 2) {
+            float32x4_t p = vld1q_f32(&points[i * 2]);
+            float32x4x2_t xy = vtrnq_f32(p, p); // [x0, x0, x1, x1], [y0, y0, y1, y1]
+            vst1q_f32(&out[i * 2], vaddq_f32(vaddq_f32(vmulq_f32(xy.val[0], ab), vmulq_f32(xy.val[1], cd)), t));
+         }
+#endif
          
-         _c = rhs._c;
-         _d = rhs._d;
-         _v = rhs._v;
+         for (; i < count; ++i) {
+            float x = points[i * 2];
+            float y = points[i * 2 + 1];
+            out[i * 2] = (m._a * x + m._c * y) + m._tx;
+            out[i * 2 + 1] = (m._b * x + m._d * y) + m._ty;
+         }
+      }
+      
+      void Matrix::transformRectangles(const Matrix & m, float const* rects, float * out, size_t count)
+      {
+         // The bounds of a transformed rectangle are the transformed origin extended by the
+         // negative and positive parts of the transformed width and height edge vectors.
+         size_t i = 0;
          
-         _tx = rhs._tx;
-         _ty = rhs._ty;
-         _w = rhs._w;
+#if defined(FLAIR_SIMD_SSE2)
+         // Four rectangles per iteration, transposed to { x, y, w, h } lanes
+         const __m128 a = _mm_set1_ps(m._a), b = _mm_set1_ps(m._b), c = _mm_set1_ps(m._c), d = _mm_set1_ps(m._d);
+         const __m128 tx = _mm_set1_ps(m._tx), ty = _mm_set1_ps(m._ty);
+         const __m128 zero = _mm_setzero_ps();
+         for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(&rects[i * 4]);
+            __m128 y = _mm_loadu_ps(&rects[i * 4 + 4]);
+            __m128 w = _mm_loadu_ps(&rects[i * 4 + 8]);
+            __m128 h = _mm_loadu_ps(&rects[i * 4 + 12]);
+            _MM_TRANSPOSE4_PS(x, y, w, h);
+            
+            __m128 px = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x), _mm_mul_ps(c, y)), tx);
+            __m128 py = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b, x), _mm_mul_ps(d, y)), ty);
+            __m128 wx = _mm_mul_ps(a, w), wy = _mm_mul_ps(b, w);
+            __m128 hx = _mm_mul_ps(c, h), hy = _mm_mul_ps(d, h);
+            
+            __m128 minX = _mm_add_ps(px, _mm_add_ps(_mm_min_ps(wx, zero), _mm_min_ps(hx, zero)));
+            __m128 minY = _mm_add_ps(py, _mm_add_ps(_mm_min_ps(wy, zero), _mm_min_ps(hy, zero)));
+            __m128 width = _mm_add_ps(_mm_max_ps(wx, _mm_sub_ps(zero, wx)), _mm_max_ps(hx, _mm_sub_ps(zero, hx)));
+            __m128 height = _mm_add_ps(_mm_max_ps(wy, _mm_sub_ps(zero, wy)), _mm_max_ps(hy, _mm_sub_ps(zero, hy)));
+            
+            _MM_TRANSPOSE4_PS(minX, minY, width, height);
+            _mm_storeu_ps(&out[i * 4], minX);
+            _mm_storeu_ps(&out[i * 4 + 4], minY);
+            _mm_storeu_ps(&out[i * 4 + 8], width);
+            _mm_storeu_ps(&out[i * 4 + 12], height);
+         }
+#elif defined(FLAIR_SIMD_NEON)
+         const float32x4_t a = vdupq_n_f32(m._a), b = vdupq_n_f32(m._b), c = vdupq_n_f32(m._c), d = vdupq_n_f32(m._d);
+         const float32x4_t tx = vdupq_n_f32(m._tx), ty = vdupq_n_f32(m._ty);
+         const float32x4_t zero = vdupq_n_f32(0.0f);
+         for (; i + 4 <= count; i += 4) {
+            float32x4x4_t r = vld4q_f32(&rects[i * 4]); // de-interleaves into x, y, w, h lanes
+            
+            float32x4_t px = vaddq_f32(vaddq_f32(vmulq_f32(a, r.val[0]), vmulq_f32(c, r.val[1])), tx);
+            float32x4_t py = vaddq_f32(vaddq_f32(vmulq_f32(b, r.val[0]), vmulq_f32(d, r.val[1])), ty);
+            float32x4_t wx = vmulq_f32(a, r.val[2]), wy = vmulq_f32(b, r.val[2]);
+            float32x4_t hx = vmulq_f32(c, r.val[3]), hy = vmulq_f32(d, r.val[3]);
+            
+            float32x4x4_t bounds;
+            bounds.val[0] = vaddq_f32(px, vaddq_f32(vminq_f32(wx, zero), vminq_f32(hx, zero)));
+            bounds.val[1] = vaddq_f32(py, vaddq_f32(vminq_f32(wy, zero), vminq_f32(hy, zero)));
+            bounds.val[2] = vaddq_f32(vabsq_f32(wx), vabsq_f32(hx));
+            bounds.val[3] = vaddq_f32(vabsq_f32(wy), vabsq_f32(hy));
+            vst4q_f32(&out[i * 4], bounds);
+         }
+#endif
          
-         return *this;
+         for (; i < count; ++i) {
+            float x = rects[i * 4], y = rects[i * 4 + 1], w = rects[i * 4 + 2], h = rects[i * 4 + 3];
+            
+            float px = (m._a * x + m._c * y) + m._tx;
+            float py = (m._b * x + m._d * y) + m._ty;
+            float wx = m._a * w, wy = m._b * w;
+            float hx = m._c * h, hy = m._d * h;
+            
+            out[i * 4] = px + (std::min(wx, 0.0f) + std::min(hx, 0.0f));
+            out[i * 4 + 1] = py + (std::min(wy, 0.0f) + std::min(hy, 0.0f));
+            out[i * 4 + 2] = std::abs(wx) + std::abs(hx);
+            out[i * 4 + 3] = std::abs(wy) + std::abs(hy);
+         }
+      }
+      
+      void Matrix::concat(Matrix const* parents, Matrix const* children, Matrix * out, size_t count)
+      {
+         for (size_t i = 0; i < count; ++i) {
+            const Matrix & p = parents[i];
+            const Matrix & c = children[i];
+            
+#if defined(FLAIR_SIMD_SSE2)
+            // [a, b, c, d] = [pa, pb, pa, pb] * [ca, ca, cc, cc] + [pc, pd, pc, pd] * [cb, cb, cd, cd]
+            __m128 pm = _mm_loadu_ps(&p._a);
+            __m128 cm = _mm_loadu_ps(&c._a);
+            __m128 pab = _mm_shuffle_ps(pm, pm, _MM_SHUFFLE(1, 0, 1, 0));
+            __m128 pcd = _mm_shuffle_ps(pm, pm, _MM_SHUFFLE(3, 2, 3, 2));
+            __m128 cx = _mm_shuffle_ps(cm, cm, _MM_SHUFFLE(2, 2, 0, 0));
+            __m128 cy = _mm_shuffle_ps(cm, cm, _MM_SHUFFLE(3, 3, 1, 1));
+            __m128 abcd = _mm_add_ps(_mm_mul_ps(pab, cx), _mm_mul_ps(pcd, cy));
+            
+            float tx = (p._a * c._tx + p._c * c._ty) + p._tx;
+            float ty = (p._b * c._tx + p._d * c._ty) + p._ty;
+            _mm_storeu_ps(&out[i]._a, abcd);
+            out[i]._tx = tx;
+            out[i]._ty = ty;
+#else
+            out[i] = p * c;
+#endif
+         }
       }
       
       const Matrix Matrix::operator*(const Matrix & rhs) const
       {
-         Matrix ret = *this;
-         
-         ret._a  = this->_a * rhs._a  + this->_c * rhs._b  + this->_tx * rhs._u;
-         ret._c  = this->_a * rhs._c  + this->_c * rhs._d  + this->_tx * rhs._v;
-         ret._tx = this->_a * rhs._tx + this->_c * rhs._ty + this->_tx * rhs._w;
+         Matrix ret;
          
-         ret._b  = this->_b * rhs._a  + this->_d * rhs._b  + this->_ty * rhs._u;
-         ret._d  = this->_b * rhs._c  + this->_d * rhs._d  + this->_ty * rhs._v;
-         ret._ty = this->_b * rhs._tx + this->_d * rhs._ty + this->_ty * rhs._w;
+         ret._a  = this->_a * rhs._a  + this->_c * rhs._b;
+         ret._c  = this->_a * rhs._c  + this->_c * rhs._d;
+         ret._tx = this->_a * rhs._tx + this->_c * rhs._ty + this->_tx;
          
-         ret._u  = this->_u * rhs._a  + this->_v * rhs._b  + this->_w * rhs._u;
-         ret._v  = this->_u * rhs._c  + this->_v * rhs._d  + this->_w * rhs._v;
-         ret._w  = this->_u * rhs._tx + this->_v * rhs._ty + this->_w * rhs._w;
+         ret._b  = this->_b * rhs._a  + this->_d * rhs._b;
+         ret._d  = this->_b * rhs._c  + this->_d * rhs._d;
+         ret._ty = this->_b * rhs._tx + this->_d * rhs._ty + this->_ty;
          
          return ret;
       }
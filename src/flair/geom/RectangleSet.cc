@@ -0,0 +1,284 @@
+#include "flair/geom/Point.h"
+#include "flair/geom/Rectangle.h"
+#include "flair/geom/RectangleSet.h"
+#include "flair/internal/utils/SIMD.h"
+
+namespace {
+   
+   // Every query kernel exposes test(i) for a single rectangle and, when a vector unit is
+   // available, test4(i) returning a 4 bit mask for rectangles i to i + 3.
+
+#if defined(FLAIR_SIMD_NEON)
+   inline unsigned int movemask(uint32x4_t cmp)
+   {
+      static const uint32_t weights[4] = { 1, 2, 4, 8 };
+      uint32x4_t bits = vandq_u32(cmp, vld1q_u32(weights));
+      uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+      return vget_lane_u32(vpadd_u32(sum, sum), 0);
+   }
+#endif
+   
+   struct IntersectsKernel
+   {
+      const float * left;
+      const float * top;
+      const float * right;
+      const float * bottom;
+      float boundsLeft, boundsTop, boundsRight, boundsBottom;
+#if defined(FLAIR_SIMD_SSE2)
+      __m128 vLeft, vTop, vRight, vBottom;
+#elif defined(FLAIR_SIMD_NEON)
+      float32x4_t vLeft, vTop, vRight, vBottom;
+#endif
+      
+      IntersectsKernel(const flair::geom::RectangleSet & set, const flair::geom::Rectangle & bounds)
+         : left(set.lefts()), top(set.tops()), right(set.rights()), bottom(set.bottoms()),
+           boundsLeft(bounds.left()), boundsTop(bounds.top()), boundsRight(bounds.right()), boundsBottom(bounds.bottom())
+      {
+#if defined(FLAIR_SIMD_SSE2)
+         vLeft = _mm_set1_ps(boundsLeft);
+         vTop = _mm_set1_ps(boundsTop);
+         vRight = _mm_set1_ps(boundsRight);
+         vBottom = _mm_set1_ps(boundsBottom);
+#elif defined(FLAIR_SIMD_NEON)
+         vLeft = vdupq_n_f32(boundsLeft);
+         vTop = vdupq_n_f32(boundsTop);
+         vRight = vdupq_n_f32(boundsRight);
+         vBottom = vdupq_n_f32(boundsBottom);
+#endif
+      }
+      
+      bool test(size_t i) const
+      {
+         return left[i] < boundsRight && boundsLeft < right[i] && top[i] < boundsBottom && boundsTop < bottom[i];
+      }
+
+#if defined(FLAIR_SIMD_SSE2)
+      unsigned int test4(size_t i) const
+      {
+         __m128 x = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(&left[i]), vRight), _mm_cmplt_ps(vLeft, _mm_loadu_ps(&right[i])));
+         __m128 y = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(&top[i]), vBottom), _mm_cmplt_ps(vTop, _mm_loadu_ps(&bottom[i])));
+         return _mm_movemask_ps(_mm_and_ps(x, y));
+      }
+#elif defined(FLAIR_SIMD_NEON)
+      unsigned int test4(size_t i) const
+      {
+         uint32x4_t x = vandq_u32(vcltq_f32(vld1q_f32(&left[i]), vRight), vcltq_f32(vLeft, vld1q_f32(&right[i])));
+         uint32x4_t y = vandq_u32(vcltq_f32(vld1q_f32(&top[i]), vBottom), vcltq_f32(vTop, vld1q_f32(&bottom[i])));
+         return movemask(vandq_u32(x, y));
+      }
+#endif
+   };
+   
+   struct ContainsKernel
+   {
+      const float * left;
+      const float * top;
+      const float * right;
+      const float * bottom;
+      float x, y;
+#if defined(FLAIR_SIMD_SSE2)
+      __m128 vX, vY;
+#elif defined(FLAIR_SIMD_NEON)
+      float32x4_t vX, vY;
+#endif
+      
+      ContainsKernel(const flair::geom::RectangleSet & set, const flair::geom::Point & p)
+         : left(set.lefts()), top(set.tops()), right(set.rights()), bottom(set.bottoms()), x(p.x()), y(p.y())
+      {
+#if defined(FLAIR_SIMD_SSE2)
+         vX = _mm_set1_ps(x);
+         vY = _mm_set1_ps(y);
+#elif defined(FLAIR_SIMD_NEON)
+         vX = vdupq_n_f32(x);
+         vY = vdupq_n_f32(y);
+#endif
+      }
+      
+      bool test(size_t i) const
+      {
+         return x >= left[i] && y >= top[i] && x <= right[i] && y <= bottom[i];
+      }
+
+#if defined(FLAIR_SIMD_SSE2)
+      unsigned int test4(size_t i) const
+      {
+         __m128 inX = _mm_and_ps(_mm_cmpge_ps(vX, _mm_loadu_ps(&left[i])), _mm_cmple_ps(vX, _mm_loadu_ps(&right[i])));
+         __m128 inY = _mm_and_ps(_mm_cmpge_ps(vY, _mm_loadu_ps(&top[i])), _mm_cmple_ps(vY, _mm_loadu_ps(&bottom[i])));
+         return _mm_movemask_ps(_mm_and_ps(inX, inY));
+      }
+#elif defined(FLAIR_SIMD_NEON)
+      unsigned int test4(size_t i) const
+      {
+         uint32x4_t inX = vandq_u32(vcgeq_f32(vX, vld1q_f32(&left[i])), vcleq_f32(vX, vld1q_f32(&right[i])));
+         uint32x4_t inY = vandq_u32(vcgeq_f32(vY, vld1q_f32(&top[i])), vcleq_f32(vY, vld1q_f32(&bottom[i])));
+         return movemask(vandq_u32(inX, inY));
+      }
+#endif
+   };
+   
+   template <typename Kernel>
+   void fillMask(const Kernel & kernel, size_t count, std::vector<uint64_t> & mask)
+   {
+      mask.assign((count + 63) / 64, 0);
+      size_t i = 0;
+
+#if defined(FLAIR_SIMD_SSE2) || defined(FLAIR_SIMD_NEON)
+      // Four lanes never straddle a word since 64 is a multiple of 4
+      for (; i + 4 <= count; i += 4) {
+         mask[i >> 6] |= uint64_t(kernel.test4(i)) << (i & 63);
+      }
+#endif
+      
+      for (; i < count; ++i) {
+         if (kernel.test(i)) {
+            mask[i >> 6] |= uint64_t(1) << (i & 63);
+         }
+      }
+   }
+   
+   template <typename Kernel>
+   size_t fillIndices(const Kernel & kernel, size_t count, std::vector<uint32_t> & indices)
+   {
+      size_t start = indices.size();
+      size_t i = 0;
+
+#if defined(FLAIR_SIMD_SSE2) || defined(FLAIR_SIMD_NEON)
+      for (; i + 4 <= count; i += 4) {
+         unsigned int bits = kernel.test4(i);
+         for (unsigned int lane = 0; bits != 0; ++lane, bits >>= 1) {
+            if (bits & 1) {
+               indices.push_back(static_cast<uint32_t>(i + lane));
+            }
+         }
+      }
+#endif
+      
+      for (; i < count; ++i) {
+         if (kernel.test(i)) {
+            indices.push_back(static_cast<uint32_t>(i));
+         }
+      }
+      
+      return indices.size() - start;
+   }
+}
+
+namespace flair {
+   namespace geom {
+      
+      RectangleSet::RectangleSet() {}
+      
+      size_t RectangleSet::size() const
+      {
+         return _left.size();
+      }
+      
+      bool RectangleSet::empty() const
+      {
+         return _left.empty();
+      }
+      
+      float const* RectangleSet::lefts() const
+      {
+         return _left.data();
+      }
+      
+      float const* RectangleSet::tops() const
+      {
+         return _top.data();
+      }
+      
+      float const* RectangleSet::rights() const
+      {
+         return _right.data();
+      }
+      
+      float const* RectangleSet::bottoms() const
+      {
+         return _bottom.data();
+      }
+      
+      uint32_t RectangleSet::add(float x, float y, float width, float height)
+      {
+         _left.push_back(x);
+         _top.push_back(y);
+         _right.push_back(x + width);
+         _bottom.push_back(y + height);
+         
+         return static_cast<uint32_t>(_left.size() - 1);
+      }
+      
+      uint32_t RectangleSet::add(const Rectangle & r)
+      {
+         return add(r.x(), r.y(), r.width(), r.height());
+      }
+      
+      void RectangleSet::set(uint32_t index, float x, float y, float width, float height)
+      {
+         _left[index] = x;
+         _top[index] = y;
+         _right[index] = x + width;
+         _bottom[index] = y + height;
+      }
+      
+      void RectangleSet::set(uint32_t index, const Rectangle & r)
+      {
+         set(index, r.x(), r.y(), r.width(), r.height());
+      }
+      
+      Rectangle RectangleSet::rectangle(uint32_t index) const
+      {
+         return Rectangle(_left[index], _top[index], _right[index] - _left[index], _bottom[index] - _top[index]);
+      }
+      
+      void RectangleSet::removeAt(uint32_t index)
+      {
+         _left[index] = _left.back();
+         _top[index] = _top.back();
+         _right[index] = _right.back();
+         _bottom[index] = _bottom.back();
+         
+         _left.pop_back();
+         _top.pop_back();
+         _right.pop_back();
+         _bottom.pop_back();
+      }
+      
+      void RectangleSet::clear()
+      {
+         _left.clear();
+         _top.clear();
+         _right.clear();
+         _bottom.clear();
+      }
+      
+      void RectangleSet::reserve(size_t capacity)
+      {
+         _left.reserve(capacity);
+         _top.reserve(capacity);
+         _right.reserve(capacity);
+         _bottom.reserve(capacity);
+      }
+      
+      void RectangleSet::intersectingMask(const Rectangle & bounds, std::vector<uint64_t> & mask) const
+      {
+         fillMask(IntersectsKernel(*this, bounds), size(), mask);
+      }
+      
+      size_t RectangleSet::intersecting(const Rectangle & bounds, std::vector<uint32_t> & indices) const
+      {
+         return fillIndices(IntersectsKernel(*this, bounds), size(), indices);
+      }
+      
+      void RectangleSet::containingMask(const Point & p, std::vector<uint64_t> & mask) const
+      {
+         fillMask(ContainsKernel(*this, p), size(), mask);
+      }
+      
+      size_t RectangleSet::containing(const Point & p, std::vector<uint32_t> & indices) const
+      {
+         return fillIndices(ContainsKernel(*this, p), size(), indices);
+      }
+   }
+}
@@ -0,0 +1,269 @@
+#include "flair/internal/input/InputLog.h"
+#include "flair/utils/ByteArray.h"
+#include "flair/internal/services/IKeyboardService.h"
+#include "flair/internal/services/IMouseService.h"
+#include "flair/internal/services/IGamepadService.h"
+#include "flair/internal/services/ITouchService.h"
+
+namespace {
+   const uint32_t MAGIC = 0x474C4946; // "FILG"
+   const uint16_t VERSION = 1;
+   
+   // Record tags, each frame starts with FRAME and runs until the next one
+   enum : uint8_t {
+      FRAME = 1,
+      KEY,
+      BUTTON,
+      MOTION,
+      GAMEPAD,
+      TOUCH
+   };
+   
+   // Bytes after the tag, 0 for an unknown tag
+   size_t recordLength(uint8_t tag)
+   {
+      switch (tag) {
+         case FRAME: return 12;
+         case KEY: return 11;
+         case BUTTON: return 15;
+         case MOTION: return 20;
+         case GAMEPAD: return 11;
+         case TOUCH: return 25;
+         default: return 0;
+      }
+   }
+}
+
+namespace flair {
+namespace internal {
+namespace input {
+   
+   using flair::utils::ByteArray;
+   using flair::utils::Endian;
+   using namespace flair::internal::services;
+   
+   InputLog::InputLog(std::shared_ptr<ByteArray> bytes) : _bytes(bytes), _frames(0)
+   {
+      _bytes->endian(Endian::LITTLE_ENDIAN_ORDER);
+   }
+   
+   std::shared_ptr<ByteArray> InputLog::bytes() const
+   {
+      return _bytes;
+   }
+   
+   uint64_t InputLog::frames() const
+   {
+      return _frames;
+   }
+   
+   void InputLog::begin()
+   {
+      _bytes->writeUnsignedInt(MAGIC);
+      _bytes->writeUnsignedShort(VERSION);
+      _frames = 0;
+   }
+   
+   bool InputLog::open()
+   {
+      _frames = 0;
+      if (_bytes->bytesAvailable() < 6) return false;
+      
+      uint32_t magic = _bytes->readUnsignedInt();
+      uint16_t version = _bytes->readUnsignedShort();
+      return magic == MAGIC && version == VERSION;
+   }
+   
+   void InputLog::record(float deltaSeconds, IKeyboardService * keyboardService, IMouseService * mouseService, IGamepadService * gamepadService, ITouchService * touchService)
+   {
+      int mouseX = 0, mouseY = 0;
+      if (mouseService) mouseService->location(&mouseX, &mouseY);
+      
+      _bytes->writeUnsignedByte(FRAME);
+      _bytes->writeFloat(deltaSeconds);
+      _bytes->writeInt(mouseX);
+      _bytes->writeInt(mouseY);
+      
+      if (keyboardService) {
+         keyboardService->transitions([&](const IKeyboardService::KeyTransition & key) {
+            _bytes->writeUnsignedByte(KEY);
+            _bytes->writeUnsignedShort((uint16_t)key.keyCode);
+            _bytes->writeByte((int8_t)key.state);
+            _bytes->writeUnsignedInt(key.timestamp);
+            _bytes->writeByte((int8_t)key.shift);
+            _bytes->writeByte((int8_t)key.alt);
+            _bytes->writeByte((int8_t)key.ctrl);
+            _bytes->writeByte((int8_t)key.os);
+         });
+      }
+      
+      if (mouseService) {
+         mouseService->buttonTransitions([&](const IMouseService::ButtonTransition & button) {
+            _bytes->writeUnsignedByte(BUTTON);
+            _bytes->writeUnsignedByte((uint8_t)button.buttonCode);
+            _bytes->writeByte((int8_t)button.state);
+            _bytes->writeByte((int8_t)button.previousState);
+            _bytes->writeUnsignedInt(button.timestamp);
+            _bytes->writeInt(button.X);
+            _bytes->writeInt(button.Y);
+         });
+         
+         flair::events::MouseEvent::Sample const* samples = nullptr;
+         size_t sampleCount = 0;
+         mouseService->history(&samples, &sampleCount);
+         for (size_t i = 0; i < sampleCount; ++i) {
+            _bytes->writeUnsignedByte(MOTION);
+            _bytes->writeInt((int32_t)samples[i].localX);
+            _bytes->writeInt((int32_t)samples[i].localY);
+            _bytes->writeInt((int32_t)samples[i].movementX);
+            _bytes->writeInt((int32_t)samples[i].movementY);
+            _bytes->writeUnsignedInt(samples[i].timestamp);
+         }
+      }
+      
+      if (gamepadService) {
+         gamepadService->transitions([&](const GamepadTransition & transition) {
+            _bytes->writeUnsignedByte(GAMEPAD);
+            _bytes->writeUnsignedByte((uint8_t)transition.type);
+            _bytes->writeUnsignedByte((uint8_t)transition.device);
+            _bytes->writeUnsignedByte((uint8_t)transition.code);
+            _bytes->writeFloat(transition.value);
+            _bytes->writeUnsignedInt(transition.timestamp);
+         });
+      }
+      
+      if (touchService) {
+         TouchPoint const* points = nullptr;
+         size_t pointCount = 0;
+         touchService->points(&points, &pointCount);
+         for (size_t i = 0; i < pointCount; ++i) {
+            _bytes->writeUnsignedByte(TOUCH);
+            _bytes->writeLong(points[i].touchId);
+            _bytes->writeUnsignedByte((uint8_t)points[i].phase);
+            _bytes->writeFloat(points[i].X);
+            _bytes->writeFloat(points[i].Y);
+            _bytes->writeFloat(points[i].pressure);
+            _bytes->writeUnsignedInt(points[i].timestamp);
+         }
+      }
+      
+      ++_frames;
+   }
+   
+   bool InputLog::wholeFrame()
+   {
+      size_t position = _bytes->position();
+      size_t length = _bytes->length();
+      
+      for (size_t record = position; record < length; ) {
+         _bytes->position(record);
+         uint8_t tag = _bytes->readUnsignedByte();
+         if ((tag == FRAME) != (record == position)) break;
+         
+         size_t recordEnd = record + 1 + recordLength(tag);
+         if (recordEnd == record + 1 || recordEnd > length) {
+            _bytes->position(position);
+            return false;
+         }
+         record = recordEnd;
+      }
+      
+      _bytes->position(position);
+      return position < length;
+   }
+   
+   bool InputLog::replay(float * deltaSeconds, IKeyboardService * keyboardService, IMouseService * mouseService, IGamepadService * gamepadService, ITouchService * touchService)
+   {
+      // A log cut off while it was written, by a crash or a full disk, ends at its last whole
+      // frame rather than reading past the end
+      if (!wholeFrame()) {
+         _bytes->position(_bytes->length());
+         return false;
+      }
+      if (_bytes->readUnsignedByte() != FRAME) return false;
+      
+      if (keyboardService) keyboardService->clear();
+      if (mouseService) mouseService->clear();
+      if (gamepadService) gamepadService->clear();
+      if (touchService) touchService->clear();
+      
+      *deltaSeconds = _bytes->readFloat();
+      int mouseX = _bytes->readInt();
+      int mouseY = _bytes->readInt();
+      
+      while (_bytes->bytesAvailable() > 0) {
+         uint8_t tag = _bytes->readUnsignedByte();
+         switch (tag) {
+            case KEY: {
+               IKeyboardService::KeyTransition key;
+               key.keyCode = _bytes->readUnsignedShort();
+               key.state = _bytes->readByte();
+               key.timestamp = _bytes->readUnsignedInt();
+               key.shift = _bytes->readByte();
+               key.alt = _bytes->readByte();
+               key.ctrl = _bytes->readByte();
+               key.os = _bytes->readByte();
+               if (keyboardService) keyboardService->replay(key);
+            } break;
+               
+            case BUTTON: {
+               IMouseService::ButtonTransition button;
+               button.buttonCode = _bytes->readUnsignedByte();
+               button.state = _bytes->readByte();
+               button.previousState = _bytes->readByte();
+               button.timestamp = _bytes->readUnsignedInt();
+               button.X = _bytes->readInt();
+               button.Y = _bytes->readInt();
+               if (mouseService) mouseService->replay(button);
+            } break;
+               
+            case MOTION: {
+               int X = _bytes->readInt();
+               int Y = _bytes->readInt();
+               int movementX = _bytes->readInt();
+               int movementY = _bytes->readInt();
+               uint32_t timestamp = _bytes->readUnsignedInt();
+               if (mouseService) mouseService->motion(X, Y, movementX, movementY, timestamp);
+            } break;
+               
+            case GAMEPAD: {
+               GamepadTransition transition;
+               transition.type = _bytes->readUnsignedByte();
+               transition.device = _bytes->readUnsignedByte();
+               transition.code = _bytes->readUnsignedByte();
+               transition.value = _bytes->readFloat();
+               transition.timestamp = _bytes->readUnsignedInt();
+               if (gamepadService) gamepadService->replay(transition);
+            } break;
+               
+            case TOUCH: {
+               int64_t touchId = _bytes->readLong();
+               int phase = _bytes->readUnsignedByte();
+               float X = _bytes->readFloat();
+               float Y = _bytes->readFloat();
+               float pressure = _bytes->readFloat();
+               uint32_t timestamp = _bytes->readUnsignedInt();
+               if (touchService) touchService->touch(touchId, phase, X, Y, pressure, timestamp);
+            } break;
+               
+            case FRAME: {
+               // Start of the next frame, leave it for the next call
+               _bytes->position(_bytes->position() - 1);
+               if (mouseService) mouseService->location(mouseX, mouseY);
+               ++_frames;
+               return true;
+            }
+               
+            default:
+               // Unknown record, the rest of the log cannot be trusted
+               _bytes->position(_bytes->length());
+               return false;
+         }
+      }
+      
+      if (mouseService) mouseService->location(mouseX, mouseY);
+      ++_frames;
+      return true;
+   }
+   
+}}}
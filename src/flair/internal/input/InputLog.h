@@ -0,0 +1,60 @@
+#ifndef flair_internal_input_InputLog_h
+#define flair_internal_input_InputLog_h
+
+#include <cstdint>
+#include <memory>
+
+namespace flair { namespace utils { class ByteArray; } }
+
+namespace flair {
+namespace internal {
+   
+   namespace services {
+      class IKeyboardService;
+      class IMouseService;
+      class IGamepadService;
+      class ITouchService;
+   }
+   
+namespace input {
+   
+   // A compact binary log of the input transitions of each frame together with its frame delta.
+   //
+   // Recording reads what the services collected during the frame, replaying clears the services
+   // and writes the transitions back in the same order, so the dispatch code cannot tell the two
+   // apart. Any service may be null, its records are then skipped. The log is little endian.
+   class InputLog
+   {
+   public:
+      InputLog(std::shared_ptr<flair::utils::ByteArray> bytes);
+      
+   // Properties
+   public:
+      std::shared_ptr<flair::utils::ByteArray> bytes() const;
+      
+      uint64_t frames() const;
+      
+   // Methods
+   public:
+      // Writes the log header at the current position
+      void begin();
+      
+      // Checks the log header at the current position, returns false if this is not a log
+      bool open();
+      
+      void record(float deltaSeconds, services::IKeyboardService * keyboardService, services::IMouseService * mouseService, services::IGamepadService * gamepadService, services::ITouchService * touchService);
+      
+      // Feeds the next frame into the services, returns false once the log is exhausted
+      bool replay(float * deltaSeconds, services::IKeyboardService * keyboardService, services::IMouseService * mouseService, services::IGamepadService * gamepadService, services::ITouchService * touchService);
+      
+   protected:
+      // Whether the frame at the current position is complete and made of known records
+      bool wholeFrame();
+      
+      std::shared_ptr<flair::utils::ByteArray> _bytes;
+      uint64_t _frames;
+   };
+   
+}}}
+
+#endif
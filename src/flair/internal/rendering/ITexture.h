@@ -2,6 +2,7 @@
 #define flair_internal_rendering_ITexture_h
 
 #include "flair/geom/Rectangle.h"
+#include "flair/system/Memory.h"
 
 #include <cstdint>
 
@@ -32,6 +33,10 @@ namespace rendering {
       };
       
       
+   public:
+      virtual ~ITexture() {}
+      
+      
    // Properties
    public:
       virtual int width() = 0;
@@ -55,6 +60,23 @@ namespace rendering {
       virtual void lock() = 0;
       
       virtual void unlock() = 0;
+      
+      
+   // Internal
+   protected:
+      // Counts what a texture holds on the renderer per format, BGR is padded to 32 bits and
+      // BGRA_PACKED is 16 bit ARGB1555
+      static void account(int width, int height, PixelFormat format, int count)
+      {
+         static flair::system::MemoryCounter * counters[] = {
+            new flair::system::MemoryCounter(flair::system::MemoryCategory::TEXTURE, "BGRA textures"),
+            new flair::system::MemoryCounter(flair::system::MemoryCategory::TEXTURE, "BGRA_PACKED textures"),
+            new flair::system::MemoryCounter(flair::system::MemoryCategory::TEXTURE, "BGR textures")
+         };
+         
+         int64_t bytesPerPixel = format == PixelFormat::BGRA_PACKED ? 2 : 4;
+         counters[static_cast<int>(format)]->add(count, count * bytesPerPixel * width * height);
+      }
    };
    
 }}}
@@ -0,0 +1,88 @@
+#include "flair/internal/rendering/capture/Texture.h"
+#include "flair/internal/services/capture/RenderService.h"
+
+namespace flair {
+namespace internal {
+namespace rendering {
+namespace capture {
+   
+   Texture::Texture(services::capture::RenderService * service, ITexture * target, uint32_t id, PixelFormat format) : _service(service),
+      _target(target), _id(id), _format(format)
+   {
+      
+   }
+   
+   Texture::~Texture()
+   {
+      
+   }
+   
+   int Texture::width()
+   {
+      return _target->width();
+   }
+   
+   int Texture::height()
+   {
+      return _target->height();
+   }
+   
+   float Texture::alpha()
+   {
+      return _target->alpha();
+   }
+   
+   float Texture::alpha(float value)
+   {
+      _service->textureAlpha(this, value);
+      return _target->alpha(value);
+   }
+   
+   ITexture::BlendMode Texture::blend()
+   {
+      return _target->blend();
+   }
+   
+   ITexture::BlendMode Texture::blend(ITexture::BlendMode value)
+   {
+      _service->textureBlend(this, value);
+      return _target->blend(value);
+   }
+   
+   ITexture::Type Texture::type()
+   {
+      return _target->type();
+   }
+   
+   ITexture * Texture::target()
+   {
+      return _target;
+   }
+   
+   uint32_t Texture::id()
+   {
+      return _id;
+   }
+   
+   ITexture::PixelFormat Texture::format()
+   {
+      return _format;
+   }
+   
+   void Texture::update(geom::Rectangle rect, uint8_t const* pixels)
+   {
+      _service->textureUpdate(this, rect, pixels);
+      _target->update(rect, pixels);
+   }
+   
+   void Texture::lock()
+   {
+      _target->lock();
+   }
+   
+   void Texture::unlock()
+   {
+      _target->unlock();
+   }
+   
+}}}}
@@ -0,0 +1,57 @@
+#ifndef flair_internal_rendering_capture_Texture_h
+#define flair_internal_rendering_capture_Texture_h
+
+#include "flair/internal/rendering/ITexture.h"
+
+namespace flair { namespace internal { namespace services { namespace capture { class RenderService; }}}}
+
+namespace flair {
+namespace internal {
+namespace rendering {
+namespace capture {
+   
+   // Forwards to the texture of the captured backend and reports state changes to the capture
+   class Texture : public ITexture
+   {
+   public:
+      Texture(services::capture::RenderService * service, ITexture * target, uint32_t id, PixelFormat format);
+      virtual ~Texture();
+      
+   // Properties
+   public:
+      int width() override;
+      
+      int height() override;
+      
+      float alpha() override;
+      float alpha(float value) override;
+      
+      BlendMode blend() override;
+      BlendMode blend(BlendMode value) override;
+      
+      Type type() override;
+      
+      ITexture * target();
+      
+      uint32_t id();
+      
+      PixelFormat format();
+      
+   // Methods
+   public:
+      void update(geom::Rectangle rect, uint8_t const* pixels) override;
+      
+      void lock() override;
+      
+      void unlock() override;
+      
+   protected:
+      services::capture::RenderService * _service;
+      ITexture * _target;
+      uint32_t _id;
+      PixelFormat _format;
+   };
+   
+}}}}
+
+#endif
@@ -0,0 +1,69 @@
+#include "flair/internal/rendering/null/Texture.h"
+
+namespace flair {
+namespace internal {
+namespace rendering {
+namespace null {
+   
+   Texture::Texture(int width, int height, PixelFormat format, Type type) : _width(width), _height(height), _format(format), _type(type),
+      _alpha(1.0f), _blend(BlendMode::ALPHA)
+   {
+      account(_width, _height, _format, 1);
+   }
+   
+   Texture::~Texture()
+   {
+      account(_width, _height, _format, -1);
+   }
+   
+   int Texture::width()
+   {
+      return _width;
+   }
+   
+   int Texture::height()
+   {
+      return _height;
+   }
+   
+   float Texture::alpha()
+   {
+      return _alpha;
+   }
+   
+   float Texture::alpha(float value)
+   {
+      return _alpha = value;
+   }
+   
+   ITexture::BlendMode Texture::blend()
+   {
+      return _blend;
+   }
+   
+   ITexture::BlendMode Texture::blend(ITexture::BlendMode value)
+   {
+      return _blend = value;
+   }
+   
+   ITexture::Type Texture::type()
+   {
+      return _type;
+   }
+   
+   void Texture::update(geom::Rectangle rect, uint8_t const* pixels)
+   {
+      
+   }
+   
+   void Texture::lock()
+   {
+      
+   }
+   
+   void Texture::unlock()
+   {
+      
+   }
+   
+}}}}
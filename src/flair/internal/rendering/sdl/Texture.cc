@@ -11,12 +11,12 @@ namespace sdl {
       _width(width), _height(height), _format(format), _type(type)
    
    {
-      
+      account(_width, _height, _format, 1);
    }
    
    Texture::~Texture()
    {
-      
+      account(_width, _height, _format, -1);
    }
    
    int Texture::width()
@@ -64,14 +64,17 @@ namespace sdl {
       SDL_Rect textureRect;
       textureRect.w = rect.width();
       textureRect.h = rect.height();
-      textureRect.x = textureRect.y = 0;
+      textureRect.x = rect.x();
+      textureRect.y = rect.y();
       
+      // Rows are as wide as the texture, the rect starts that many pixels into the first
       int pitch = 0;
-      if (_format == ITexture::PixelFormat::BGR) pitch = (_width + 7) * 3;
-      if (_format == ITexture::PixelFormat::BGRA) pitch = _width * 4;
-      if (_format == ITexture::PixelFormat::BGRA_PACKED) pitch = _width * 4;
+      int bytesPerPixel = 0;
+      if (_format == ITexture::PixelFormat::BGR) { pitch = (_width + 7) * 3; bytesPerPixel = 3; }
+      if (_format == ITexture::PixelFormat::BGRA) { pitch = _width * 4; bytesPerPixel = 4; }
+      if (_format == ITexture::PixelFormat::BGRA_PACKED) { pitch = _width * 4; bytesPerPixel = 4; }
       
-      SDL_UpdateTexture(_texture, &textureRect, pixels, pitch);
+      SDL_UpdateTexture(_texture, &textureRect, pixels + textureRect.x * bytesPerPixel, pitch);
    }
    
    void Texture::lock()
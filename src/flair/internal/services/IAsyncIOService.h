@@ -4,6 +4,7 @@
 #include "flair/flair.h"
 #include "flair/events/EventDispatcher.h"
 #include "flair/events/Event.h"
+#include "flair/system/IOStats.h"
 
 namespace flair {
 namespace internal {
@@ -28,6 +29,16 @@ namespace services {
          WORKER
       };
       
+      // Nanoseconds on the steady clock, 0 until the request got there. Each is written by the
+      // thread holding the request at the time.
+      struct Timestamps
+      {
+         uint64_t enqueued;
+         uint64_t started;
+         uint64_t completed;
+         uint64_t delivered;
+      };
+      
    // Properties
    public:
       virtual Type type() = 0;
@@ -40,6 +51,9 @@ namespace services {
       
       virtual bool complete() = 0;
       virtual bool complete(bool value) = 0;
+      
+      virtual Timestamps timestamps() = 0;
+      virtual Timestamps timestamps(Timestamps value) = 0;
    };
    
    class IAsyncFileRequest : public IAsyncIORequest
@@ -128,11 +142,23 @@ namespace services {
    
    class IAsyncIOService : public flair::events::IEventDispatcher
    {
+   // Properties
+   public:
+      // Fills in the queue depths, throughput and per request type latencies of stats, from the
+      // main thread
+      virtual void stats(flair::system::IOStats & stats) = 0;
+      
    // Methods
    public:
       virtual void enqueue(std::shared_ptr<IAsyncIORequest> request) = 0;
       
       virtual void poll() = 0;
+      
+      // Called on the I/O thread whenever a request is handed back, so a waiting main loop
+      // can wake up for poll. Set before the first enqueue.
+      virtual void notify(std::function<void()> callback) = 0;
+      
+      virtual void resetStats() = 0;
    };
 
 }}}
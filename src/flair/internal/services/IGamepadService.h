@@ -1,13 +1,72 @@
 #ifndef flair_internal_services_IGamepadService_h
 #define flair_internal_services_IGamepadService_h
 
+#include <cstdint>
+#include <functional>
+
+#include "flair/ui/Gamepad.h"
+
 namespace flair {
    namespace internal {
       namespace services {
          
+         // A compact snapshot of one device, buttons are a bitmask indexed by ui::Gamepad buttons
+         struct GamepadState
+         {
+            bool connected;
+            uint32_t buttons;
+            float axes[flair::ui::Gamepad::_AXIS_COUNT];
+         };
+         
+         // A change found by diffing two snapshots, timestamp is in IWindowService::ticks() milliseconds
+         struct GamepadTransition
+         {
+            enum {
+               CONNECTED,
+               DISCONNECTED,
+               BUTTON_DOWN,
+               BUTTON_UP,
+               AXIS
+            };
+            
+            int type;
+            uint32_t device;
+            uint32_t code;
+            float value;
+            uint32_t timestamp;
+         };
+         
          class IGamepadService
          {
+         // Properties
+         public:
+            virtual float deadZone() = 0;
+            virtual float deadZone(float value) = 0;
+            
+            virtual bool backgroundPolling() = 0;
+            virtual bool backgroundPolling(bool value) = 0;
+            
+         // Methods
+         public:
+            // Starts looking for devices, on first use of the gamepad api. Devices attached before
+            // are opened before it returns, and reported through deviceAdded again later.
+            virtual void open() = 0;
+            
+            virtual void deviceAdded(int deviceIndex) = 0;
+            virtual void deviceRemoved(int instanceId) = 0;
+            
+            // Takes a new snapshot of every device and records the transitions from the previous one
+            virtual void update(uint32_t timestamp) = 0;
+            
+            virtual void state(uint32_t device, GamepadState * state) = 0;
+            
+            // Visits the transitions recorded since the last clear, in device order
+            virtual void transitions(std::function<void(const GamepadTransition & transition)> callback) = 0;
+            
+            // Applies a transition recorded earlier in place of reading the devices
+            virtual void replay(const GamepadTransition & transition) = 0;
             
+            virtual void clear() = 0;
          };
          
       }
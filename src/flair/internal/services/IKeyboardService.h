@@ -10,14 +10,31 @@ namespace services {
    
    class IKeyboardService
    {
+   public:
+      // A key press (state < 0) or release (state > 0) with the modifiers held at the time,
+      // timestamp is in IWindowService::ticks() milliseconds
+      struct KeyTransition {
+         uint32_t keyCode;
+         int state;
+         uint32_t timestamp;
+         int shift;
+         int alt;
+         int ctrl;
+         int os;
+      };
+      
    public:
       virtual void modifiers(int shift, int alt, int ctrl, int os) = 0;
       virtual void modifiers(int * shift, int * alt, int * ctrl, int * os) = 0;
       
-      virtual void key(uint32_t keyCode, int state) = 0;
+      virtual void key(uint32_t keyCode, int state, uint32_t timestamp) = 0;
       virtual void key(uint32_t keyCode, int * state) = 0;
       
-      virtual void activeKeys(std::function<void(uint32_t keyCode, int keyState)> callback) = 0;
+      // Visits the transitions recorded since the last clear, in the order they happened
+      virtual void transitions(std::function<void(const KeyTransition & transition)> callback) = 0;
+      
+      // Applies a transition recorded earlier as if the platform had just reported it
+      virtual void replay(const KeyTransition & transition) = 0;
       
       virtual bool capsLock() = 0;
       
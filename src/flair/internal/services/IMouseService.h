@@ -2,8 +2,11 @@
 #define flair_internal_services_IMouseService_h
 
 #include <cstdint>
+#include <cstddef>
 #include <functional>
 
+#include "flair/events/MouseEvent.h"
+
 namespace flair {
 namespace internal {
 namespace services {
@@ -11,16 +14,37 @@ namespace services {
    class IMouseService
    {
    public:
-      virtual void movement(int X, int Y) = 0;
+      // A button press (state = -clicks) or release (state = clicks) at the pointer location of the event,
+      // timestamp is in IWindowService::ticks() milliseconds
+      struct ButtonTransition {
+         uint32_t buttonCode;
+         int state;
+         int previousState;
+         uint32_t timestamp;
+         int X;
+         int Y;
+      };
+      
+   public:
+      // Records one motion sample, updating the location and adding to the movement of this frame
+      virtual void motion(int X, int Y, int movementX, int movementY, uint32_t timestamp) = 0;
       virtual void movement(int * X, int * Y) = 0;
       
+      // Motion samples recorded since the last clear, oldest first. The storage is owned by the
+      // service and stays valid until the next clear.
+      virtual void history(flair::events::MouseEvent::Sample const** samples, size_t * length) = 0;
+      
       virtual void location(int X, int Y) = 0;
       virtual void location(int * X, int * Y) = 0;
       
-      virtual void button(uint32_t buttonCode, int state) = 0;
+      virtual void button(uint32_t buttonCode, int state, uint32_t timestamp) = 0;
       virtual void button(uint32_t buttonCode, int * state) = 0;
       
-      virtual void buttonStates(std::function<void(uint32_t buttonCode, int currentState, int previousState)> callback) = 0;
+      // Visits the transitions recorded since the last clear, in the order they happened
+      virtual void buttonTransitions(std::function<void(const ButtonTransition & transition)> callback) = 0;
+      
+      // Applies a transition recorded earlier as if the platform had just reported it
+      virtual void replay(const ButtonTransition & transition) = 0;
       
       virtual void clear() = 0;
       
@@ -0,0 +1,47 @@
+#ifndef flair_internal_services_ITimerService_h
+#define flair_internal_services_ITimerService_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace flair {
+   namespace internal {
+      namespace services {
+         
+         // Timers on the frame clock, in milliseconds of accumulated frame time. Ids are never 0,
+         // and an id stays invalid once its timer completed or was cancelled.
+         class ITimerService
+         {
+         // Properties
+         public:
+            virtual uint64_t now() = 0;
+            
+            // Timers waiting to fire
+            virtual size_t pending() = 0;
+            
+            // Milliseconds until the next timer may come due, possibly early but never late, or -1
+            // when there is none
+            virtual int64_t next() = 0;
+            
+         // Methods
+         public:
+            // Calls callback once delay milliseconds from now, then every interval milliseconds
+            // until cancelled when interval isn't 0
+            virtual uint32_t schedule(uint32_t delay, uint32_t interval, std::function<void()> callback) = 0;
+            
+            // Returns false if the timer already completed or was cancelled
+            virtual bool cancel(uint32_t id) = 0;
+            
+            virtual bool active(uint32_t id) = 0;
+            
+            // Moves the clock forward to time and fires the timers that came due on the way, in
+            // order of their due time. Timers due in the same millisecond fire in no set order.
+            virtual void update(uint64_t time) = 0;
+         };
+         
+      }
+   }
+}
+
+#endif
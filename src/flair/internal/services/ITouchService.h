@@ -1,13 +1,55 @@
 #ifndef flair_internal_services_ITouchService_h
 #define flair_internal_services_ITouchService_h
 
+#include <cstddef>
+#include <cstdint>
+
 namespace flair {
    namespace internal {
       namespace services {
          
+         // One contact as of the end of the frame, X and Y are in window pixels and timestamp is in
+         // IWindowService::ticks() milliseconds
+         struct TouchPoint
+         {
+            enum {
+               BEGIN,
+               MOVE,
+               END
+            };
+            
+            int64_t touchId;
+            int phase;
+            bool primary;
+            float X;
+            float Y;
+            float pressure;
+            uint32_t timestamp;
+         };
+         
          class ITouchService
          {
+         public:
+            // Simultaneous contacts tracked, further contacts are ignored until one lifts
+            static const size_t MAX_TOUCH_POINTS = 20;
+            
+            // A contact can begin and end in the same frame, so a frame holds up to two points each
+            static const size_t MAX_CHANGED_POINTS = MAX_TOUCH_POINTS * 2;
+            
+         // Properties
+         public:
+            virtual size_t activePoints() = 0;
+            
+         // Methods
+         public:
+            virtual void touch(int64_t touchId, int phase, float X, float Y, float pressure, uint32_t timestamp) = 0;
+            
+            // Points that changed since the last clear. Motion is coalesced to one entry per contact,
+            // a contact that begins and ends within the frame reports both. The storage is owned by
+            // the service and stays valid until the next clear.
+            virtual void points(TouchPoint const** points, size_t * length) = 0;
             
+            virtual void clear() = 0;
          };
          
       }
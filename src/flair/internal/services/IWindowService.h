@@ -45,6 +45,13 @@ namespace flair {
             
             virtual bool fullscreen() = 0;
             
+            // False while the window is hidden or minimized
+            virtual bool visible() = 0;
+            
+            // Milliseconds on the same clock as the input event timestamps, which are taken when
+            // poll() pumps the platform queue
+            virtual uint32_t ticks() = 0;
+            
             
          // Methods
          public:
@@ -61,6 +68,14 @@ namespace flair {
             virtual void exitFullscreen() = 0;
             
             virtual void poll(IGamepadService * gamepadService, ITouchService * touchService, IMouseService * mouseService, IKeyboardService * keyboardService) = 0;
+            
+            // Blocks until a platform event arrives, wake() is called or timeout milliseconds pass,
+            // a negative timeout waits for the next event. The events are left for poll. Returns
+            // at once when woken since the last wait.
+            virtual void wait(int timeout) = 0;
+            
+            // Safe from any thread, ends the current or next wait
+            virtual void wake() = 0;
          };
          
       }
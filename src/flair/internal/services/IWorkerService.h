@@ -16,6 +16,15 @@ namespace services {
       virtual void init(IAsyncIOService * asyncIOService) = 0;
       
       virtual void execute(std::function<std::shared_ptr<IAsyncWorkerRequest::IWorkerResult>()> worker, std::function<void(std::shared_ptr<IAsyncWorkerRequest>)> callback) = 0;
+      
+      // Runs body over [0, count) in ranges of at most grain indices on the worker threads and the
+      // caller, and returns once all of them completed. A grain of 0 splits evenly.
+      virtual void parallelFor(size_t count, size_t grain, std::function<void(size_t begin, size_t end)> body) = 0;
+      
+      // Fills in the pending jobs and parallel loops of stats, from the main thread
+      virtual void stats(flair::system::IOStats & stats) = 0;
+      
+      virtual void resetStats() = 0;
    };
    
 }}}
@@ -0,0 +1,154 @@
+#include "flair/internal/services/base/GamepadService.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+   using flair::ui::Gamepad;
+   
+   // Smallest axis change reported as a transition
+   const float AXIS_RESOLUTION = 1.0f / 128.0f;
+   
+   void applyRadialDeadZone(float & x, float & y, float deadZone)
+   {
+      float magnitude = std::sqrt(x * x + y * y);
+      if (magnitude <= deadZone) {
+         x = y = 0.0f;
+         return;
+      }
+      
+      // Rescale so the output still covers the full range just outside the dead zone
+      float scaled = std::fmin((magnitude - deadZone) / (1.0f - deadZone), 1.0f);
+      x = x / magnitude * scaled;
+      y = y / magnitude * scaled;
+   }
+   
+   float applyLinearDeadZone(float value, float deadZone)
+   {
+      return value <= deadZone ? 0.0f : std::fmin((value - deadZone) / (1.0f - deadZone), 1.0f);
+   }
+}
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace base {
+   
+   GamepadService::GamepadService() : _deadZone(0.15f)
+   {
+      memset(_states, 0, sizeof(_states));
+      memset(_reportedAxes, 0, sizeof(_reportedAxes));
+      _transitions.reserve(32);
+   }
+   
+   float GamepadService::deadZone()
+   {
+      return _deadZone;
+   }
+   
+   float GamepadService::deadZone(float value)
+   {
+      return _deadZone = std::fmax(0.0f, std::fmin(value, 0.99f));
+   }
+   
+   void GamepadService::update(uint32_t timestamp)
+   {
+      for (uint32_t device = 0; device < Gamepad::MAX_DEVICES; ++device) {
+         GamepadState current;
+         read(device, &current);
+         applyDeadZone(&current);
+         
+         GamepadState & previous = _states[device];
+         if (current.connected != previous.connected) {
+            record(current.connected ? GamepadTransition::CONNECTED : GamepadTransition::DISCONNECTED, device, 0, 0.0f, timestamp);
+         }
+         
+         // Only touch the buttons that changed
+         uint32_t changed = current.buttons ^ previous.buttons;
+         while (changed) {
+            uint32_t button = 0;
+            while (!(changed & (1u << button))) ++button;
+            changed &= ~(1u << button);
+            
+            bool down = (current.buttons & (1u << button)) != 0;
+            record(down ? GamepadTransition::BUTTON_DOWN : GamepadTransition::BUTTON_UP, device, button, down ? 1.0f : 0.0f, timestamp);
+         }
+         
+         for (uint32_t axis = 0; axis < Gamepad::_AXIS_COUNT; ++axis) {
+            float value = current.axes[axis];
+            float & reported = _reportedAxes[device][axis];
+            
+            // Rest and the extremes are always reported exactly, otherwise wait for a meaningful change
+            bool settled = (value == 0.0f || std::fabs(value) == 1.0f) && value != reported;
+            if (settled || std::fabs(value - reported) >= AXIS_RESOLUTION) {
+               reported = value;
+               record(GamepadTransition::AXIS, device, axis, value, timestamp);
+            }
+         }
+         
+         previous = current;
+      }
+   }
+   
+   void GamepadService::state(uint32_t device, GamepadState * state)
+   {
+      if (device >= Gamepad::MAX_DEVICES) {
+         memset(state, 0, sizeof(GamepadState));
+         return;
+      }
+      *state = _states[device];
+   }
+   
+   void GamepadService::transitions(std::function<void(const GamepadTransition & transition)> callback)
+   {
+      for (auto const& transition : _transitions) {
+         callback(transition);
+      }
+   }
+   
+   void GamepadService::replay(const GamepadTransition & transition)
+   {
+      if (transition.device >= Gamepad::MAX_DEVICES) return;
+      
+      GamepadState & state = _states[transition.device];
+      switch (transition.type) {
+         case GamepadTransition::CONNECTED:
+            state.connected = true;
+            break;
+         case GamepadTransition::DISCONNECTED:
+            state.connected = false;
+            break;
+         case GamepadTransition::BUTTON_DOWN:
+            if (transition.code < Gamepad::_BUTTON_COUNT) state.buttons |= (1u << transition.code);
+            break;
+         case GamepadTransition::BUTTON_UP:
+            if (transition.code < Gamepad::_BUTTON_COUNT) state.buttons &= ~(1u << transition.code);
+            break;
+         case GamepadTransition::AXIS:
+            if (transition.code < Gamepad::_AXIS_COUNT) state.axes[transition.code] = _reportedAxes[transition.device][transition.code] = transition.value;
+            break;
+      }
+      
+      _transitions.push_back(transition);
+   }
+   
+   void GamepadService::clear()
+   {
+      _transitions.clear();
+   }
+   
+   void GamepadService::applyDeadZone(GamepadState * state) const
+   {
+      applyRadialDeadZone(state->axes[Gamepad::AXIS_LEFT_X], state->axes[Gamepad::AXIS_LEFT_Y], _deadZone);
+      applyRadialDeadZone(state->axes[Gamepad::AXIS_RIGHT_X], state->axes[Gamepad::AXIS_RIGHT_Y], _deadZone);
+      state->axes[Gamepad::AXIS_TRIGGER_LEFT] = applyLinearDeadZone(state->axes[Gamepad::AXIS_TRIGGER_LEFT], _deadZone);
+      state->axes[Gamepad::AXIS_TRIGGER_RIGHT] = applyLinearDeadZone(state->axes[Gamepad::AXIS_TRIGGER_RIGHT], _deadZone);
+   }
+   
+   void GamepadService::record(int type, uint32_t device, uint32_t code, float value, uint32_t timestamp)
+   {
+      GamepadTransition transition = { type, device, code, value, timestamp };
+      _transitions.push_back(transition);
+   }
+   
+}}}}
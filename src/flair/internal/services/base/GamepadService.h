@@ -0,0 +1,52 @@
+#ifndef flair_internal_services_base_GamepadService_h
+#define flair_internal_services_base_GamepadService_h
+
+#include "flair/internal/services/IGamepadService.h"
+
+#include <vector>
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace base {
+   
+   // Platform independent half of the gamepad service: applies dead zones to raw snapshots and
+   // diffs them against the previous frame. Platforms only implement read().
+   class GamepadService : public IGamepadService
+   {
+   public:
+      GamepadService();
+      virtual ~GamepadService() {}
+      
+      float deadZone() override;
+      float deadZone(float value) override;
+      
+      void update(uint32_t timestamp) override;
+      
+      void state(uint32_t device, GamepadState * state) override;
+      
+      void transitions(std::function<void(const GamepadTransition & transition)> callback) override;
+      
+      void replay(const GamepadTransition & transition) override;
+      
+      void clear() override;
+      
+   protected:
+      // Reads the raw state of a device slot, axes normalized but without a dead zone
+      virtual void read(uint32_t device, GamepadState * state) = 0;
+      
+      void applyDeadZone(GamepadState * state) const;
+      void record(int type, uint32_t device, uint32_t code, float value, uint32_t timestamp);
+      
+   protected:
+      float _deadZone;
+      GamepadState _states[flair::ui::Gamepad::MAX_DEVICES];
+      
+      // Last axis values reported as transitions, so slow drift still adds up to an event
+      float _reportedAxes[flair::ui::Gamepad::MAX_DEVICES][flair::ui::Gamepad::_AXIS_COUNT];
+      std::vector<GamepadTransition> _transitions;
+   };
+   
+}}}}
+
+#endif
@@ -0,0 +1,254 @@
+#include "flair/internal/services/base/TimerService.h"
+#include "flair/internal/utils/Profiler.h"
+
+#include <cassert>
+#include <utility>
+
+namespace {
+   const uint32_t INDEX_BITS = 20;
+   const uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+   const uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+   const uint32_t NIL = UINT32_MAX;
+}
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace base {
+   
+   TimerService::TimerService() : _now(0), _pending(0), _firing(NIL), _firingCancelled(false), _target(0)
+   {
+      for (auto & head : _heads) head = NIL;
+   }
+   
+   uint64_t TimerService::now()
+   {
+      return _now;
+   }
+   
+   size_t TimerService::pending()
+   {
+      return _pending;
+   }
+   
+   int64_t TimerService::next()
+   {
+      if (_pending == 0) return -1;
+      
+      // Exact within the finest wheel, a coarser slot only tells when it moves down. A coarser
+      // slot can move down before the first timer of the finest wheel fires, so every wheel is
+      // looked at.
+      int64_t next = -1;
+      uint32_t position = _now & (SLOTS - 1);
+      for (uint32_t offset = 1; offset < SLOTS; ++offset) {
+         if (_heads[(position + offset) & (SLOTS - 1)] == NIL) continue;
+         
+         next = offset;
+         break;
+      }
+      
+      for (uint32_t wheel = 1; wheel < WHEELS; ++wheel) {
+         uint64_t slot = _now >> (wheel * SLOT_BITS);
+         for (uint32_t offset = 1; offset <= SLOTS; ++offset) {
+            if (_heads[wheel * SLOTS + ((slot + offset) & (SLOTS - 1))] == NIL) continue;
+            
+            int64_t cascade = static_cast<int64_t>(((slot + offset) << (wheel * SLOT_BITS)) - _now);
+            if (next < 0 || cascade < next) next = cascade;
+            break;
+         }
+      }
+      return next;
+   }
+   
+   uint32_t TimerService::schedule(uint32_t delay, uint32_t interval, std::function<void()> callback)
+   {
+      uint32_t index;
+      if (!_free.empty()) {
+         index = _free.back();
+         _free.pop_back();
+      }
+      else {
+         assert(_nodes.size() < INDEX_MASK);
+         index = static_cast<uint32_t>(_nodes.size());
+         _nodes.push_back(Node());
+         _nodes.back().generation = 1;
+      }
+      
+      Node & node = _nodes[index];
+      node.due = _now + (delay > 0 ? delay : 1);
+      node.interval = interval;
+      node.callback = std::move(callback);
+      node.list = NONE;
+      insert(index);
+      
+      ++_pending;
+      return (node.generation << INDEX_BITS) | index;
+   }
+   
+   bool TimerService::cancel(uint32_t id)
+   {
+      Node * node = find(id);
+      if (!node) return false;
+      
+      uint32_t index = id & INDEX_MASK;
+      if (index == _firing) {
+         // Released when its callback returns
+         _firingCancelled = true;
+         return true;
+      }
+      
+      unlink(index);
+      release(index);
+      return true;
+   }
+   
+   bool TimerService::active(uint32_t id)
+   {
+      if (!find(id)) return false;
+      return !((id & INDEX_MASK) == _firing && _firingCancelled);
+   }
+   
+   void TimerService::update(uint64_t time)
+   {
+      FLAIR_PROFILE_ZONE("TimerService::update");
+      
+      _target = time;
+      
+      while (_now < time) {
+         // Nothing can come due, jump straight to the target
+         if (_pending == 0) {
+            _now = time;
+            break;
+         }
+         
+         ++_now;
+         
+         // Each time a wheel wraps, the next slot of the coarser wheel moves down
+         uint32_t wheel = 0;
+         while (wheel + 1 < WHEELS && ((_now >> (wheel * SLOT_BITS)) & (SLOTS - 1)) == 0) {
+            cascade(++wheel);
+         }
+         
+         uint32_t slot = _now & (SLOTS - 1);
+         if (_heads[slot] == NIL) continue;
+         
+         // Detach the slot so timers scheduled from the callbacks land in the wheels
+         _heads[DUE] = _heads[slot];
+         _heads[slot] = NIL;
+         for (uint32_t index = _heads[DUE]; index != NIL; index = _nodes[index].next) {
+            _nodes[index].list = DUE;
+         }
+         
+         while (_heads[DUE] != NIL) {
+            uint32_t index = _heads[DUE];
+            unlink(index);
+            
+            // Moved out for the call, the node vector may grow under it
+            std::function<void()> callback = std::move(_nodes[index].callback);
+            _firing = index;
+            _firingCancelled = false;
+            callback();
+            _firing = NIL;
+            
+            Node & node = _nodes[index];
+            if (node.interval == 0 || _firingCancelled) {
+               release(index);
+               continue;
+            }
+            
+            // Keep the phase, but skip the periods that passed within this update instead of
+            // firing them back to back
+            node.callback = std::move(callback);
+            node.due += node.interval;
+            if (node.due <= _target) {
+               node.due += (_target - node.due) / node.interval * node.interval + node.interval;
+            }
+            insert(index);
+         }
+      }
+   }
+   
+   TimerService::Node * TimerService::find(uint32_t id)
+   {
+      uint32_t index = id & INDEX_MASK;
+      if (index >= _nodes.size()) return nullptr;
+      
+      Node & node = _nodes[index];
+      if (node.generation != id >> INDEX_BITS) return nullptr;
+      if (node.list == NONE && index != _firing) return nullptr;
+      return &node;
+   }
+   
+   void TimerService::insert(uint32_t index)
+   {
+      Node & node = _nodes[index];
+      uint64_t due = node.due;
+      uint64_t delta = due - _now;
+      
+      // The coarsest wheel holds up to SLOTS - 1 of its slots ahead, later timers wait in its
+      // last slot and are placed again when it comes round
+      uint64_t limit = uint64_t(1) << (WHEELS * SLOT_BITS);
+      if (delta >= limit) due = _now + limit - 1;
+      
+      uint32_t wheel = 0;
+      while (wheel + 1 < WHEELS && (due - _now) >= (uint64_t(1) << ((wheel + 1) * SLOT_BITS))) {
+         ++wheel;
+      }
+      
+      uint32_t slot = (due >> (wheel * SLOT_BITS)) & (SLOTS - 1);
+      link(index, wheel * SLOTS + slot);
+   }
+   
+   void TimerService::link(uint32_t index, uint32_t list)
+   {
+      Node & node = _nodes[index];
+      node.list = list;
+      node.previous = NIL;
+      node.next = _heads[list];
+      if (node.next != NIL) _nodes[node.next].previous = index;
+      _heads[list] = index;
+   }
+   
+   void TimerService::unlink(uint32_t index)
+   {
+      Node & node = _nodes[index];
+      if (node.list == NONE) return;
+      
+      if (node.previous != NIL) {
+         _nodes[node.previous].next = node.next;
+      }
+      else {
+         _heads[node.list] = node.next;
+      }
+      if (node.next != NIL) _nodes[node.next].previous = node.previous;
+      
+      node.list = NONE;
+      node.previous = node.next = NIL;
+   }
+   
+   void TimerService::release(uint32_t index)
+   {
+      Node & node = _nodes[index];
+      node.callback = nullptr;
+      node.list = NONE;
+      node.generation = (node.generation & GENERATION_MASK) == GENERATION_MASK ? 1 : node.generation + 1;
+      
+      _free.push_back(index);
+      --_pending;
+   }
+   
+   void TimerService::cascade(uint32_t wheel)
+   {
+      uint32_t list = wheel * SLOTS + ((_now >> (wheel * SLOT_BITS)) & (SLOTS - 1));
+      
+      uint32_t index = _heads[list];
+      _heads[list] = NIL;
+      while (index != NIL) {
+         uint32_t next = _nodes[index].next;
+         _nodes[index].list = NONE;
+         insert(index);
+         index = next;
+      }
+   }
+   
+}}}}
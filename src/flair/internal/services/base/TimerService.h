@@ -0,0 +1,86 @@
+#ifndef flair_internal_services_base_TimerService_h
+#define flair_internal_services_base_TimerService_h
+
+#include "flair/internal/services/ITimerService.h"
+
+#include <vector>
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace base {
+   
+   // Hierarchical timing wheel: four wheels of 64 slots at 1, 64, 4096 and 262144 milliseconds
+   // per slot. A timer goes into the coarsest wheel that still resolves it and moves one wheel
+   // down each time the slot it sits in comes round, so insert and cancel are O(1) and a frame
+   // only visits the slots it passes. Timers are nodes in one vector linked into their slot by
+   // index, a repeating timer is relinked in place.
+   class TimerService : public ITimerService
+   {
+   public:
+      TimerService();
+      virtual ~TimerService() {}
+      
+      uint64_t now() override;
+      
+      size_t pending() override;
+      
+      int64_t next() override;
+      
+      uint32_t schedule(uint32_t delay, uint32_t interval, std::function<void()> callback) override;
+      
+      bool cancel(uint32_t id) override;
+      
+      bool active(uint32_t id) override;
+      
+      void update(uint64_t time) override;
+      
+   protected:
+      static const uint32_t WHEELS = 4;
+      static const uint32_t SLOT_BITS = 6;
+      static const uint32_t SLOTS = 1 << SLOT_BITS;
+      
+      // List ids past the wheel slots
+      static const uint32_t DUE = WHEELS * SLOTS;
+      static const uint32_t NONE = DUE + 1;
+      
+      struct Node
+      {
+         uint64_t due;
+         uint32_t interval;
+         uint32_t generation;
+         uint32_t previous;
+         uint32_t next;
+         uint32_t list;
+         std::function<void()> callback;
+      };
+      
+      Node * find(uint32_t id);
+      
+      void insert(uint32_t index);
+      void link(uint32_t index, uint32_t list);
+      void unlink(uint32_t index);
+      void release(uint32_t index);
+      
+      // Moves every timer of a wheel slot to the finer wheels
+      void cascade(uint32_t wheel);
+      
+   protected:
+      uint64_t _now;
+      size_t _pending;
+      
+      std::vector<Node> _nodes;
+      std::vector<uint32_t> _free;
+      
+      // First node of each slot, followed by the list of timers due this tick
+      uint32_t _heads[DUE + 1];
+      
+      // The timer whose callback is running, it is released once the callback returns
+      uint32_t _firing;
+      bool _firingCancelled;
+      uint64_t _target;
+   };
+   
+}}}}
+
+#endif
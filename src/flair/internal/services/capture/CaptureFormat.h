@@ -0,0 +1,74 @@
+#ifndef flair_internal_services_capture_CaptureFormat_h
+#define flair_internal_services_capture_CaptureFormat_h
+
+#include "flair/internal/rendering/ITexture.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace capture {
+   
+   // Layout of a render capture. After the header every record is a tag byte followed by its
+   // fields, all little endian:
+   //
+   //   CONTEXT          i32 width, i32 height, u8 vsync
+   //   TEXTURE_CREATE   u32 id, i32 width, i32 height, u8 format, u8 type
+   //   PIXELS           u64 hash, u32 length, bytes       (once per distinct content)
+   //   TEXTURE_UPDATE   u32 id, f32 x, y, width, height, u64 hash
+   //   TEXTURE_ALPHA    u32 id, f32 alpha
+   //   TEXTURE_BLEND    u32 id, u8 blend
+   //   TEXTURE_DESTROY  u32 id
+   //   CLEAR
+   //   DRAW_RECT        u32 id, f32 src x, y, width, height, f32 dst x, y, width, height
+   //   DRAW_MATRIX      u32 id, f32 src x, y, width, height, f32 a, b, c, d, tx, ty
+   //   PRESENT
+   //   END
+   namespace CaptureFormat {
+      
+      const uint32_t MAGIC = 0x50435246; // "FRCP"
+      const uint16_t VERSION = 1;
+      
+      enum : uint8_t {
+         CONTEXT = 1,
+         TEXTURE_CREATE,
+         PIXELS,
+         TEXTURE_UPDATE,
+         TEXTURE_ALPHA,
+         TEXTURE_BLEND,
+         TEXTURE_DESTROY,
+         CLEAR,
+         DRAW_RECT,
+         DRAW_MATRIX,
+         PRESENT,
+         END
+      };
+      
+      // Bytes read by ITexture::update for rect, the row pitch follows the texture width as the
+      // SDL backend does
+      inline size_t updateLength(rendering::ITexture::PixelFormat format, int textureWidth, float rectHeight)
+      {
+         size_t pitch = 0;
+         if (format == rendering::ITexture::PixelFormat::BGR) pitch = (textureWidth + 7) * 3;
+         if (format == rendering::ITexture::PixelFormat::BGRA) pitch = textureWidth * 4;
+         if (format == rendering::ITexture::PixelFormat::BGRA_PACKED) pitch = textureWidth * 4;
+         return pitch * (size_t)rectHeight;
+      }
+      
+      // FNV-1a, identical uploads are stored once
+      inline uint64_t hash(uint8_t const* bytes, size_t length)
+      {
+         uint64_t hash = 0xcbf29ce484222325ull;
+         for (size_t i = 0; i < length; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+         }
+         return hash;
+      }
+   }
+   
+}}}}
+
+#endif
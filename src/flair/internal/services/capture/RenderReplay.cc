@@ -0,0 +1,189 @@
+#include "flair/internal/services/capture/RenderReplay.h"
+#include "flair/internal/services/capture/CaptureFormat.h"
+#include "flair/utils/ByteArray.h"
+
+#include <chrono>
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace capture {
+   
+   using namespace rendering;
+   using flair::utils::ByteArray;
+   using flair::utils::Endian;
+   
+   RenderReplay::RenderReplay(std::shared_ptr<ByteArray> capture) : _capture(capture), _frame(0)
+   {
+      _capture->endian(Endian::LITTLE_ENDIAN_ORDER);
+   }
+   
+   RenderReplay::~RenderReplay()
+   {
+      
+   }
+   
+   bool RenderReplay::open(int * width, int * height, bool * vsync)
+   {
+      if (_capture->bytesAvailable() < 6) return false;
+      if (_capture->readUnsignedInt() != CaptureFormat::MAGIC || _capture->readUnsignedShort() != CaptureFormat::VERSION) return false;
+      
+      // The context is only recorded when the capture was installed before the window was made
+      *width = 0;
+      *height = 0;
+      *vsync = false;
+      if (_capture->bytesAvailable() > 0) {
+         size_t position = _capture->position();
+         if (_capture->readUnsignedByte() == CaptureFormat::CONTEXT) {
+            *width = _capture->readInt();
+            *height = _capture->readInt();
+            *vsync = _capture->readUnsignedByte() != 0;
+         }
+         else {
+            _capture->position(position);
+         }
+      }
+      
+      return true;
+   }
+   
+   bool RenderReplay::next(IRenderService * renderService, FrameTiming * timing)
+   {
+      timing->frame = _frame;
+      timing->drawCalls = 0;
+      timing->textureUploads = 0;
+      timing->milliseconds = 0.0;
+      
+      auto start = std::chrono::high_resolution_clock::now();
+      while (_capture->bytesAvailable() > 0) {
+         uint8_t tag = _capture->readUnsignedByte();
+         switch (tag) {
+            case CaptureFormat::CONTEXT: {
+               // A second context, nothing to re-create against an existing backend
+               _capture->readInt();
+               _capture->readInt();
+               _capture->readUnsignedByte();
+            } break;
+               
+            case CaptureFormat::TEXTURE_CREATE: {
+               uint32_t id = _capture->readUnsignedInt();
+               int width = _capture->readInt();
+               int height = _capture->readInt();
+               auto format = (ITexture::PixelFormat)_capture->readUnsignedByte();
+               auto type = (ITexture::Type)_capture->readUnsignedByte();
+               _textures[id] = renderService->createTexture(width, height, format, type);
+            } break;
+               
+            case CaptureFormat::PIXELS: {
+               // Skipped over here and read back when an update refers to it
+               uint64_t hash = _capture->readUnsignedLong();
+               Pixels pixels = { 0, _capture->readUnsignedInt() };
+               pixels.position = _capture->position();
+               _pixels[hash] = pixels;
+               _capture->position(pixels.position + pixels.length);
+            } break;
+               
+            case CaptureFormat::TEXTURE_UPDATE: {
+               ITexture * target = texture(_capture->readUnsignedInt());
+               geom::Rectangle rect = readRectangle();
+               auto pixels = _pixels.find(_capture->readUnsignedLong());
+               if (!target || pixels == _pixels.end()) break;
+               
+               size_t position = _capture->position();
+               _upload.resize(pixels->second.length);
+               _capture->position(pixels->second.position);
+               _capture->readBytes(_upload.data(), 0, pixels->second.length);
+               _capture->position(position);
+               
+               target->update(rect, _upload.data());
+               ++timing->textureUploads;
+            } break;
+               
+            case CaptureFormat::TEXTURE_ALPHA: {
+               ITexture * target = texture(_capture->readUnsignedInt());
+               float alpha = _capture->readFloat();
+               if (target) target->alpha(alpha);
+            } break;
+               
+            case CaptureFormat::TEXTURE_BLEND: {
+               ITexture * target = texture(_capture->readUnsignedInt());
+               auto blend = (ITexture::BlendMode)_capture->readUnsignedByte();
+               if (target) target->blend(blend);
+            } break;
+               
+            case CaptureFormat::TEXTURE_DESTROY: {
+               uint32_t id = _capture->readUnsignedInt();
+               ITexture * target = texture(id);
+               if (target) {
+                  renderService->destroyTexture(target);
+                  _textures.erase(id);
+               }
+            } break;
+               
+            case CaptureFormat::CLEAR: {
+               renderService->clear();
+            } break;
+               
+            case CaptureFormat::DRAW_RECT: {
+               ITexture * target = texture(_capture->readUnsignedInt());
+               geom::Rectangle srcRect = readRectangle();
+               geom::Rectangle dstRect = readRectangle();
+               if (target) renderService->renderTexture(target, srcRect, dstRect);
+               ++timing->drawCalls;
+            } break;
+               
+            case CaptureFormat::DRAW_MATRIX: {
+               ITexture * target = texture(_capture->readUnsignedInt());
+               geom::Rectangle srcRect = readRectangle();
+               geom::Matrix transform;
+               transform.a(_capture->readFloat());
+               transform.b(_capture->readFloat());
+               transform.c(_capture->readFloat());
+               transform.d(_capture->readFloat());
+               transform.tx(_capture->readFloat());
+               transform.ty(_capture->readFloat());
+               if (target) renderService->renderTexture(target, srcRect, transform);
+               ++timing->drawCalls;
+            } break;
+               
+            case CaptureFormat::PRESENT: {
+               renderService->present();
+               timing->milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+               ++_frame;
+               return true;
+            }
+               
+            default:
+               // END or an unknown record, the rest cannot be replayed
+               _capture->position(_capture->length());
+               return false;
+         }
+      }
+      
+      return false;
+   }
+   
+   void RenderReplay::close(IRenderService * renderService)
+   {
+      for (auto & texture : _textures) {
+         renderService->destroyTexture(texture.second);
+      }
+      _textures.clear();
+   }
+   
+   geom::Rectangle RenderReplay::readRectangle()
+   {
+      float x = _capture->readFloat();
+      float y = _capture->readFloat();
+      float width = _capture->readFloat();
+      float height = _capture->readFloat();
+      return geom::Rectangle(x, y, width, height);
+   }
+   
+   ITexture * RenderReplay::texture(uint32_t id)
+   {
+      auto it = _textures.find(id);
+      return it == _textures.end() ? nullptr : it->second;
+   }
+   
+}}}}
@@ -0,0 +1,66 @@
+#ifndef flair_internal_services_capture_RenderReplay_h
+#define flair_internal_services_capture_RenderReplay_h
+
+#include "flair/internal/services/IRenderService.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace flair { namespace utils { class ByteArray; } }
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace capture {
+   
+   // Re-issues a render capture against any render service, one frame at a time
+   class RenderReplay
+   {
+   public:
+      struct FrameTiming
+      {
+         uint32_t frame;
+         uint32_t drawCalls;
+         uint32_t textureUploads;
+         
+         // From the first call of the frame until present returned, uploads included
+         double milliseconds;
+      };
+      
+   public:
+      RenderReplay(std::shared_ptr<flair::utils::ByteArray> capture);
+      virtual ~RenderReplay();
+      
+   // Methods
+   public:
+      // Checks the header and reads the context the capture was made with
+      bool open(int * width, int * height, bool * vsync);
+      
+      // Issues the calls of the next frame, returns false when the capture has no more frames
+      bool next(IRenderService * renderService, FrameTiming * timing);
+      
+      // Destroys the textures still alive at the end of the capture
+      void close(IRenderService * renderService);
+      
+   protected:
+      geom::Rectangle readRectangle();
+      rendering::ITexture * texture(uint32_t id);
+      
+   protected:
+      struct Pixels {
+         size_t position;
+         uint32_t length;
+      };
+      
+      std::shared_ptr<flair::utils::ByteArray> _capture;
+      uint32_t _frame;
+      std::unordered_map<uint32_t, rendering::ITexture *> _textures;
+      std::unordered_map<uint64_t, Pixels> _pixels;
+      std::vector<uint8_t> _upload;
+   };
+   
+}}}}
+
+#endif
@@ -0,0 +1,187 @@
+#include "flair/internal/services/capture/RenderService.h"
+#include "flair/internal/services/capture/CaptureFormat.h"
+#include "flair/internal/rendering/capture/Texture.h"
+#include "flair/utils/ByteArray.h"
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace capture {
+   
+   using namespace rendering;
+   using flair::utils::ByteArray;
+   using flair::utils::Endian;
+   
+   RenderService::RenderService(IRenderService * target, std::shared_ptr<ByteArray> capture, uint32_t frames) : _target(target),
+      _capture(capture), _frames(frames), _capturedFrames(0), _nextTextureId(1)
+   {
+      _capture->endian(Endian::LITTLE_ENDIAN_ORDER);
+      _capture->writeUnsignedInt(CaptureFormat::MAGIC);
+      _capture->writeUnsignedShort(CaptureFormat::VERSION);
+   }
+   
+   RenderService::~RenderService()
+   {
+      
+   }
+   
+   IRenderService * RenderService::target()
+   {
+      return _target;
+   }
+   
+   std::shared_ptr<ByteArray> RenderService::capture()
+   {
+      return _capture;
+   }
+   
+   bool RenderService::finished()
+   {
+      return _capturedFrames >= _frames;
+   }
+   
+   bool RenderService::recording()
+   {
+      return _capturedFrames < _frames;
+   }
+   
+   void RenderService::create(IWindowService * windowService, bool vsync)
+   {
+      if (recording()) {
+         geom::Rectangle bounds = windowService->bounds();
+         _capture->writeUnsignedByte(CaptureFormat::CONTEXT);
+         _capture->writeInt((int32_t)bounds.width());
+         _capture->writeInt((int32_t)bounds.height());
+         _capture->writeUnsignedByte(vsync ? 1 : 0);
+      }
+      _target->create(windowService, vsync);
+   }
+   
+   void RenderService::clear()
+   {
+      if (recording()) _capture->writeUnsignedByte(CaptureFormat::CLEAR);
+      _target->clear();
+   }
+   
+   void RenderService::present()
+   {
+      _target->present();
+      if (!recording()) return;
+      
+      _capture->writeUnsignedByte(CaptureFormat::PRESENT);
+      if (++_capturedFrames == _frames) end();
+   }
+   
+   void RenderService::finish()
+   {
+      if (!recording()) return;
+      
+      _frames = _capturedFrames;
+      end();
+   }
+   
+   void RenderService::end()
+   {
+      _capture->writeUnsignedByte(CaptureFormat::END);
+      _storedPixels.clear();
+   }
+   
+   ITexture * RenderService::createTexture(int width, int height, ITexture::PixelFormat format, ITexture::Type type)
+   {
+      uint32_t id = _nextTextureId++;
+      if (recording()) {
+         _capture->writeUnsignedByte(CaptureFormat::TEXTURE_CREATE);
+         _capture->writeUnsignedInt(id);
+         _capture->writeInt(width);
+         _capture->writeInt(height);
+         _capture->writeUnsignedByte((uint8_t)format);
+         _capture->writeUnsignedByte((uint8_t)type);
+      }
+      return new rendering::capture::Texture(this, _target->createTexture(width, height, format, type), id, format);
+   }
+   
+   void RenderService::renderTexture(ITexture * texture, geom::Rectangle srcRect, geom::Rectangle dstRect)
+   {
+      auto captured = static_cast<rendering::capture::Texture*>(texture);
+      if (recording()) {
+         _capture->writeUnsignedByte(CaptureFormat::DRAW_RECT);
+         _capture->writeUnsignedInt(captured->id());
+         writeRectangle(srcRect);
+         writeRectangle(dstRect);
+      }
+      _target->renderTexture(captured->target(), srcRect, dstRect);
+   }
+   
+   void RenderService::renderTexture(ITexture * texture, geom::Rectangle srcRect, geom::Matrix transform)
+   {
+      auto captured = static_cast<rendering::capture::Texture*>(texture);
+      if (recording()) {
+         _capture->writeUnsignedByte(CaptureFormat::DRAW_MATRIX);
+         _capture->writeUnsignedInt(captured->id());
+         writeRectangle(srcRect);
+         _capture->writeFloat(transform.a());
+         _capture->writeFloat(transform.b());
+         _capture->writeFloat(transform.c());
+         _capture->writeFloat(transform.d());
+         _capture->writeFloat(transform.tx());
+         _capture->writeFloat(transform.ty());
+      }
+      _target->renderTexture(captured->target(), srcRect, transform);
+   }
+   
+   void RenderService::destroyTexture(ITexture * texture)
+   {
+      auto captured = static_cast<rendering::capture::Texture*>(texture);
+      if (recording()) {
+         _capture->writeUnsignedByte(CaptureFormat::TEXTURE_DESTROY);
+         _capture->writeUnsignedInt(captured->id());
+      }
+      _target->destroyTexture(captured->target());
+      delete captured;
+   }
+   
+   void RenderService::textureUpdate(rendering::capture::Texture * texture, geom::Rectangle rect, uint8_t const* pixels)
+   {
+      if (!recording()) return;
+      
+      size_t length = CaptureFormat::updateLength(texture->format(), texture->width(), rect.height());
+      uint64_t hash = CaptureFormat::hash(pixels, length);
+      
+      if (_storedPixels.insert(hash).second) {
+         _capture->writeUnsignedByte(CaptureFormat::PIXELS);
+         _capture->writeUnsignedLong(hash);
+         _capture->writeUnsignedInt((uint32_t)length);
+         _capture->writeBytes(pixels, 0, length);
+      }
+      
+      _capture->writeUnsignedByte(CaptureFormat::TEXTURE_UPDATE);
+      _capture->writeUnsignedInt(texture->id());
+      writeRectangle(rect);
+      _capture->writeUnsignedLong(hash);
+   }
+   
+   void RenderService::textureAlpha(rendering::capture::Texture * texture, float alpha)
+   {
+      if (!recording()) return;
+      _capture->writeUnsignedByte(CaptureFormat::TEXTURE_ALPHA);
+      _capture->writeUnsignedInt(texture->id());
+      _capture->writeFloat(alpha);
+   }
+   
+   void RenderService::textureBlend(rendering::capture::Texture * texture, ITexture::BlendMode blend)
+   {
+      if (!recording()) return;
+      _capture->writeUnsignedByte(CaptureFormat::TEXTURE_BLEND);
+      _capture->writeUnsignedInt(texture->id());
+      _capture->writeUnsignedByte((uint8_t)blend);
+   }
+   
+   void RenderService::writeRectangle(const geom::Rectangle & rect)
+   {
+      _capture->writeFloat(rect.x());
+      _capture->writeFloat(rect.y());
+      _capture->writeFloat(rect.width());
+      _capture->writeFloat(rect.height());
+   }
+   
+}}}}
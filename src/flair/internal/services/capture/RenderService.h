@@ -0,0 +1,83 @@
+#ifndef flair_internal_services_capture_RenderService_h
+#define flair_internal_services_capture_RenderService_h
+
+#include "flair/internal/services/IRenderService.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+
+namespace flair { namespace utils { class ByteArray; } }
+namespace flair { namespace internal { namespace rendering { namespace capture { class Texture; }}}}
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace capture {
+   
+   // Sits in front of another render service and records every call made on it, with texture
+   // uploads stored once per distinct content, until the requested number of frames has been
+   // presented. The backend keeps rendering as usual, the capture is laid out in CaptureFormat.h.
+   //
+   // Texture creations are recorded from construction on, so install it before any texture is
+   // made. Once the frames are captured the service only forwards.
+   class RenderService : public IRenderService
+   {
+      friend class rendering::capture::Texture;
+      
+   public:
+      RenderService(IRenderService * target, std::shared_ptr<flair::utils::ByteArray> capture, uint32_t frames);
+      virtual ~RenderService();
+      
+   // Properties
+   public:
+      IRenderService * target();
+      
+      std::shared_ptr<flair::utils::ByteArray> capture();
+      
+      // True once the requested frames have been presented and the capture is closed
+      bool finished();
+      
+   // Methods
+   public:
+      // Closes the capture with the frames presented so far, for a session that ends before the
+      // requested frames were all captured
+      void finish();
+      
+      void create(IWindowService * windowService, bool vsync = true) override;
+      
+      void clear() override;
+      
+      void present() override;
+      
+      rendering::ITexture * createTexture(int width, int height, rendering::ITexture::PixelFormat format, rendering::ITexture::Type type) override;
+      
+      void renderTexture(rendering::ITexture * texture, geom::Rectangle srcRect, geom::Rectangle dstRect) override;
+      
+      void renderTexture(rendering::ITexture * texture, geom::Rectangle srcRect, geom::Matrix transform) override;
+      
+      void destroyTexture(rendering::ITexture * texture) override;
+      
+   // Internal
+   protected:
+      bool recording();
+      void end();
+      
+      void textureUpdate(rendering::capture::Texture * texture, geom::Rectangle rect, uint8_t const* pixels);
+      void textureAlpha(rendering::capture::Texture * texture, float alpha);
+      void textureBlend(rendering::capture::Texture * texture, rendering::ITexture::BlendMode blend);
+      
+      void writeRectangle(const geom::Rectangle & rect);
+      
+   protected:
+      IRenderService * _target;
+      std::shared_ptr<flair::utils::ByteArray> _capture;
+      uint32_t _frames;
+      uint32_t _capturedFrames;
+      uint32_t _nextTextureId;
+      std::unordered_set<uint64_t> _storedPixels;
+   };
+   
+}}}}
+
+#endif
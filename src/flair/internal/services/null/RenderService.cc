@@ -0,0 +1,56 @@
+#include "flair/internal/services/null/RenderService.h"
+#include "flair/internal/rendering/null/Texture.h"
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace null {
+   
+   using namespace rendering;
+   
+   RenderService::RenderService()
+   {
+      
+   }
+   
+   RenderService::~RenderService()
+   {
+      
+   }
+   
+   void RenderService::create(IWindowService * windowService, bool vsync)
+   {
+      
+   }
+   
+   void RenderService::clear()
+   {
+      
+   }
+   
+   void RenderService::present()
+   {
+      
+   }
+   
+   ITexture * RenderService::createTexture(int width, int height, ITexture::PixelFormat format, ITexture::Type type)
+   {
+      return new rendering::null::Texture(width, height, format, type);
+   }
+   
+   void RenderService::renderTexture(ITexture * texture, geom::Rectangle srcRect, geom::Rectangle dstRect)
+   {
+      
+   }
+   
+   void RenderService::renderTexture(ITexture * texture, geom::Rectangle srcRect, geom::Matrix transform)
+   {
+      
+   }
+   
+   void RenderService::destroyTexture(ITexture * texture)
+   {
+      delete texture;
+   }
+   
+}}}}
@@ -0,0 +1,37 @@
+#ifndef flair_internal_services_null_RenderService_h
+#define flair_internal_services_null_RenderService_h
+
+#include "flair/internal/services/IRenderService.h"
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace null {
+   
+   // Accepts every call and draws nothing, a baseline for measuring the cost above the backend
+   class RenderService : public IRenderService
+   {
+   public:
+      RenderService();
+      virtual ~RenderService();
+      
+   // Methods
+   public:
+      void create(IWindowService * windowService, bool vsync = true) override;
+      
+      void clear() override;
+      
+      void present() override;
+      
+      rendering::ITexture * createTexture(int width, int height, rendering::ITexture::PixelFormat format, rendering::ITexture::Type type) override;
+      
+      void renderTexture(rendering::ITexture * texture, geom::Rectangle srcRect, geom::Rectangle dstRect) override;
+      
+      void renderTexture(rendering::ITexture * texture, geom::Rectangle srcRect, geom::Matrix transform) override;
+      
+      void destroyTexture(rendering::ITexture * texture) override;
+   };
+   
+}}}}
+
+#endif
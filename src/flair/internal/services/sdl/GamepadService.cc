@@ -0,0 +1,200 @@
+#include "flair/internal/services/sdl/GamepadService.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace {
+   using flair::ui::Gamepad;
+
+   const SDL_GameControllerButton buttonMap[Gamepad::_BUTTON_COUNT] = {
+      SDL_CONTROLLER_BUTTON_A,
+      SDL_CONTROLLER_BUTTON_B,
+      SDL_CONTROLLER_BUTTON_X,
+      SDL_CONTROLLER_BUTTON_Y,
+      SDL_CONTROLLER_BUTTON_BACK,
+      SDL_CONTROLLER_BUTTON_GUIDE,
+      SDL_CONTROLLER_BUTTON_START,
+      SDL_CONTROLLER_BUTTON_LEFTSTICK,
+      SDL_CONTROLLER_BUTTON_RIGHTSTICK,
+      SDL_CONTROLLER_BUTTON_LEFTSHOULDER,
+      SDL_CONTROLLER_BUTTON_RIGHTSHOULDER,
+      SDL_CONTROLLER_BUTTON_DPAD_UP,
+      SDL_CONTROLLER_BUTTON_DPAD_DOWN,
+      SDL_CONTROLLER_BUTTON_DPAD_LEFT,
+      SDL_CONTROLLER_BUTTON_DPAD_RIGHT
+   };
+
+   const SDL_GameControllerAxis axisMap[Gamepad::_AXIS_COUNT] = {
+      SDL_CONTROLLER_AXIS_LEFTX,
+      SDL_CONTROLLER_AXIS_LEFTY,
+      SDL_CONTROLLER_AXIS_RIGHTX,
+      SDL_CONTROLLER_AXIS_RIGHTY,
+      SDL_CONTROLLER_AXIS_TRIGGERLEFT,
+      SDL_CONTROLLER_AXIS_TRIGGERRIGHT
+   };
+
+   const std::chrono::milliseconds pollInterval(1);
+}
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace sdl {
+
+   GamepadService::GamepadService() : _open(false), _polling(false)
+   {
+      memset(_controllers, 0, sizeof(_controllers));
+      memset(_polled, 0, sizeof(_polled));
+      memset(_latched, 0, sizeof(_latched));
+   }
+
+   GamepadService::~GamepadService()
+   {
+      backgroundPolling(false);
+
+      for (auto & controller : _controllers) {
+         if (controller) SDL_GameControllerClose(controller);
+      }
+
+      if (_open) SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER);
+   }
+
+   bool GamepadService::backgroundPolling()
+   {
+      return _polling;
+   }
+
+   bool GamepadService::backgroundPolling(bool value)
+   {
+      if (value == _polling) return _polling;
+
+      if (value) open();
+
+      _polling = value;
+      if (value) {
+         _thread = std::thread(&GamepadService::poll, this);
+      }
+      else if (_thread.joinable()) {
+         _thread.join();
+      }
+
+      return _polling;
+   }
+
+   void GamepadService::open()
+   {
+      if (_open) return;
+
+      _open = true;
+      SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER);
+
+      // Devices attached already are opened right away and taken into the snapshot, so the call
+      // that opened the service sees them instead of waiting for the next poll. Their connected
+      // transitions are dispatched with this frame.
+      for (int deviceIndex = 0; deviceIndex < SDL_NumJoysticks(); ++deviceIndex) {
+         deviceAdded(deviceIndex);
+      }
+
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         SDL_GameControllerUpdate();
+      }
+      update(SDL_GetTicks());
+   }
+
+   void GamepadService::deviceAdded(int deviceIndex)
+   {
+      if (!SDL_IsGameController(deviceIndex)) return;
+
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      SDL_GameController * controller = SDL_GameControllerOpen(deviceIndex);
+      if (!controller) return;
+
+      // SDL reports devices that were already attached at startup, ignore a second open
+      SDL_JoystickID instanceId = SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(controller));
+      for (auto existing : _controllers) {
+         if (existing && SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(existing)) == instanceId) {
+            SDL_GameControllerClose(controller);
+            return;
+         }
+      }
+
+      for (auto & slot : _controllers) {
+         if (!slot) {
+            slot = controller;
+            return;
+         }
+      }
+
+      // More devices than slots
+      SDL_GameControllerClose(controller);
+   }
+
+   void GamepadService::deviceRemoved(int instanceId)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      for (uint32_t device = 0; device < Gamepad::MAX_DEVICES; ++device) {
+         auto & controller = _controllers[device];
+         if (controller && SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(controller)) == instanceId) {
+            SDL_GameControllerClose(controller);
+            controller = nullptr;
+            memset(&_polled[device], 0, sizeof(GamepadState));
+            _latched[device] = 0;
+         }
+      }
+   }
+
+   void GamepadService::read(uint32_t device, GamepadState * state)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      if (!_polling) {
+         sample(device, state);
+         return;
+      }
+
+      *state = _polled[device];
+      state->buttons |= _latched[device];
+      _latched[device] = 0;
+   }
+
+   void GamepadService::sample(uint32_t device, GamepadState * state)
+   {
+      memset(state, 0, sizeof(GamepadState));
+
+      SDL_GameController * controller = _controllers[device];
+      if (!controller) return;
+
+      state->connected = true;
+      for (uint32_t button = 0; button < Gamepad::_BUTTON_COUNT; ++button) {
+         if (SDL_GameControllerGetButton(controller, buttonMap[button])) {
+            state->buttons |= (1u << button);
+         }
+      }
+
+      for (uint32_t axis = 0; axis < Gamepad::_AXIS_COUNT; ++axis) {
+         float value = SDL_GameControllerGetAxis(controller, axisMap[axis]) / 32767.0f;
+         state->axes[axis] = value < -1.0f ? -1.0f : value;
+      }
+   }
+
+   void GamepadService::poll()
+   {
+      while (_polling) {
+         {
+            std::lock_guard<std::mutex> lock(_mutex);
+            SDL_GameControllerUpdate();
+
+            for (uint32_t device = 0; device < Gamepad::MAX_DEVICES; ++device) {
+               sample(device, &_polled[device]);
+               _latched[device] |= _polled[device].buttons;
+            }
+         }
+
+         std::this_thread::sleep_for(pollInterval);
+      }
+   }
+
+}}}}
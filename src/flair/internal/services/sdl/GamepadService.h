@@ -0,0 +1,54 @@
+#ifndef flair_internal_services_sdl_GamepadService_h
+#define flair_internal_services_sdl_GamepadService_h
+
+#include "flair/internal/services/base/GamepadService.h"
+
+#include "SDL.h"
+#undef ERROR
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace sdl {
+
+   class GamepadService : public base::GamepadService
+   {
+   public:
+      GamepadService();
+      virtual ~GamepadService();
+
+      bool backgroundPolling() override;
+      bool backgroundPolling(bool value) override;
+
+      void open() override;
+
+      void deviceAdded(int deviceIndex) override;
+      void deviceRemoved(int instanceId) override;
+
+   protected:
+      void read(uint32_t device, GamepadState * state) override;
+
+      void sample(uint32_t device, GamepadState * state);
+      void poll();
+
+   protected:
+      // The game controller subsystem is initialized by open(), not with the window
+      bool _open;
+      SDL_GameController * _controllers[flair::ui::Gamepad::MAX_DEVICES];
+
+      // Background polling: the thread keeps the latest snapshot and latches any button pressed
+      // since the last read, so taps shorter than a frame still produce a transition
+      std::mutex _mutex;
+      std::thread _thread;
+      std::atomic<bool> _polling;
+      GamepadState _polled[flair::ui::Gamepad::MAX_DEVICES];
+      uint32_t _latched[flair::ui::Gamepad::MAX_DEVICES];
+   };
+
+}}}}
+
+#endif
@@ -133,6 +133,13 @@ namespace internal {
 namespace services {
 namespace sdl {
    
+   KeyboardService::KeyboardService()
+   {
+      // Capacity survives clear(), so recording transitions does not allocate per frame
+      _transitions.reserve(32);
+      clear();
+   }
+   
    void KeyboardService::modifiers(int shift, int alt, int ctrl, int os)
    {
       _modifiers.shift = (shift < 0 ? -1 : shift > 0 ? 1 : 0);
@@ -149,11 +156,14 @@ namespace sdl {
       *os = _modifiers.os;
    }
    
-   void KeyboardService::key(uint32_t keyCode, int state)
+   void KeyboardService::key(uint32_t keyCode, int state, uint32_t timestamp)
    {
       keyCode = SDLtoKeyboard(keyCode);
       if (keyCode >= flair::ui::Keyboard::_KEY_COUNT) return;
       _keys[keyCode] = state;
+      
+      KeyTransition transition = { keyCode, state, timestamp, _modifiers.shift, _modifiers.alt, _modifiers.ctrl, _modifiers.os };
+      _transitions.push_back(transition);
    }
    
    void KeyboardService::key(uint32_t keyCode, int * state)
@@ -162,14 +172,21 @@ namespace sdl {
       *state = _keys[keyCode];
    }
    
-   void KeyboardService::activeKeys(std::function<void(uint32_t keyCode, int keyState)> callback)
+   void KeyboardService::transitions(std::function<void(const KeyTransition & transition)> callback)
    {
-      for (uint32_t i = 0; i < flair::ui::Keyboard::_KEY_COUNT; ++i )
-      {
-         if (_keys[i] != 0) callback(i, _keys[i]);
+      for (auto const& transition : _transitions) {
+         callback(transition);
       }
    }
    
+   void KeyboardService::replay(const KeyTransition & transition)
+   {
+      if (transition.keyCode >= flair::ui::Keyboard::_KEY_COUNT) return;
+      modifiers(transition.shift, transition.alt, transition.ctrl, transition.os);
+      _keys[transition.keyCode] = transition.state;
+      _transitions.push_back(transition);
+   }
+   
    bool KeyboardService::capsLock()
    {
       return (SDL_GetModState() & KMOD_CAPS);
@@ -184,6 +201,7 @@ namespace sdl {
    {
       memset(_keys, 0, sizeof(_keys));
       memset(&_modifiers, 0, sizeof(_modifiers));
+      _transitions.clear();
    }
    
 }}}}
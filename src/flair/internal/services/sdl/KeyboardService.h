@@ -4,6 +4,8 @@
 #include "flair/internal/services/IKeyboardService.h"
 #include "flair/ui/Keyboard.h"
 
+#include <vector>
+
 namespace flair {
 namespace internal {
 namespace services {
@@ -12,13 +14,17 @@ namespace sdl {
    class KeyboardService : public IKeyboardService
    {
    public:
+      KeyboardService();
+      
       void modifiers(int shift, int alt, int ctrl, int os) override;
       void modifiers(int * shift, int * alt, int * ctrl, int * os) override;
       
-      void key(uint32_t keyCode, int state) override;
+      void key(uint32_t keyCode, int state, uint32_t timestamp) override;
       void key(uint32_t keyCode, int * state) override;
       
-      void activeKeys(std::function<void(uint32_t keyCode, int keyState)> callback) override;
+      void transitions(std::function<void(const KeyTransition & transition)> callback) override;
+      
+      void replay(const KeyTransition & transition) override;
       
       bool capsLock() override;
       
@@ -36,6 +42,7 @@ namespace sdl {
       
       int _keys[flair::ui::Keyboard::_KEY_COUNT];
       Modifiers _modifiers;
+      std::vector<KeyTransition> _transitions;
    };
    
 }}}}
@@ -22,17 +22,37 @@ namespace internal {
 namespace services {
 namespace sdl {
    
-   MouseService::MouseService() : _location({0,0})
+   MouseService::MouseService() : _location({0,0}), _historyLength(0)
    {
       memset(_prevButtons, 0, sizeof(_prevButtons));
       memset(_buttons, 0, sizeof(_buttons));
+      _transitions.reserve(16);
       clear();
    }
    
-   void MouseService::movement(int X, int Y)
+   void MouseService::motion(int X, int Y, int movementX, int movementY, uint32_t timestamp)
    {
-      _movement.X = X;
-      _movement.Y = Y;
+      _location.X = X;
+      _location.Y = Y;
+      _movement.X += movementX;
+      _movement.Y += movementY;
+      
+      if (_historyLength == HISTORY_CAPACITY) {
+         auto & last = _history[_historyLength - 1];
+         last.localX = (float)X;
+         last.localY = (float)Y;
+         last.movementX += (float)movementX;
+         last.movementY += (float)movementY;
+         last.timestamp = timestamp;
+         return;
+      }
+      
+      auto & sample = _history[_historyLength++];
+      sample.localX = (float)X;
+      sample.localY = (float)Y;
+      sample.movementX = (float)movementX;
+      sample.movementY = (float)movementY;
+      sample.timestamp = timestamp;
    }
    
    void MouseService::movement(int * X, int * Y)
@@ -41,6 +61,12 @@ namespace sdl {
       *Y = _movement.Y;
    }
    
+   void MouseService::history(flair::events::MouseEvent::Sample const** samples, size_t * length)
+   {
+      *samples = _history;
+      *length = _historyLength;
+   }
+   
    void MouseService::location(int X, int Y)
    {
       _location.X = X;
@@ -53,11 +79,15 @@ namespace sdl {
       *Y = _location.Y;
    }
    
-   void MouseService::button(uint32_t buttonCode, int state)
+   void MouseService::button(uint32_t buttonCode, int state, uint32_t timestamp)
    {
       buttonCode = SDLtoMouse(buttonCode);
       if (buttonCode >= _BUTTON_COUNT) return;
       _buttons[buttonCode] = state;
+      
+      ButtonTransition transition = { buttonCode, state, _prevButtons[buttonCode], timestamp, _location.X, _location.Y };
+      _transitions.push_back(transition);
+      _prevButtons[buttonCode] = state;
    }
    
    void MouseService::button(uint32_t buttonCode, int * state)
@@ -66,20 +96,30 @@ namespace sdl {
       *state = _buttons[buttonCode];
    }
    
-   
-   void MouseService::buttonStates(std::function<void(uint32_t buttonCode, int currentState, int previousState)> callback)
+   void MouseService::buttonTransitions(std::function<void(const ButtonTransition & transition)> callback)
    {
-      for (uint32_t i = 0; i < _BUTTON_COUNT; ++i )
-      {
-         callback(i, _buttons[i], _prevButtons[i]);
+      for (auto const& transition : _transitions) {
+         callback(transition);
       }
    }
    
+   void MouseService::replay(const ButtonTransition & transition)
+   {
+      if (transition.buttonCode >= _BUTTON_COUNT) return;
+      _location.X = transition.X;
+      _location.Y = transition.Y;
+      _buttons[transition.buttonCode] = transition.state;
+      _prevButtons[transition.buttonCode] = transition.state;
+      _transitions.push_back(transition);
+   }
+   
    void MouseService::clear()
    {
-      memcpy(_prevButtons, _buttons, sizeof(_prevButtons));
+      // _prevButtons keeps the last known state of each button across frames
       memset(_buttons, 0, sizeof(_buttons));
       memset(&_movement, 0, sizeof(_movement));
+      _transitions.clear();
+      _historyLength = 0;
    }
    
 }}}}
\ No newline at end of file
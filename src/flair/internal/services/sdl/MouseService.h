@@ -4,6 +4,8 @@
 #include "flair/internal/services/IMouseService.h"
 #include "flair/ui/Keyboard.h"
 
+#include <vector>
+
 namespace flair {
 namespace internal {
 namespace services {
@@ -14,16 +16,20 @@ namespace sdl {
    public:
       MouseService();
       
-      void movement(int X, int Y) override;
+      void motion(int X, int Y, int movementX, int movementY, uint32_t timestamp) override;
       void movement(int * X, int * Y) override;
       
+      void history(flair::events::MouseEvent::Sample const** samples, size_t * length) override;
+      
       void location(int X, int Y) override;
       void location(int * X, int * Y) override;
       
-      void button(uint32_t buttonCode, int state) override;
+      void button(uint32_t buttonCode, int state, uint32_t timestamp) override;
       void button(uint32_t buttonCode, int * state) override;
       
-      void buttonStates(std::function<void(uint32_t buttonCode, int currentState, int previousState)> callback) override;
+      void buttonTransitions(std::function<void(const ButtonTransition & transition)> callback) override;
+      
+      void replay(const ButtonTransition & transition) override;
       
       void clear() override;
       
@@ -35,9 +41,15 @@ namespace sdl {
       
       int _buttons[IMouseService::_BUTTON_COUNT];
       int _prevButtons[IMouseService::_BUTTON_COUNT];
+      std::vector<ButtonTransition> _transitions;
       
       Position _movement;
       Position _location;
+      
+      // Fixed capacity so high polling rate mice never allocate, overflow folds into the last sample
+      static const size_t HISTORY_CAPACITY = 256;
+      flair::events::MouseEvent::Sample _history[HISTORY_CAPACITY];
+      size_t _historyLength;
    };
    
 }}}}
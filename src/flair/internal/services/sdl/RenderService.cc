@@ -1,6 +1,7 @@
 #include "flair/internal/services/sdl/RenderService.h"
 #include "flair/internal/services/sdl/WindowService.h"
 #include "flair/internal/rendering/sdl/Texture.h"
+#include "flair/internal/utils/Profiler.h"
 
 #include <cmath>
 
@@ -45,6 +46,7 @@ namespace sdl {
    
    void RenderService::present()
    {
+      FLAIR_PROFILE_ZONE("present");
       SDL_RenderPresent(_renderer);
    }
    
@@ -0,0 +1,83 @@
+#include "flair/internal/services/sdl/TouchService.h"
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace sdl {
+   
+   TouchService::TouchService() : _activeLength(0), _primaryId(0), _hasPrimary(false), _changedLength(0)
+   {
+      
+   }
+   
+   size_t TouchService::activePoints()
+   {
+      return _activeLength;
+   }
+   
+   void TouchService::touch(int64_t touchId, int phase, float X, float Y, float pressure, uint32_t timestamp)
+   {
+      size_t active = 0;
+      while (active < _activeLength && _active[active] != touchId) ++active;
+      
+      // Every active contact keeps room for its end in the changed list, so ends are never dropped
+      if (phase == TouchPoint::BEGIN) {
+         if (active < _activeLength || _activeLength == MAX_TOUCH_POINTS) return;
+         if (_changedLength + _activeLength + 2 > MAX_CHANGED_POINTS) return;
+         
+         _active[_activeLength++] = touchId;
+         if (!_hasPrimary) {
+            _primaryId = touchId;
+            _hasPrimary = true;
+         }
+      }
+      else if (active == _activeLength) {
+         // Contact began while the table was full
+         return;
+      }
+      
+      bool primary = _hasPrimary && _primaryId == touchId;
+      if (phase == TouchPoint::END) {
+         _active[active] = _active[--_activeLength];
+         if (primary) _hasPrimary = false;
+      }
+      
+      // Fold motion into the pending entry of the same contact, keeping its phase
+      if (phase == TouchPoint::MOVE) {
+         for (size_t i = _changedLength; i > 0; --i) {
+            TouchPoint & pending = _changed[i - 1];
+            if (pending.touchId == touchId) {
+               if (pending.phase == TouchPoint::END) break;
+               pending.X = X;
+               pending.Y = Y;
+               pending.pressure = pressure;
+               pending.timestamp = timestamp;
+               return;
+            }
+         }
+         
+         if (_changedLength + _activeLength + 1 > MAX_CHANGED_POINTS) return;
+      }
+      
+      TouchPoint & point = _changed[_changedLength++];
+      point.touchId = touchId;
+      point.phase = phase;
+      point.primary = primary;
+      point.X = X;
+      point.Y = Y;
+      point.pressure = pressure;
+      point.timestamp = timestamp;
+   }
+   
+   void TouchService::points(TouchPoint const** points, size_t * length)
+   {
+      *points = _changed;
+      *length = _changedLength;
+   }
+   
+   void TouchService::clear()
+   {
+      _changedLength = 0;
+   }
+   
+}}}}
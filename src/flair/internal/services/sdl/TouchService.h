@@ -0,0 +1,37 @@
+#ifndef flair_internal_services_sdl_TouchService_h
+#define flair_internal_services_sdl_TouchService_h
+
+#include "flair/internal/services/ITouchService.h"
+
+namespace flair {
+namespace internal {
+namespace services {
+namespace sdl {
+   
+   class TouchService : public ITouchService
+   {
+   public:
+      TouchService();
+      
+      size_t activePoints() override;
+      
+      void touch(int64_t touchId, int phase, float X, float Y, float pressure, uint32_t timestamp) override;
+      
+      void points(TouchPoint const** points, size_t * length) override;
+      
+      void clear() override;
+      
+   protected:
+      // Contacts currently down, looked up by a linear scan which beats hashing at this size
+      int64_t _active[MAX_TOUCH_POINTS];
+      size_t _activeLength;
+      int64_t _primaryId;
+      bool _hasPrimary;
+      
+      TouchPoint _changed[MAX_CHANGED_POINTS];
+      size_t _changedLength;
+   };
+   
+}}}}
+
+#endif
@@ -1,4 +1,5 @@
 #include "flair/internal/services/sdl/WindowService.h"
+#include "flair/internal/utils/Profiler.h"
 
 namespace flair {
 namespace internal {
@@ -7,13 +8,18 @@ namespace sdl {
    
    WindowService::WindowService() :
       _rootWindow(false), _active(false), _closing(false), _quiting(false),
-      _minimized(false), _maximized(false), _fullscreen(false), _window(nullptr)
+      _minimized(false), _maximized(false), _fullscreen(false), _hidden(false), _window(nullptr), _woken(false)
    {
       static bool initialized = false;
       if (!initialized) {
-         SDL_Init(SDL_INIT_EVERYTHING);
+         // Video brings events along, the other subsystems are initialized by the services
+         // that use them when first needed
+         SDL_Init(SDL_INIT_VIDEO);
          initialized = true;
       }
+      
+      _wakeEvent = SDL_RegisterEvents(1);
+      if (_wakeEvent == (uint32_t)-1) _wakeEvent = SDL_USEREVENT;
    }
    
    WindowService::~WindowService()
@@ -66,6 +72,16 @@ namespace sdl {
       return _fullscreen;
    }
    
+   bool WindowService::visible()
+   {
+      return !_hidden && !_minimized;
+   }
+   
+   uint32_t WindowService::ticks()
+   {
+      return SDL_GetTicks();
+   }
+   
    SDL_Window * WindowService::window()
    {
       return _window;
@@ -117,6 +133,7 @@ namespace sdl {
       
       _rootWindow = root;
       _window = SDL_CreateWindow(title.c_str(), x, y, width, height, sdlFlags);
+      _bounds = geom::Rectangle(bounds.x(), bounds.y(), width, height);
       
       if (_window == nullptr) {
          printf("Could not create window: %s\n", SDL_GetError());
@@ -188,9 +205,17 @@ namespace sdl {
    
    void WindowService::poll(IGamepadService * gamepadService, ITouchService * touchService, IMouseService * mouseService, IKeyboardService * keyboardService)
    {
+      FLAIR_PROFILE_ZONE("WindowService::poll");
+      
       if (!_rootWindow) return;
       if (keyboardService) keyboardService->clear();
       if (mouseService) mouseService->clear();
+      if (gamepadService) gamepadService->clear();
+      if (touchService) touchService->clear();
+      
+      // Finger positions are normalized to the window
+      int windowWidth = 0, windowHeight = 0;
+      if (touchService) SDL_GetWindowSize(_window, &windowWidth, &windowHeight);
       
       SDL_Event event;
       while (SDL_PollEvent(&event)) {
@@ -207,7 +232,7 @@ namespace sdl {
                      (event.key.keysym.mod & KMOD_LCTRL) ? -1 : (event.key.keysym.mod & KMOD_RCTRL) ? 1 : 0,
                      (event.key.keysym.mod & KMOD_LGUI) ? -1 : (event.key.keysym.mod & KMOD_RGUI) ? 1 : 0
                   );
-                  if (!event.key.repeat) keyboardService->key(event.key.keysym.sym, -1);
+                  if (!event.key.repeat) keyboardService->key(event.key.keysym.sym, -1, event.key.timestamp);
                }
             } break;
                
@@ -219,35 +244,64 @@ namespace sdl {
                      (event.key.keysym.mod & KMOD_LCTRL) ? -1 : (event.key.keysym.mod & KMOD_RCTRL) ? 1 : 0,
                      (event.key.keysym.mod & KMOD_LGUI) ? -1 : (event.key.keysym.mod & KMOD_RGUI) ? 1 : 0
                   );
-                  keyboardService->key(event.key.keysym.sym, 1);
+                  keyboardService->key(event.key.keysym.sym, 1, event.key.timestamp);
                }
             } break;
             
 				case SDL_MOUSEBUTTONDOWN: {
 					if (mouseService) {
-                  mouseService->button(event.button.button, -event.button.clicks);
+                  mouseService->location(event.button.x, event.button.y);
+                  mouseService->button(event.button.button, -event.button.clicks, event.button.timestamp);
 					}
 				} break;
 					
 				case SDL_MOUSEBUTTONUP: {
 					if (mouseService) {
-						mouseService->button(event.button.button, event.button.clicks);
+                  mouseService->location(event.button.x, event.button.y);
+						mouseService->button(event.button.button, event.button.clicks, event.button.timestamp);
 					}
 				} break;
             
 				case SDL_MOUSEMOTION: {
 					if (mouseService) {
-                  int x, y;
-                  SDL_GetMouseState(&x, &y);
-                  mouseService->location(x, y);
-                  
-                  mouseService->movement(event.motion.x, event.motion.y);
+                  mouseService->motion(event.motion.x, event.motion.y, event.motion.xrel, event.motion.yrel, event.motion.timestamp);
 					}
 				} break;
                
+            case SDL_FINGERDOWN:
+            case SDL_FINGERMOTION:
+            case SDL_FINGERUP: {
+               if (touchService) {
+                  int phase = event.type == SDL_FINGERDOWN ? TouchPoint::BEGIN : event.type == SDL_FINGERUP ? TouchPoint::END : TouchPoint::MOVE;
+                  touchService->touch(event.tfinger.fingerId, phase, event.tfinger.x * windowWidth, event.tfinger.y * windowHeight, event.tfinger.pressure, event.tfinger.timestamp);
+               }
+            } break;
+               
+            case SDL_CONTROLLERDEVICEADDED: {
+               if (gamepadService) gamepadService->deviceAdded(event.cdevice.which);
+            } break;
+               
+            case SDL_CONTROLLERDEVICEREMOVED: {
+               if (gamepadService) gamepadService->deviceRemoved(event.cdevice.which);
+            } break;
+               
             case SDL_WINDOWEVENT: {
                switch (event.window.event) {
                   case SDL_WINDOWEVENT_SHOWN:
+                     _hidden = false;
+                     break;
+                  case SDL_WINDOWEVENT_HIDDEN:
+                     _hidden = true;
+                     break;
+                  case SDL_WINDOWEVENT_MINIMIZED:
+                     _minimized = true;
+                     break;
+                  case SDL_WINDOWEVENT_MAXIMIZED:
+                     _minimized = false;
+                     _maximized = true;
+                     break;
+                  case SDL_WINDOWEVENT_RESTORED:
+                     _minimized = _maximized = false;
                      break;
                   case SDL_WINDOWEVENT_CLOSE:
                      break;
@@ -255,6 +309,34 @@ namespace sdl {
             } break;
          }
       }
+      
+      // Button and axis state is read once per frame rather than per event
+      if (gamepadService) gamepadService->update(SDL_GetTicks());
+   }
+   
+   void WindowService::wait(int timeout)
+   {
+      // The event of an earlier wake may already have been taken by poll
+      if (_woken.exchange(false)) return;
+      
+      // Without an event to fill in SDL leaves the event in the queue for poll
+      if (timeout < 0) {
+         SDL_WaitEvent(nullptr);
+      }
+      else {
+         SDL_WaitEventTimeout(nullptr, timeout);
+      }
+      _woken = false;
+   }
+   
+   void WindowService::wake()
+   {
+      if (_woken.exchange(true)) return;
+      
+      SDL_Event event;
+      SDL_zero(event);
+      event.type = _wakeEvent;
+      SDL_PushEvent(&event);
    }
    
 
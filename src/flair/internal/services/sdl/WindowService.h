@@ -6,6 +6,7 @@
 #include "SDL.h"
 #undef ERROR
 
+#include <atomic>
 #include <string>
 
 namespace flair {
@@ -35,6 +36,10 @@ namespace sdl {
       
       bool fullscreen() override;
       
+      bool visible() override;
+      
+      uint32_t ticks() override;
+      
       SDL_Window * window();
       
       
@@ -54,6 +59,10 @@ namespace sdl {
       
       void poll(IGamepadService * gamepadService, ITouchService * touchService, IMouseService * mouseService, IKeyboardService * keyboardService) override;
       
+      void wait(int timeout) override;
+      
+      void wake() override;
+      
    // Internal
    private:
       bool _rootWindow;
@@ -67,8 +76,13 @@ namespace sdl {
       bool _minimized;
       bool _maximized;
       bool _fullscreen;
+      bool _hidden;
       
       SDL_Window * _window;
+      
+      // User event pushed by wake(), only the first wake after a wait pushes one
+      uint32_t _wakeEvent;
+      std::atomic<bool> _woken;
    };
    
 }}}}
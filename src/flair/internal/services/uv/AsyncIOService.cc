@@ -1,5 +1,8 @@
 #include "flair/internal/services/uv/AsyncIOService.h"
+#include "flair/internal/utils/Profiler.h"
+#include "flair/system/Memory.h"
 
+#include <chrono>
 #include <fcntl.h>
 #include <sys/stat.h>
 
@@ -8,6 +11,42 @@
 #define S_IWUSR S_IWRITE
 #endif
 
+namespace {
+   using flair::internal::services::IAsyncIORequest;
+   
+   const char * requestName(IAsyncIORequest::Type type)
+   {
+      switch (type) {
+         case IAsyncIORequest::Type::FILE_OPEN: return "file open";
+         case IAsyncIORequest::Type::FILE_CLOSE: return "file close";
+         case IAsyncIORequest::Type::FILE_READ: return "file read";
+         case IAsyncIORequest::Type::FILE_WRITE: return "file write";
+         case IAsyncIORequest::Type::FILE_STAT: return "file stat";
+         case IAsyncIORequest::Type::FILE_RENAME: return "file rename";
+         case IAsyncIORequest::Type::FILE_DELETE: return "file delete";
+         case IAsyncIORequest::Type::FILE_DIR_REMOVE: return "directory remove";
+         case IAsyncIORequest::Type::FILE_DIR_MAKE: return "directory make";
+         case IAsyncIORequest::Type::FILE_DIR_MAKE_TEMP: return "directory make temp";
+         case IAsyncIORequest::Type::FILE_DIR_SCAN: return "directory scan";
+         case IAsyncIORequest::Type::WORKER: return "worker job";
+         default: return "io request";
+      }
+   }
+   
+   const size_t READ_BUFFER_SIZE = 65536;
+   
+   flair::system::MemoryCounter & readBuffers()
+   {
+      static flair::system::MemoryCounter * counter = new flair::system::MemoryCounter(flair::system::MemoryCategory::IO_BUFFER, "file read buffers", READ_BUFFER_SIZE);
+      return *counter;
+   }
+   
+   uint64_t timestamp()
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+   }
+}
+
 namespace flair {
 namespace internal {
 namespace services {
@@ -15,7 +54,9 @@ namespace uv {
    
    using flair::events::Event;
    
-   AsyncIOService::AsyncIOService() : uv(nullptr), inboundIORequests(128), outboundIORequests(128), contextPool(128)
+   AsyncIOService::AsyncIOService() : uv(nullptr), inboundIORequests(128), outboundIORequests(128), contextPool(128),
+      contextsInUse(0), contextCount(128), inFlight(0), windowBegin(timestamp()), windowBytes(0), windowRequests(0),
+      windowJobs(0), bytesPerSecond(0.0f), requestsPerSecond(0.0f), jobsPerSecond(0.0f)
    {
       eventDispatcher = flair::make_shared<flair::events::EventDispatcher>();
       
@@ -37,8 +78,45 @@ namespace uv {
       thread.join();
    }
    
+   void AsyncIOService::stats(flair::system::IOStats & stats)
+   {
+      roll(timestamp());
+      
+      stats.inboundDepth = inboundIORequests.size_approx();
+      stats.outboundDepth = outboundIORequests.size_approx();
+      stats.inFlight = inFlight;
+      stats.contextsInUse = contextsInUse;
+      stats.contexts = contextCount;
+      
+      stats.bytesPerSecond = bytesPerSecond;
+      stats.requestsPerSecond = requestsPerSecond;
+      stats.jobsPerSecond = jobsPerSecond;
+      
+      stats.requests.clear();
+      for (auto & entry : requestMetrics) {
+         flair::system::IORequestStats requestStats;
+         requestStats.type = requestName(entry.first);
+         requestStats.requests = entry.second.requests;
+         requestStats.errors = entry.second.errors;
+         requestStats.bytes = entry.second.bytes;
+         requestStats.wait = flair::internal::utils::latencyStats(entry.second.wait);
+         requestStats.execute = flair::internal::utils::latencyStats(entry.second.execute);
+         requestStats.delivery = flair::internal::utils::latencyStats(entry.second.delivery);
+         requestStats.total = flair::internal::utils::latencyStats(entry.second.total);
+         stats.requests.push_back(requestStats);
+      }
+   }
+   
    void AsyncIOService::enqueue(std::shared_ptr<IAsyncIORequest> request)
    {
+      // Reads come back for every chunk, only a new request starts its lifecycle
+      if (request->id() == SIZE_MAX) FLAIR_PROFILE_ASYNC_BEGIN(requestName(request->type()), request.get());
+      
+      IAsyncIORequest::Timestamps timestamps = {};
+      timestamps.enqueued = timestamp();
+      request->timestamps(timestamps);
+      ++inFlight;
+      
       inboundIORequests.enqueue(request);
       
       asyncDequeueHandle.data = this;
@@ -47,8 +125,13 @@ namespace uv {
    
    void AsyncIOService::poll()
    {
+      FLAIR_PROFILE_ZONE("AsyncIOService::poll");
+      
       std::shared_ptr<IAsyncIORequest> request;
       while (outboundIORequests.try_dequeue(request)) {
+         if (request->complete() || request->error() != 0) FLAIR_PROFILE_ASYNC_END(requestName(request->type()), request.get());
+         record(request);
+         
          if (request->complete()) {
             dispatchEvent(flair::make_shared<AsyncIOEvent>(Event::COMPLETE, request));
          }
@@ -62,21 +145,38 @@ namespace uv {
       }
    }
    
+   void AsyncIOService::notify(std::function<void()> callback)
+   {
+      std::lock_guard<std::mutex> lock(notifyMutex);
+      notifyCallback = callback;
+   }
+   
+   void AsyncIOService::resetStats()
+   {
+      requestMetrics.clear();
+      
+      windowBegin = timestamp();
+      windowBytes = windowRequests = windowJobs = 0;
+      bytesPerSecond = requestsPerSecond = jobsPerSecond = 0.0f;
+   }
+   
    uint32_t AsyncIOService::popContextId()
    {
       if (contextStack.empty()) {
-         size_t size = contextPool.size() >> 2;
+         size_t size = contextPool.size() << 1;
          assert(size > contextPool.size());
          if (size <= contextPool.size()) throw std::exception();
          
-         for (int i = contextPool.size(); i < size; ++i) {
+         for (size_t i = contextPool.size(); i < size; ++i) {
             contextStack.push(i);
          }
          contextPool.resize(size);
+         contextCount = size;
       }
       
       uint32_t id = contextStack.top();
       contextStack.pop();
+      ++contextsInUse;
       
       return id;
    }
@@ -84,6 +184,70 @@ namespace uv {
    void AsyncIOService::pushContextId(uint32_t id)
    {
       contextStack.push(id);
+      --contextsInUse;
+   }
+   
+   void AsyncIOService::respond(std::shared_ptr<IAsyncIORequest> request)
+   {
+      FLAIR_PROFILE_ASYNC_STEP("respond", request.get());
+      
+      // A worker job has its own completion time from the pool thread
+      auto timestamps = request->timestamps();
+      if (timestamps.completed == 0) {
+         timestamps.completed = timestamp();
+         request->timestamps(timestamps);
+      }
+      
+      outboundIORequests.enqueue(request);
+      
+      std::lock_guard<std::mutex> lock(notifyMutex);
+      if (notifyCallback) notifyCallback();
+   }
+   
+   void AsyncIOService::record(std::shared_ptr<IAsyncIORequest> const& request)
+   {
+      --inFlight;
+      
+      auto timestamps = request->timestamps();
+      timestamps.delivered = timestamp();
+      request->timestamps(timestamps);
+      
+      auto type = request->type();
+      auto & metrics = requestMetrics[type];
+      ++metrics.requests;
+      if (request->error() != 0) ++metrics.errors;
+      
+      metrics.wait.record((timestamps.started - timestamps.enqueued) / 1000);
+      metrics.execute.record((timestamps.completed - timestamps.started) / 1000);
+      metrics.delivery.record((timestamps.delivered - timestamps.completed) / 1000);
+      metrics.total.record((timestamps.delivered - timestamps.enqueued) / 1000);
+      
+      // A read hands back every chunk it filled and then completes empty
+      uint64_t bytes = 0;
+      if (request->error() == 0 && ((type == IAsyncIORequest::Type::FILE_READ && !request->complete()) || (type == IAsyncIORequest::Type::FILE_WRITE && request->complete()))) {
+         auto fileRequest = std::dynamic_pointer_cast<IAsyncFileRequest>(request);
+         if (fileRequest) bytes = fileRequest->length();
+      }
+      metrics.bytes += bytes;
+      
+      roll(timestamps.delivered);
+      windowBytes += bytes;
+      ++windowRequests;
+      if (type == IAsyncIORequest::Type::WORKER && request->complete()) ++windowJobs;
+   }
+   
+   void AsyncIOService::roll(uint64_t now)
+   {
+      uint64_t elapsed = now - windowBegin;
+      if (elapsed < 1000000000) return;
+      
+      double seconds = elapsed / 1e9;
+      bytesPerSecond = static_cast<float>(windowBytes / seconds);
+      requestsPerSecond = static_cast<float>(windowRequests / seconds);
+      jobsPerSecond = static_cast<float>(windowJobs / seconds);
+      
+      windowBegin = now;
+      windowBytes = windowRequests = windowJobs = 0;
    }
    
    void AsyncIOService::addEventListener(std::string type, std::function<void(std::shared_ptr<flair::events::Event>)> listener, bool useCapture, int32_t priority, bool once)
@@ -113,6 +277,8 @@ namespace uv {
    
    void AsyncIOService::eventLoop()
    {
+      FLAIR_PROFILE_THREAD("io");
+      
       uv = (uv_loop_t*)std::malloc(sizeof(uv_loop_t));
       uv_loop_init(uv);
       
@@ -134,8 +300,16 @@ namespace uv {
    
    void AsyncIOService::asyncDequeue(uv_async_t *handle)
    {
+      FLAIR_PROFILE_ZONE("AsyncIOService::dequeue");
+      
       std::shared_ptr<IAsyncIORequest> request;
       while (inboundIORequests.try_dequeue(request)) {
+         FLAIR_PROFILE_ASYNC_STEP("submit", request.get());
+         
+         auto timestamps = request->timestamps();
+         timestamps.started = timestamp();
+         request->timestamps(timestamps);
+         
          switch (request->type()) {
                
             case IAsyncIORequest::Type::FILE_OPEN: {
@@ -204,8 +378,9 @@ namespace uv {
                   context = &contextPool[id];
                   context->req.data = this; fileRequest->id(id);
                   
-                  fileRequest->data(new uint8_t[65536]);
-                  context->buffer = uv_buf_init((char*)fileRequest->data(), 65536);
+                  fileRequest->data(new uint8_t[READ_BUFFER_SIZE]);
+                  context->buffer = uv_buf_init((char*)fileRequest->data(), READ_BUFFER_SIZE);
+                  readBuffers().acquire();
                }
                else {
                   context = &contextPool[id];
@@ -279,7 +454,7 @@ namespace uv {
       uv_fs_req_cleanup(req);
       pushContextId(fileRequest->id()); fileRequest->id(SIZE_MAX);
       
-      outboundIORequests.enqueue(asyncIORequest);
+      respond(asyncIORequest);
    }
    
    void AsyncIOService::openFile(uv_fs_t * req, std::shared_ptr<IAsyncIORequest> asyncIORequest)
@@ -296,7 +471,7 @@ namespace uv {
       uv_fs_req_cleanup(req);
       pushContextId(fileRequest->id()); fileRequest->id(SIZE_MAX);
       
-      outboundIORequests.enqueue(asyncIORequest);
+      respond(asyncIORequest);
    }
    
    void AsyncIOService::readFile(uv_fs_t * req, std::shared_ptr<IAsyncIORequest> asyncIORequest)
@@ -312,13 +487,14 @@ namespace uv {
          uv_fs_req_cleanup(req);
          pushContextId(fileRequest->id()); fileRequest->id(SIZE_MAX);
          
-         delete fileRequest->data();
-         delete fileRequest->data(nullptr);
+         delete[] fileRequest->data();
+         fileRequest->data(nullptr);
+         readBuffers().release();
          
          fileRequest->complete(true);
       }
    
-      outboundIORequests.enqueue(asyncIORequest);
+      respond(asyncIORequest);
    }
    
    void AsyncIOService::writeFile(uv_fs_t * req, std::shared_ptr<IAsyncIORequest> asyncIORequest)
@@ -329,7 +505,7 @@ namespace uv {
       uv_fs_req_cleanup(req);
       pushContextId(fileRequest->id()); fileRequest->id(SIZE_MAX);
       
-      outboundIORequests.enqueue(asyncIORequest);
+      respond(asyncIORequest);
    }
    
    void AsyncIOService::closeFile(uv_fs_t * req, std::shared_ptr<IAsyncIORequest> asyncIORequest)
@@ -345,14 +521,20 @@ namespace uv {
       uv_fs_req_cleanup(req);
       pushContextId(fileRequest->id()); fileRequest->id(SIZE_MAX);
       
-      outboundIORequests.enqueue(asyncIORequest);
+      respond(asyncIORequest);
    }
    
    void AsyncIOService::beginWorker(uv_work_t * req, std::shared_ptr<IAsyncIORequest> asyncIORequest)
    {
+      FLAIR_PROFILE_THREAD("uv worker");
+      FLAIR_PROFILE_ZONE("worker job");
+      
       auto workerRequest = std::dynamic_pointer_cast<IAsyncWorkerRequest>(asyncIORequest);
       std::shared_ptr<IAsyncWorkerRequest::IWorkerResult> result = nullptr;
       
+      auto timestamps = workerRequest->timestamps();
+      timestamps.started = timestamp();
+      
       try {
          result = workerRequest->worker()();
       }
@@ -361,6 +543,9 @@ namespace uv {
       }
       
       workerRequest->result(result);
+      
+      timestamps.completed = timestamp();
+      workerRequest->timestamps(timestamps);
    }
    
    void AsyncIOService::endWorker(uv_work_t * req, std::shared_ptr<IAsyncIORequest> asyncIORequest)
@@ -370,14 +555,14 @@ namespace uv {
       
       pushContextId(workerRequest->id()); workerRequest->id(SIZE_MAX);
       
-      outboundIORequests.enqueue(asyncIORequest);
+      respond(asyncIORequest);
    }
    
    
 // AsyncIORequest
    
    
-   AsyncIORequest::AsyncIORequest(IAsyncIORequest::Type type) : _type(type), _id(SIZE_MAX), _error(0), _complete(false)
+   AsyncIORequest::AsyncIORequest(IAsyncIORequest::Type type) : _type(type), _id(SIZE_MAX), _error(0), _complete(false), _timestamps()
    {
       
    }
@@ -421,5 +606,15 @@ namespace uv {
    {
       return _complete = value;
    }
+   
+   IAsyncIORequest::Timestamps AsyncIORequest::timestamps()
+   {
+      return _timestamps;
+   }
+   
+   IAsyncIORequest::Timestamps AsyncIORequest::timestamps(Timestamps value)
+   {
+      return _timestamps = value;
+   }
 
 }}}}
@@ -5,15 +5,17 @@
 #include "flair/net/FileReference.h"
 #include "flair/internal/services/IAsyncIOService.h"
 #include "flair/internal/utils/ConcurrentQueue.h"
+#include "flair/internal/utils/Histogram.h"
 
 #include "uv.h"
 #undef ERROR
 
 #include <thread>
 #include <atomic>
-#include <vector>
+#include <deque>
 #include <stack>
 #include <map>
+#include <mutex>
 
 namespace flair {
 namespace internal {
@@ -39,11 +41,15 @@ namespace uv {
       bool complete() override;
       bool complete(bool value) override;
       
+      Timestamps timestamps() override;
+      Timestamps timestamps(Timestamps value) override;
+      
    protected:
       IAsyncIORequest::Type _type;
       size_t _id;
       int _error;
       bool _complete;
+      Timestamps _timestamps;
       void * _ptr;
    };
    
@@ -77,11 +83,18 @@ namespace uv {
       AsyncIOService();
       ~AsyncIOService();
       
+   public:
+      void stats(flair::system::IOStats & stats) override;
+      
    public:
       void enqueue(std::shared_ptr<IAsyncIORequest> request) override;
       
       void poll() override;
       
+      void notify(std::function<void()> callback) override;
+      
+      void resetStats() override;
+      
    public:
       void addEventListener(std::string type, std::function<void(std::shared_ptr<flair::events::Event>)> listener, bool useCapture = false, int32_t priority = 0, bool once = false) override;
       
@@ -106,15 +119,55 @@ namespace uv {
       ConcurrentQueue<std::shared_ptr<IAsyncIORequest>> inboundIORequests;
       ConcurrentQueue<std::shared_ptr<IAsyncIORequest>> outboundIORequests;
       
-      std::vector<Context> contextPool;
+      // A deque so the contexts libuv holds on to stay put when the pool grows
+      std::deque<Context> contextPool;
       std::stack<uint32_t> contextStack;
+      std::atomic<size_t> contextsInUse;
+      std::atomic<size_t> contextCount;
       
       std::map<void *, std::shared_ptr<IAsyncIORequest>> pendingIORequests;
       
+      // Held while the callback runs, so once notify() returns the previous one is never called
+      std::mutex notifyMutex;
+      std::function<void()> notifyCallback;
+      
+      // Latencies in microseconds, recorded on the main thread as poll delivers
+      struct RequestMetrics
+      {
+         RequestMetrics() : requests(0), errors(0), bytes(0) {}
+         
+         uint64_t requests;
+         uint64_t errors;
+         uint64_t bytes;
+         flair::internal::utils::Histogram wait;
+         flair::internal::utils::Histogram execute;
+         flair::internal::utils::Histogram delivery;
+         flair::internal::utils::Histogram total;
+      };
+      std::map<IAsyncIORequest::Type, RequestMetrics> requestMetrics;
+      std::atomic<size_t> inFlight;
+      
+      // Deliveries of the current throughput window, the rates are those of the last one
+      uint64_t windowBegin;
+      uint64_t windowBytes;
+      uint64_t windowRequests;
+      uint64_t windowJobs;
+      float bytesPerSecond;
+      float requestsPerSecond;
+      float jobsPerSecond;
+      
    protected:
       uint32_t popContextId();
       void pushContextId(uint32_t id);
       
+      // Hands a request back to the main thread for poll
+      void respond(std::shared_ptr<IAsyncIORequest> request);
+      
+      void record(std::shared_ptr<IAsyncIORequest> const& request);
+      
+      // Closes the throughput window once it spans a second
+      void roll(uint64_t now);
+      
    private:
       void eventLoop();
       
@@ -102,7 +102,7 @@ namespace uv {
 // AsyncFileRequest
    
    
-   AsyncFileRequest::AsyncFileRequest(IAsyncIORequest::Type type, std::shared_ptr<FileReference> fileReference) : _type(type), _id(SIZE_MAX), _error(0), _complete(false), _fileReference(fileReference), _path(""), _handle(-1), _flags(0), _data(nullptr), _offset(0), _length(0)
+   AsyncFileRequest::AsyncFileRequest(IAsyncIORequest::Type type, std::shared_ptr<FileReference> fileReference) : _type(type), _id(SIZE_MAX), _error(0), _complete(false), _timestamps(), _fileReference(fileReference), _path(""), _handle(-1), _flags(0), _data(nullptr), _offset(0), _length(0)
    {
       _stats.created = std::time(nullptr);
       _stats.modified = std::time(nullptr);
@@ -218,5 +218,15 @@ namespace uv {
    {
       return _complete = value;
    }
+   
+   IAsyncIORequest::Timestamps AsyncFileRequest::timestamps()
+   {
+      return _timestamps;
+   }
+   
+   IAsyncIORequest::Timestamps AsyncFileRequest::timestamps(Timestamps value)
+   {
+      return _timestamps = value;
+   }
 
 }}}}
\ No newline at end of file
@@ -53,11 +53,15 @@ namespace uv {
       bool complete() override;
       bool complete(bool value) override;
       
+      Timestamps timestamps() override;
+      Timestamps timestamps(Timestamps value) override;
+      
    protected:
       Type _type;
       size_t _id;
       int _error;
       bool _complete;
+      Timestamps _timestamps;
       std::shared_ptr<flair::net::FileReference> _fileReference;
       std::string _path;
       FileHandle _handle;
@@ -1,5 +1,7 @@
 #include "flair/internal/services/uv/WorkerService.h"
 
+#include <chrono>
+
 namespace flair {
 namespace internal {
 namespace services {
@@ -7,14 +9,22 @@ namespace uv {
    
    using flair::events::Event;
    
-   WorkerService::WorkerService() : asyncIOService(nullptr)
+   WorkerService::WorkerService() : asyncIOService(nullptr), parallelPool(nullptr)
    {
       
    }
    
    WorkerService::~WorkerService()
    {
+      delete parallelPool;
+   }
+   
+   void WorkerService::stats(flair::system::IOStats & stats)
+   {
+      stats.pendingJobs = asyncCallbacks.size();
       
+      std::lock_guard<std::mutex> lock(parallelMutex);
+      stats.parallelLoops = flair::internal::utils::latencyStats(parallelLoops);
    }
    
    void WorkerService::init(IAsyncIOService * asyncIOService)
@@ -32,6 +42,24 @@ namespace uv {
       asyncIOService->enqueue(std::static_pointer_cast<IAsyncIORequest>(request));
    }
    
+   void WorkerService::parallelFor(size_t count, size_t grain, std::function<void(size_t begin, size_t end)> body)
+   {
+      if (!parallelPool) parallelPool = new flair::internal::utils::ThreadPool();
+      
+      auto begin = std::chrono::steady_clock::now();
+      parallelPool->parallelFor(count, grain, body);
+      auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+      
+      std::lock_guard<std::mutex> lock(parallelMutex);
+      parallelLoops.record(elapsed);
+   }
+   
+   void WorkerService::resetStats()
+   {
+      std::lock_guard<std::mutex> lock(parallelMutex);
+      parallelLoops.reset();
+   }
+   
    void WorkerService::onAsyncIORequest(std::shared_ptr<flair::events::Event> event)
    {
       auto asyncEvent = std::dynamic_pointer_cast<AsyncIOEvent>(event);
@@ -57,7 +85,7 @@ namespace uv {
    // AsyncWorkerRequest
    
    
-   AsyncWorkerRequest::AsyncWorkerRequest() : _type(IAsyncIORequest::Type::WORKER), _id(SIZE_MAX), _error(0), _complete(false),
+   AsyncWorkerRequest::AsyncWorkerRequest() : _type(IAsyncIORequest::Type::WORKER), _id(SIZE_MAX), _error(0), _complete(false), _timestamps(),
       _result(nullptr), _worker(nullptr)
    {
       
@@ -115,5 +143,15 @@ namespace uv {
    {
       return _complete = value;
    }
+   
+   IAsyncIORequest::Timestamps AsyncWorkerRequest::timestamps()
+   {
+      return _timestamps;
+   }
+   
+   IAsyncIORequest::Timestamps AsyncWorkerRequest::timestamps(Timestamps value)
+   {
+      return _timestamps = value;
+   }
 
 }}}}
@@ -3,8 +3,11 @@
 
 #include "flair/net/FileReference.h"
 #include "flair/internal/services/IWorkerService.h"
+#include "flair/internal/utils/ThreadPool.h"
+#include "flair/internal/utils/Histogram.h"
 
 #include <map>
+#include <mutex>
 #include <memory>
 #include <functional>
 
@@ -36,11 +39,15 @@ namespace uv {
       bool complete() override;
       bool complete(bool value) override;
       
+      Timestamps timestamps() override;
+      Timestamps timestamps(Timestamps value) override;
+      
    protected:
       Type _type;
       size_t _id;
       int _error;
       bool _complete;
+      Timestamps _timestamps;
       std::shared_ptr<IWorkerResult> _result;
       std::function<std::shared_ptr<IWorkerResult>()> _worker;
       
@@ -54,17 +61,32 @@ namespace uv {
       WorkerService();
       virtual ~WorkerService();
       
+   public:
+      void stats(flair::system::IOStats & stats) override;
+      
    public:
       void init(IAsyncIOService * asyncIOService) override;
       
       void execute(std::function<std::shared_ptr<IAsyncWorkerRequest::IWorkerResult>()> worker, std::function<void(std::shared_ptr<IAsyncWorkerRequest>)> callback) override;
       
+      void parallelFor(size_t count, size_t grain, std::function<void(size_t begin, size_t end)> body) override;
+      
+      void resetStats() override;
+      
    protected:
       void onAsyncIORequest(std::shared_ptr<flair::events::Event> event);
       
    protected:
       IAsyncIOService * asyncIOService;
       std::map<std::shared_ptr<AsyncWorkerRequest>, std::function<void(std::shared_ptr<IAsyncWorkerRequest>)>> asyncCallbacks;
+      
+      // Kept apart from the libuv pool so a parallel loop never waits behind file I/O, started
+      // with the first loop
+      flair::internal::utils::ThreadPool * parallelPool;
+      
+      // Microseconds per loop, loops may start on any thread
+      std::mutex parallelMutex;
+      flair::internal::utils::Histogram parallelLoops;
    };
    
 }}}}
@@ -0,0 +1,125 @@
+#include "flair/internal/utils/Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+   // Values below LINEAR get a bucket each, every power of two above is split in SUB_BUCKETS
+   const uint64_t LINEAR = 32;
+   const uint32_t SUB_BITS = 4;
+   const uint64_t SUB_BUCKETS = 1 << SUB_BITS;
+   
+   // Enough for every 64 bit value
+   const size_t BUCKETS = LINEAR + (64 - SUB_BITS - 1) * SUB_BUCKETS;
+}
+
+namespace flair {
+namespace internal {
+namespace utils {
+   
+   Histogram::Histogram() : _counts(BUCKETS, 0), _count(0), _min(UINT64_MAX), _max(0), _sum(0.0)
+   {
+   
+   }
+   
+   uint64_t Histogram::count() const
+   {
+      return _count;
+   }
+   
+   uint64_t Histogram::min() const
+   {
+      return _count ? _min : 0;
+   }
+   
+   uint64_t Histogram::max() const
+   {
+      return _max;
+   }
+   
+   double Histogram::mean() const
+   {
+      return _count ? _sum / _count : 0.0;
+   }
+   
+   uint64_t Histogram::percentile(double fraction) const
+   {
+      if (_count == 0) return 0;
+      
+      fraction = std::min(std::max(fraction, 0.0), 1.0);
+      uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * _count)));
+      
+      uint64_t seen = 0;
+      for (size_t i = 0; i < BUCKETS; ++i) {
+         seen += _counts[i];
+         if (seen >= rank) return std::min(std::max(highest(i), _min), _max);
+      }
+      return _max;
+   }
+   
+   void Histogram::record(uint64_t value)
+   {
+      ++_counts[bucket(value)];
+      ++_count;
+      _min = std::min(_min, value);
+      _max = std::max(_max, value);
+      _sum += static_cast<double>(value);
+   }
+   
+   void Histogram::merge(Histogram const& other)
+   {
+      for (size_t i = 0; i < BUCKETS; ++i) {
+         _counts[i] += other._counts[i];
+      }
+      _count += other._count;
+      _min = std::min(_min, other._min);
+      _max = std::max(_max, other._max);
+      _sum += other._sum;
+   }
+   
+   void Histogram::reset()
+   {
+      std::fill(_counts.begin(), _counts.end(), 0);
+      _count = 0;
+      _min = UINT64_MAX;
+      _max = 0;
+      _sum = 0.0;
+   }
+   
+   size_t Histogram::bucket(uint64_t value)
+   {
+      if (value < LINEAR) return static_cast<size_t>(value);
+      
+      // Shift the value down until only the top SUB_BITS + 1 bits are left
+      uint32_t shift = 1;
+      while ((value >> shift) >= 2 * SUB_BUCKETS) ++shift;
+      
+      return static_cast<size_t>(LINEAR + (shift - 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS));
+   }
+   
+   uint64_t Histogram::highest(size_t bucket)
+   {
+      if (bucket < LINEAR) return bucket;
+      
+      uint32_t shift = static_cast<uint32_t>((bucket - LINEAR) / SUB_BUCKETS) + 1;
+      uint64_t top = (bucket - LINEAR) % SUB_BUCKETS + SUB_BUCKETS + 1;
+      
+      // The last bucket ends at the top of the range
+      if (shift + SUB_BITS + 1 >= 64 && top == 2 * SUB_BUCKETS) return UINT64_MAX;
+      return (top << shift) - 1;
+   }
+   
+   flair::system::LatencyStats latencyStats(Histogram const& microseconds)
+   {
+      flair::system::LatencyStats stats;
+      stats.count = microseconds.count();
+      stats.min = microseconds.min() / 1000.0f;
+      stats.mean = static_cast<float>(microseconds.mean() / 1000.0);
+      stats.p50 = microseconds.percentile(0.5) / 1000.0f;
+      stats.p90 = microseconds.percentile(0.9) / 1000.0f;
+      stats.p99 = microseconds.percentile(0.99) / 1000.0f;
+      stats.max = microseconds.max() / 1000.0f;
+      return stats;
+   }
+   
+}}}
@@ -0,0 +1,61 @@
+#ifndef flair_internal_utils_Histogram_h
+#define flair_internal_utils_Histogram_h
+
+#include "flair/system/IOStats.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace flair {
+namespace internal {
+namespace utils {
+   
+   // Counts values in log-linear buckets the way HDR histograms do: exact below 32, above that
+   // 16 buckets per power of two, so any value is kept within 1/16 of itself at a fixed size no
+   // matter how many values are recorded. Not thread safe.
+   class Histogram
+   {
+   public:
+      Histogram();
+      
+   // Properties
+   public:
+      uint64_t count() const;
+      
+      uint64_t min() const;
+      uint64_t max() const;
+      double mean() const;
+      
+      // The value below which fraction of the recorded values fall, rounded up to the top of its
+      // bucket and never past max. 0 when nothing was recorded.
+      uint64_t percentile(double fraction) const;
+      
+   // Methods
+   public:
+      void record(uint64_t value);
+      
+      void merge(Histogram const& other);
+      
+      void reset();
+      
+   private:
+      static size_t bucket(uint64_t value);
+      
+      // Largest value that lands in bucket
+      static uint64_t highest(size_t bucket);
+      
+   private:
+      std::vector<uint64_t> _counts;
+      uint64_t _count;
+      uint64_t _min;
+      uint64_t _max;
+      double _sum;
+   };
+   
+   // Summarizes a histogram of microseconds in milliseconds
+   flair::system::LatencyStats latencyStats(Histogram const& microseconds);
+   
+}}}
+
+#endif
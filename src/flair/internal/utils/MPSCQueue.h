@@ -0,0 +1,113 @@
+#ifndef flair_internal_utils_MPSCQueue_h
+#define flair_internal_utils_MPSCQueue_h
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace flair {
+namespace internal {
+namespace utils {
+   
+   // A lock-free queue for any number of producer threads and a single consumer thread, based on
+   // Dmitry Vyukov's MPSC node queue. A push is one atomic exchange and never waits on
+   // other producers or the consumer. A producer that was preempted between linking its node and
+   // publishing it briefly hides the nodes pushed after it; the consumer sees them on its next pop.
+   template <typename T>
+   class MPSCQueue
+   {
+   public:
+      MPSCQueue() : _head(new Node()), _size(0)
+      {
+         _tail = _head.load(std::memory_order_relaxed);
+      }
+      
+      // Not safe while any thread is still pushing
+      ~MPSCQueue()
+      {
+         while (_tail) {
+            Node * next = _tail->next.load(std::memory_order_relaxed);
+            delete _tail;
+            _tail = next;
+         }
+      }
+      
+      MPSCQueue(MPSCQueue const&) = delete;
+      MPSCQueue& operator=(MPSCQueue const&) = delete;
+      
+   // Methods
+   public:
+      // Safe from any thread. Returns true when the queue was empty before, so only the first of
+      // a burst of producers has to wake the consumer.
+      bool push(T value)
+      {
+         // Counted before linking so the size never trails what the consumer can see
+         bool wasEmpty = _size.fetch_add(1, std::memory_order_acq_rel) == 0;
+         
+         Node * node = new Node(std::move(value));
+         Node * previous = _head.exchange(node, std::memory_order_acq_rel);
+         previous->next.store(node, std::memory_order_release);
+         return wasEmpty;
+      }
+      
+      // Consumer thread only. Moves the oldest value into result, returns false if none is visible.
+      bool pop(T & result)
+      {
+         Node * next = _tail->next.load(std::memory_order_acquire);
+         if (!next) return false;
+         
+         // next becomes the new stub, its value is spent
+         result = std::move(next->value);
+         next->value = T();
+         delete _tail;
+         _tail = next;
+         
+         _size.fetch_sub(1, std::memory_order_acq_rel);
+         return true;
+      }
+      
+      // Consumer thread only. Pops at most the values pushed before the call, so producers that
+      // keep pushing from inside the callback can't hold the consumer in the loop.
+      template <typename F>
+      size_t drain(F callback)
+      {
+         size_t pending = _size.load(std::memory_order_acquire);
+         size_t count = 0;
+         
+         T value;
+         while (count < pending && pop(value)) {
+            callback(value);
+            value = T();
+            ++count;
+         }
+         
+         return count;
+      }
+      
+      // Approximate while producers are pushing
+      size_t size_approx() const
+      {
+         return _size.load(std::memory_order_relaxed);
+      }
+      
+   private:
+      struct Node
+      {
+         Node() : next(nullptr) {}
+         Node(T&& value) : next(nullptr), value(std::move(value)) {}
+         
+         std::atomic<Node*> next;
+         T value;
+      };
+      
+      // Producers swing the head, the consumer owns the tail. Kept on separate cache lines so
+      // pushing doesn't keep invalidating the consumer.
+      std::atomic<Node*> _head;
+      char _padding[64 - sizeof(std::atomic<Node*>)];
+      Node * _tail;
+      std::atomic<size_t> _size;
+   };
+   
+}}}
+
+#endif
@@ -0,0 +1,238 @@
+#include "flair/internal/utils/Profiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+namespace {
+   using flair::internal::utils::ProfileEvent;
+   
+   const size_t CHUNK_EVENTS = 1024;
+   
+   struct Chunk
+   {
+      Chunk() : count(0), next(nullptr) {}
+      
+      ProfileEvent events[CHUNK_EVENTS];
+      
+      // Published by the recording thread, the chunk isn't touched by it again once next is set
+      std::atomic<size_t> count;
+      std::atomic<Chunk*> next;
+   };
+   
+   struct ThreadBuffer
+   {
+      uint32_t thread;
+      std::atomic<const char *> name;
+      
+      // Recording thread only
+      Chunk * tail;
+      
+      // write() only
+      Chunk * head;
+      size_t consumed;
+      
+      ThreadBuffer * next;
+   };
+   
+   // Buffers are never freed, a thread that exits leaves its last chunk behind
+   std::atomic<ThreadBuffer*> buffers(nullptr);
+   std::atomic<uint32_t> nextThread(0);
+   
+   std::mutex writeMutex;
+   
+   const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+   
+   ThreadBuffer * threadBuffer()
+   {
+      static thread_local ThreadBuffer * buffer = nullptr;
+      if (buffer) return buffer;
+      
+      buffer = new ThreadBuffer();
+      buffer->thread = nextThread++;
+      buffer->name = nullptr;
+      buffer->tail = buffer->head = new Chunk();
+      buffer->consumed = 0;
+      
+      buffer->next = buffers.load(std::memory_order_relaxed);
+      while (!buffers.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed));
+      return buffer;
+   }
+   
+   void writeString(std::ostream & out, const char * value)
+   {
+      out << '"';
+      for (const char * c = value; *c; ++c) {
+         if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+         }
+         else if ((unsigned char)*c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+            out << escaped;
+         }
+         else {
+            out << *c;
+         }
+      }
+      out << '"';
+   }
+   
+   void writeTime(std::ostream & out, uint64_t nanoseconds)
+   {
+      // Microseconds with the nanoseconds as fraction
+      char time[32];
+      snprintf(time, sizeof(time), "%llu.%03u", (unsigned long long)(nanoseconds / 1000), (unsigned)(nanoseconds % 1000));
+      out << time;
+   }
+}
+
+namespace flair {
+namespace internal {
+namespace utils {
+   
+   std::atomic<bool> Profiler::_recording(false);
+   
+   void Profiler::start()
+   {
+      _recording = true;
+   }
+   
+   void Profiler::stop()
+   {
+      _recording = false;
+   }
+   
+   uint64_t Profiler::now()
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count() + 1;
+   }
+   
+   void Profiler::threadName(const char * name)
+   {
+      threadBuffer()->name = name;
+   }
+   
+   void Profiler::complete(const char * name, uint64_t begin, uint64_t end, const char * detail)
+   {
+      ProfileEvent event;
+      event.name = name;
+      event.begin = begin;
+      event.end = end;
+      event.id = 0;
+      event.phase = 'X';
+      event.detail[0] = '\0';
+      if (detail) copyDetail(event.detail, detail);
+      record(event);
+   }
+   
+   void Profiler::async(char phase, const char * name, uint64_t id)
+   {
+      if (!recording()) return;
+      
+      ProfileEvent event;
+      event.name = name;
+      event.begin = event.end = now();
+      event.id = id;
+      event.phase = phase;
+      event.detail[0] = '\0';
+      record(event);
+   }
+   
+   void Profiler::copyDetail(char * to, const char * detail)
+   {
+      strncpy(to, detail, sizeof(ProfileEvent::detail) - 1);
+      to[sizeof(ProfileEvent::detail) - 1] = '\0';
+   }
+   
+   void Profiler::record(ProfileEvent const& event)
+   {
+      ThreadBuffer * buffer = threadBuffer();
+      Chunk * chunk = buffer->tail;
+      
+      size_t count = chunk->count.load(std::memory_order_relaxed);
+      if (count == CHUNK_EVENTS) {
+         Chunk * next = new Chunk();
+         chunk->next.store(next, std::memory_order_release);
+         buffer->tail = chunk = next;
+         count = 0;
+      }
+      
+      chunk->events[count] = event;
+      chunk->count.store(count + 1, std::memory_order_release);
+   }
+   
+   void Profiler::write(std::ostream & out)
+   {
+      std::lock_guard<std::mutex> lock(writeMutex);
+      
+      out << "{\"traceEvents\":[";
+      bool first = true;
+      
+      for (ThreadBuffer * buffer = buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+         const char * name = buffer->name.load();
+         if (name) {
+            out << (first ? "\n" : ",\n");
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread << ",\"args\":{\"name\":";
+            writeString(out, name);
+            out << "}}";
+            first = false;
+         }
+         
+         Chunk * chunk = buffer->head;
+         while (true) {
+            size_t count = chunk->count.load(std::memory_order_acquire);
+            for (size_t i = buffer->consumed; i < count; ++i) {
+               ProfileEvent const& event = chunk->events[i];
+               
+               out << (first ? "\n" : ",\n");
+               out << "{\"name\":";
+               writeString(out, event.name);
+               out << ",\"cat\":\"flair\",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << buffer->thread << ",\"ts\":";
+               writeTime(out, event.begin);
+               
+               if (event.phase == 'X') {
+                  out << ",\"dur\":";
+                  writeTime(out, event.end - event.begin);
+               }
+               else {
+                  char id[24];
+                  snprintf(id, sizeof(id), "0x%llx", (unsigned long long)event.id);
+                  out << ",\"id\":\"" << id << "\"";
+               }
+               
+               if (event.detail[0]) {
+                  out << ",\"args\":{\"detail\":";
+                  writeString(out, event.detail);
+                  out << "}";
+               }
+               out << "}";
+               first = false;
+            }
+            buffer->consumed = count;
+            
+            // A full chunk with a successor is done with, the recording thread moved on
+            Chunk * next = chunk->next.load(std::memory_order_acquire);
+            if (count < CHUNK_EVENTS || !next) break;
+            
+            delete chunk;
+            buffer->head = chunk = next;
+            buffer->consumed = 0;
+         }
+      }
+      
+      out << "\n]}\n";
+   }
+   
+   bool Profiler::write(std::string const& path)
+   {
+      std::ofstream file(path);
+      if (!file) return false;
+      
+      write(file);
+      return file.good();
+   }
+   
+}}}
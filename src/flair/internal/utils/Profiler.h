@@ -0,0 +1,131 @@
+#ifndef flair_internal_utils_Profiler_h
+#define flair_internal_utils_Profiler_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Profiling zones are compiled in with FLAIR_PROFILE (premake --profile) and cost one relaxed
+// load while not recording. Names have to be string literals, a detail is copied.
+#ifdef FLAIR_PROFILE
+   #define FLAIR_PROFILE_CONCAT_(a, b) a##b
+   #define FLAIR_PROFILE_CONCAT(a, b) FLAIR_PROFILE_CONCAT_(a, b)
+   
+   // Times the rest of the enclosing scope
+   #define FLAIR_PROFILE_ZONE(name) flair::internal::utils::ProfileZone FLAIR_PROFILE_CONCAT(profileZone, __LINE__)(name)
+   
+   // The detail, such as an event type, is only evaluated while recording
+   #define FLAIR_PROFILE_ZONE_DETAIL(name, value) FLAIR_PROFILE_ZONE(name); if (!FLAIR_PROFILE_CONCAT(profileZone, __LINE__).active()) {} else FLAIR_PROFILE_CONCAT(profileZone, __LINE__).detail(value)
+   
+   // Work that crosses threads, such as an I/O request, matched up by id
+   #define FLAIR_PROFILE_ASYNC_BEGIN(name, id) flair::internal::utils::Profiler::async('b', name, reinterpret_cast<uint64_t>(id))
+   #define FLAIR_PROFILE_ASYNC_STEP(name, id) flair::internal::utils::Profiler::async('n', name, reinterpret_cast<uint64_t>(id))
+   #define FLAIR_PROFILE_ASYNC_END(name, id) flair::internal::utils::Profiler::async('e', name, reinterpret_cast<uint64_t>(id))
+   
+   #define FLAIR_PROFILE_THREAD(name) flair::internal::utils::Profiler::threadName(name)
+#else
+   #define FLAIR_PROFILE_ZONE(name) ((void)0)
+   #define FLAIR_PROFILE_ZONE_DETAIL(name, value) ((void)0)
+   #define FLAIR_PROFILE_ASYNC_BEGIN(name, id) ((void)0)
+   #define FLAIR_PROFILE_ASYNC_STEP(name, id) ((void)0)
+   #define FLAIR_PROFILE_ASYNC_END(name, id) ((void)0)
+   #define FLAIR_PROFILE_THREAD(name) ((void)0)
+#endif
+
+namespace flair {
+namespace internal {
+namespace utils {
+   
+   struct ProfileEvent
+   {
+      const char * name;
+      uint64_t begin;
+      uint64_t end;
+      uint64_t id;
+      char phase;
+      char detail[31];
+   };
+   
+   // Collects profiling events into one buffer per thread. A thread appends to its own chunk
+   // and publishes each event with a release store of the count, so recording never takes a
+   // lock. write() picks up what was published since the last write and frees the chunks it
+   // finished, threads may keep recording meanwhile.
+   class Profiler
+   {
+   public:
+      static void start();
+      static void stop();
+      
+      static bool recording()
+      {
+         return _recording.load(std::memory_order_relaxed);
+      }
+      
+      // Nanoseconds on the profiler clock
+      static uint64_t now();
+      
+      // Names the calling thread in the trace, name has to outlive the profiler
+      static void threadName(const char * name);
+      
+      static void complete(const char * name, uint64_t begin, uint64_t end, const char * detail = nullptr);
+      static void async(char phase, const char * name, uint64_t id);
+      
+      // Truncates to the size of ProfileEvent::detail
+      static void copyDetail(char * to, const char * detail);
+      
+      // Writes the events recorded since the last write in the chrome://tracing format
+      static void write(std::ostream & out);
+      static bool write(std::string const& path);
+      
+   private:
+      static void record(ProfileEvent const& event);
+      
+      static std::atomic<bool> _recording;
+   };
+   
+   class ProfileZone
+   {
+   public:
+      ProfileZone(const char * name) : _name(name), _begin(0)
+      {
+         if (!Profiler::recording()) return;
+         
+         _detail[0] = '\0';
+         _begin = Profiler::now();
+      }
+      
+      ~ProfileZone()
+      {
+         if (_begin) Profiler::complete(_name, _begin, Profiler::now(), _detail);
+      }
+      
+      bool active() const
+      {
+         return _begin != 0;
+      }
+      
+      // Copied right away, a detail is often a temporary
+      void detail(const char * value)
+      {
+         if (_begin) Profiler::copyDetail(_detail, value);
+      }
+      
+      void detail(std::string const& value)
+      {
+         detail(value.c_str());
+      }
+      
+      ProfileZone(ProfileZone const&) = delete;
+      ProfileZone& operator=(ProfileZone const&) = delete;
+      
+   private:
+      const char * _name;
+      uint64_t _begin;
+      char _detail[sizeof(ProfileEvent::detail)];
+   };
+   
+}}}
+
+#endif
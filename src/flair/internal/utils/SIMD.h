@@ -0,0 +1,17 @@
+#ifndef flair_internal_utils_SIMD_h
+#define flair_internal_utils_SIMD_h
+
+// Selects the vector instruction set used by the batch geometry kernels.
+// Define FLAIR_SIMD_DISABLE to force the scalar paths (useful when comparing results).
+
+#if !defined(FLAIR_SIMD_DISABLE)
+   #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+      #define FLAIR_SIMD_SSE2 1
+      #include <emmintrin.h>
+   #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+      #define FLAIR_SIMD_NEON 1
+      #include <arm_neon.h>
+   #endif
+#endif
+
+#endif
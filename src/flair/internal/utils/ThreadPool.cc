@@ -0,0 +1,134 @@
+#include "flair/internal/utils/ThreadPool.h"
+#include "flair/internal/utils/Profiler.h"
+
+#include <algorithm>
+
+namespace {
+   // Ranges per thread when the caller leaves the grain to the pool, a few per thread lets
+   // threads that finish early help out with the rest
+   const size_t RANGES_PER_THREAD = 4;
+}
+
+namespace flair {
+namespace internal {
+namespace utils {
+   
+   ThreadPool::ThreadPool(size_t threads) : _generation(0), _stopping(false), _job(nullptr)
+   {
+      _threads.reserve(threads);
+      for (size_t i = 0; i < threads; ++i) {
+         _threads.push_back(std::thread(&ThreadPool::run, this));
+      }
+   }
+   
+   ThreadPool::~ThreadPool()
+   {
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _stopping = true;
+      }
+      _wake.notify_all();
+      
+      for (auto & thread : _threads) {
+         thread.join();
+      }
+   }
+   
+   size_t ThreadPool::concurrency() const
+   {
+      return _threads.size() + 1;
+   }
+   
+   void ThreadPool::parallelFor(size_t count, size_t grain, std::function<void(size_t begin, size_t end)> const& body)
+   {
+      if (count == 0) return;
+      
+      if (grain == 0) grain = std::max<size_t>(1, count / (concurrency() * RANGES_PER_THREAD));
+      
+      std::unique_lock<std::mutex> busy(_busy, std::try_to_lock);
+      if (!busy.owns_lock() || _threads.empty() || count <= grain) {
+         body(0, count);
+         return;
+      }
+      
+      Job job;
+      job.body = &body;
+      job.count = count;
+      job.grain = grain;
+      job.next = 0;
+      job.completed = 0;
+      job.participants = 1;
+      
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _job = &job;
+         ++_generation;
+      }
+      _wake.notify_all();
+      
+      work(&job);
+      
+      // The job lives on this stack, so wait for every thread that joined it to let go
+      {
+         std::unique_lock<std::mutex> lock(_mutex);
+         _done.wait(lock, [&job]() { return job.completed == job.count && job.participants == 0; });
+         _job = nullptr;
+      }
+      
+      if (job.exception) std::rethrow_exception(job.exception);
+   }
+   
+   void ThreadPool::run()
+   {
+      FLAIR_PROFILE_THREAD("pool");
+      
+      uint64_t generation = 0;
+      while (true) {
+         Job * job = nullptr;
+         {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this, generation]() { return _stopping || (_job && _generation != generation); });
+            if (_stopping) return;
+            
+            generation = _generation;
+            job = _job;
+            ++job->participants;
+         }
+         
+         work(job);
+      }
+   }
+   
+   void ThreadPool::work(Job * job)
+   {
+      FLAIR_PROFILE_ZONE("ThreadPool::work");
+      
+      size_t completed = 0;
+      std::exception_ptr exception;
+      
+      while (true) {
+         size_t begin = job->next.fetch_add(job->grain);
+         if (begin >= job->count) break;
+         
+         size_t end = std::min(begin + job->grain, job->count);
+         try {
+            (*job->body)(begin, end);
+         }
+         catch (...) {
+            if (!exception) exception = std::current_exception();
+         }
+         completed += end - begin;
+      }
+      
+      bool finished;
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         if (exception && !job->exception) job->exception = exception;
+         job->completed += completed;
+         --job->participants;
+         finished = job->completed == job->count && job->participants == 0;
+      }
+      if (finished) _done.notify_all();
+   }
+   
+}}}
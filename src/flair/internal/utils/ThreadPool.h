@@ -0,0 +1,75 @@
+#ifndef flair_internal_utils_ThreadPool_h
+#define flair_internal_utils_ThreadPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace flair {
+namespace internal {
+namespace utils {
+   
+   // A fixed set of threads that run data parallel loops together with the calling thread.
+   // Ranges are claimed with one atomic increment each, so the pool balances uneven work
+   // without a queue per thread.
+   class ThreadPool
+   {
+   public:
+      // Defaults to one thread less than the hardware has, the caller is the last one
+      ThreadPool(size_t threads = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+      ~ThreadPool();
+      
+      ThreadPool(ThreadPool const&) = delete;
+      ThreadPool& operator=(ThreadPool const&) = delete;
+      
+   // Properties
+   public:
+      // Threads taking part in a loop, including the caller
+      size_t concurrency() const;
+      
+   // Methods
+   public:
+      // Calls body over [0, count) split into ranges of at most grain indices, or of an even
+      // share per thread when grain is 0, and returns once every range ran. Which thread runs a
+      // range is unspecified, a body that only writes its own indices gives the same result on
+      // any number of threads. The first exception thrown by body is rethrown here. A loop
+      // started while the pool is busy, from inside a body or another thread, runs inline.
+      void parallelFor(size_t count, size_t grain, std::function<void(size_t begin, size_t end)> const& body);
+      
+   private:
+      struct Job
+      {
+         std::function<void(size_t begin, size_t end)> const* body;
+         size_t count;
+         size_t grain;
+         std::atomic<size_t> next;
+         size_t completed;
+         size_t participants;
+         std::exception_ptr exception;
+      };
+      
+      void run();
+      void work(Job * job);
+      
+   private:
+      std::vector<std::thread> _threads;
+      
+      std::mutex _mutex;
+      std::condition_variable _wake;
+      std::condition_variable _done;
+      uint64_t _generation;
+      bool _stopping;
+      Job * _job;
+      
+      // Held for the duration of a loop, nested loops fail to take it and run inline
+      std::mutex _busy;
+   };
+   
+}}}
+
+#endif
@@ -0,0 +1,27 @@
+#include "flair/internal/utils/TypeName.h"
+
+#include <cstdlib>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace flair {
+namespace internal {
+namespace utils {
+   
+   std::string typeName(const char * name)
+   {
+#if defined(__GNUG__)
+      int status = 0;
+      char * demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+      if (status == 0 && demangled) {
+         std::string result(demangled);
+         std::free(demangled);
+         return result;
+      }
+#endif
+      return name;
+   }
+   
+}}}
@@ -0,0 +1,15 @@
+#ifndef flair_internal_utils_TypeName_h
+#define flair_internal_utils_TypeName_h
+
+#include <string>
+
+namespace flair {
+namespace internal {
+namespace utils {
+   
+   // The readable form of a type_info name, the name itself where the ABI has no demangler
+   std::string typeName(const char * name);
+   
+}}}
+
+#endif
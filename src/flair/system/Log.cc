@@ -0,0 +1,406 @@
+#include "flair/system/Log.h"
+#include "flair/system/Memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+   using flair::system::LogArgument;
+   using flair::system::LogLevel;
+   
+   const size_t RING_SIZE = 1 << 16;
+   // Room for a padding header wherever a record ends
+   const size_t ALIGNMENT = 16;
+   
+   // Longer strings are cut, a message never takes more than a quarter of a ring
+   const size_t MAX_STRING = 4096;
+   const size_t MAX_RECORD = RING_SIZE / 4;
+   
+   const uint8_t PADDING = 0xff;
+   
+   struct RecordHeader
+   {
+      uint32_t size;
+      uint8_t level;
+      uint8_t reserved;
+      uint16_t arguments;
+      uint64_t time;
+   };
+   
+   // Single producer, the owning thread, and single consumer, whoever holds drainMutex
+   struct Ring
+   {
+      std::atomic<size_t> head;
+      std::atomic<size_t> tail;
+      
+      // Cleared by the owning thread as it exits, a thread that starts logging takes the ring
+      // over once it is drained
+      std::atomic<bool> owned;
+      
+      Ring * next;
+      uint8_t data[RING_SIZE];
+   };
+   
+   // Rings are never freed, there are only ever as many as threads logging at the same time
+   std::atomic<Ring*> rings(nullptr);
+   std::atomic<int> threshold(0);
+   std::atomic<uint64_t> dropped(0);
+   
+   // Once the log thread is gone, at exit, every message is written right away
+   std::atomic<bool> stopped(false);
+   
+   // Set by the first message after the log thread cleared it, so a burst of messages wakes the
+   // thread once
+   std::atomic<bool> signalled(false);
+   
+   std::mutex drainMutex;
+   uint64_t reportedDropped = 0;
+   std::string output;
+   
+   struct Record
+   {
+      uint64_t time;
+      size_t sequence;
+      uint8_t const* bytes;
+   };
+   std::vector<Record> pending;
+   
+   flair::system::MemoryCounter & ringCounter()
+   {
+      static flair::system::MemoryCounter * counter = new flair::system::MemoryCounter(flair::system::MemoryCategory::IO_BUFFER, "log buffers");
+      return *counter;
+   }
+   
+   void releaseRing(Ring * ring)
+   {
+      ring->owned.store(false, std::memory_order_release);
+   }
+   
+   Ring * claimRing()
+   {
+      for (Ring * ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+         bool owned = false;
+         if (ring->owned.load(std::memory_order_relaxed) || !ring->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) continue;
+         
+         // Messages of the thread that left still take up room, the ring goes back until the
+         // log thread got to them
+         if (ring->head.load(std::memory_order_acquire) == ring->tail.load(std::memory_order_relaxed)) return ring;
+         releaseRing(ring);
+      }
+      
+      Ring * ring = new Ring();
+      ring->head = 0;
+      ring->tail = 0;
+      ring->owned = true;
+      ringCounter().add(1, sizeof(Ring));
+      
+      ring->next = rings.load(std::memory_order_relaxed);
+      while (!rings.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed));
+      return ring;
+   }
+   
+   // Plain thread locals, so they can still be read after the owner below is destroyed
+   thread_local Ring * ownRing = nullptr;
+   thread_local bool ringReleased = false;
+   
+   struct RingOwner
+   {
+      ~RingOwner()
+      {
+         if (ownRing) releaseRing(ownRing);
+         ownRing = nullptr;
+         ringReleased = true;
+      }
+   };
+   
+   // The ring of the calling thread. A thread that logs while it exits, from the destructor of
+   // another thread local, only borrows a ring for the message.
+   Ring * threadRing(bool & borrowed)
+   {
+      if (ownRing) return ownRing;
+      
+      Ring * ring = claimRing();
+      if (ringReleased) {
+         borrowed = true;
+         return ring;
+      }
+      
+      static thread_local RingOwner owner;
+      ownRing = ring;
+      return ring;
+   }
+   
+   uint64_t now()
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+   }
+   
+   size_t align(size_t size)
+   {
+      return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+   }
+   
+   size_t stringLength(LogArgument const& argument)
+   {
+      return std::min(argument.string ? argument.length : argument.owned.size(), MAX_STRING);
+   }
+   
+   void format(uint8_t const* bytes)
+   {
+      RecordHeader header;
+      std::memcpy(&header, bytes, sizeof(header));
+      bytes += sizeof(header);
+      
+      switch (static_cast<LogLevel>(header.level)) {
+         case LogLevel::FINE: output += "[fine] "; break;
+         case LogLevel::WARNING: output += "[warning] "; break;
+         case LogLevel::SEVERE: output += "[severe] "; break;
+         default: break;
+      }
+      
+      for (uint16_t i = 0; i < header.arguments; ++i) {
+         if (i > 0) output += ' ';
+         
+         auto type = static_cast<LogArgument::Type>(*bytes++);
+         if (type == LogArgument::Type::STRING) {
+            uint32_t length;
+            std::memcpy(&length, bytes, sizeof(length));
+            output.append(reinterpret_cast<const char *>(bytes + sizeof(length)), length);
+            bytes += sizeof(length) + length;
+            continue;
+         }
+         
+         uint64_t value;
+         std::memcpy(&value, bytes, sizeof(value));
+         bytes += sizeof(value);
+         
+         if (type == LogArgument::Type::INTEGER) output += std::to_string(static_cast<int64_t>(value));
+         else if (type == LogArgument::Type::UNSIGNED) output += std::to_string(value);
+         else {
+            double real;
+            std::memcpy(&real, &value, sizeof(real));
+            output += std::to_string(real);
+         }
+      }
+      output += '\n';
+   }
+   
+   // Writes out every complete message, oldest first across threads. Returns whether there was
+   // anything to write.
+   bool drain()
+   {
+      std::lock_guard<std::mutex> lock(drainMutex);
+      
+      struct Span
+      {
+         Ring * ring;
+         size_t tail;
+      };
+      std::vector<Span> spans;
+      
+      pending.clear();
+      for (Ring * ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+         size_t head = ring->head.load(std::memory_order_relaxed);
+         size_t tail = ring->tail.load(std::memory_order_acquire);
+         if (head == tail) continue;
+         
+         spans.push_back(Span{ ring, tail });
+         while (head != tail) {
+            uint8_t const* bytes = ring->data + head % RING_SIZE;
+            RecordHeader header;
+            std::memcpy(&header, bytes, sizeof(header));
+            if (header.level != PADDING) pending.push_back(Record{ header.time, pending.size(), bytes });
+            head += header.size;
+         }
+      }
+      
+      uint64_t lost = dropped.load(std::memory_order_relaxed);
+      if (pending.empty() && lost == reportedDropped) return false;
+      
+      std::sort(pending.begin(), pending.end(), [](Record const& a, Record const& b) {
+         return a.time < b.time || (a.time == b.time && a.sequence < b.sequence);
+      });
+      
+      output.clear();
+      for (auto const& record : pending) {
+         format(record.bytes);
+      }
+      if (lost != reportedDropped) {
+         output += "[log] " + std::to_string(lost - reportedDropped) + " messages dropped\n";
+         reportedDropped = lost;
+      }
+      
+      // The space only goes back to the writers once it is formatted
+      for (auto const& span : spans) {
+         span.ring->head.store(span.tail, std::memory_order_release);
+      }
+      
+      std::fwrite(output.data(), 1, output.size(), stdout);
+      std::fflush(stdout);
+      return true;
+   }
+   
+   // Started with the first message, joined at exit after a last drain. Sleeps until a message
+   // signals it.
+   class LogThread
+   {
+   public:
+      LogThread() : _stopping(false), _thread([this]() { run(); })
+      {
+      
+      }
+      
+      // Called after signalled was set. Taking the mutex orders it with the check of a thread
+      // that is about to wait, so the notification can't fall in between.
+      void wake()
+      {
+         {
+            std::lock_guard<std::mutex> lock(_mutex);
+         }
+         _wake.notify_one();
+      }
+      
+      ~LogThread()
+      {
+         {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+         }
+         _wake.notify_one();
+         _thread.join();
+         stopped = true;
+         drain();
+      }
+      
+   private:
+      void run()
+      {
+         std::unique_lock<std::mutex> lock(_mutex);
+         while (true) {
+            _wake.wait(lock, [this]() { return _stopping || signalled.load(); });
+            if (_stopping) break;
+            
+            // Cleared before the drain, a message it misses signals again
+            signalled = false;
+            lock.unlock();
+            drain();
+            lock.lock();
+         }
+      }
+      
+      std::mutex _mutex;
+      std::condition_variable _wake;
+      bool _stopping;
+      std::thread _thread;
+   };
+   
+   LogThread * logThread = nullptr;
+   
+   void startLogThread()
+   {
+      static LogThread thread;
+      logThread = &thread;
+   }
+   
+   // Gets the new messages, or the count of dropped ones, written
+   void signal()
+   {
+      if (stopped.load(std::memory_order_relaxed)) drain();
+      else if (!signalled.exchange(true)) logThread->wake();
+   }
+}
+
+namespace flair {
+namespace system {
+   
+   LogLevel logLevel()
+   {
+      return static_cast<LogLevel>(threshold.load(std::memory_order_relaxed));
+   }
+   
+   LogLevel logLevel(LogLevel value)
+   {
+      threshold.store(static_cast<int>(value), std::memory_order_relaxed);
+      return value;
+   }
+   
+   bool logging(LogLevel level)
+   {
+      return static_cast<int>(level) >= threshold.load(std::memory_order_relaxed);
+   }
+   
+   void flushLog()
+   {
+      drain();
+   }
+   
+   uint64_t droppedLogMessages()
+   {
+      return dropped.load(std::memory_order_relaxed);
+   }
+   
+   void writeLog(LogLevel level, LogArgument const* arguments, size_t count)
+   {
+      static std::once_flag started;
+      std::call_once(started, startLogThread);
+      
+      size_t size = sizeof(RecordHeader);
+      for (size_t i = 0; i < count; ++i) {
+         size += 1 + (arguments[i].type == LogArgument::Type::STRING ? sizeof(uint32_t) + stringLength(arguments[i]) : sizeof(uint64_t));
+      }
+      size = align(size);
+      
+      bool borrowed = false;
+      Ring * ring = threadRing(borrowed);
+      size_t tail = ring->tail.load(std::memory_order_relaxed);
+      size_t head = ring->head.load(std::memory_order_acquire);
+      
+      // A record never wraps, the rest of the ring is skipped instead
+      size_t offset = tail % RING_SIZE;
+      size_t skip = RING_SIZE - offset < size ? RING_SIZE - offset : 0;
+      if (size > MAX_RECORD || count > UINT16_MAX || tail + skip + size - head > RING_SIZE) {
+         dropped.fetch_add(1, std::memory_order_relaxed);
+         if (borrowed) releaseRing(ring);
+         signal();
+         return;
+      }
+      
+      if (skip) {
+         RecordHeader padding = { static_cast<uint32_t>(skip), PADDING, 0, 0, 0 };
+         std::memcpy(ring->data + offset, &padding, sizeof(padding));
+         offset = 0;
+      }
+      
+      uint8_t * bytes = ring->data + offset;
+      RecordHeader header = { static_cast<uint32_t>(size), static_cast<uint8_t>(level), 0, static_cast<uint16_t>(count), now() };
+      std::memcpy(bytes, &header, sizeof(header));
+      bytes += sizeof(header);
+      
+      for (size_t i = 0; i < count; ++i) {
+         auto const& argument = arguments[i];
+         *bytes++ = static_cast<uint8_t>(argument.type);
+         
+         if (argument.type == LogArgument::Type::STRING) {
+            uint32_t length = static_cast<uint32_t>(stringLength(argument));
+            std::memcpy(bytes, &length, sizeof(length));
+            std::memcpy(bytes + sizeof(length), argument.string ? argument.string : argument.owned.data(), length);
+            bytes += sizeof(length) + length;
+         }
+         else {
+            std::memcpy(bytes, &argument.unsignedInteger, sizeof(uint64_t));
+            bytes += sizeof(uint64_t);
+         }
+      }
+      
+      ring->tail.store(tail + skip + size, std::memory_order_release);
+      if (borrowed) releaseRing(ring);
+      signal();
+   }
+   
+}}
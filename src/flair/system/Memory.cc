@@ -0,0 +1,114 @@
+#include "flair/system/Memory.h"
+#include "flair/internal/utils/TypeName.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+   using flair::system::MemoryCounter;
+   
+   // Constant initialized, counters may be created before anything else in the process ran
+   std::atomic<MemoryCounter*> counters(nullptr);
+   std::atomic<int64_t> totalBytes(0);
+   std::atomic<int64_t> peakTotalBytes(0);
+   
+   void raise(std::atomic<int64_t> & peak, int64_t value)
+   {
+      int64_t current = peak.load(std::memory_order_relaxed);
+      while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed));
+   }
+}
+
+namespace flair {
+namespace system {
+   
+   MemoryCounter::MemoryCounter(MemoryCategory category, const char * name, size_t objectSize) : _category(category), _name(name),
+      _objectSize(static_cast<int64_t>(objectSize)), _count(0), _bytes(0), _peakCount(0), _peakBytes(0),
+      _readableName(category == MemoryCategory::OBJECT ? nullptr : name)
+   {
+      _next = counters.load(std::memory_order_relaxed);
+      while (!counters.compare_exchange_weak(_next, this, std::memory_order_release, std::memory_order_relaxed));
+   }
+   
+   MemoryCategory MemoryCounter::category() const
+   {
+      return _category;
+   }
+   
+   const char * MemoryCounter::name() const
+   {
+      return _name;
+   }
+   
+   int64_t MemoryCounter::count() const
+   {
+      return _count.load(std::memory_order_relaxed);
+   }
+   
+   int64_t MemoryCounter::bytes() const
+   {
+      return _bytes.load(std::memory_order_relaxed);
+   }
+   
+   void MemoryCounter::add(int64_t count, int64_t bytes)
+   {
+      int64_t liveCount = _count.fetch_add(count, std::memory_order_relaxed) + count;
+      if (count > 0) raise(_peakCount, liveCount);
+      
+      if (bytes == 0) return;
+      int64_t liveBytes = _bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+      int64_t total = totalBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+      if (bytes > 0) {
+         raise(_peakBytes, liveBytes);
+         raise(peakTotalBytes, total);
+      }
+   }
+   
+   const char * MemoryCounter::readableName()
+   {
+      const char * name = _readableName.load(std::memory_order_acquire);
+      if (name) return name;
+      
+      std::string demangled = flair::internal::utils::typeName(_name);
+      char * copy = new char[demangled.size() + 1];
+      std::memcpy(copy, demangled.c_str(), demangled.size() + 1);
+      
+      // Another thread taking the stats may have stored its copy first
+      if (_readableName.compare_exchange_strong(name, copy, std::memory_order_acq_rel, std::memory_order_acquire)) return copy;
+      delete[] copy;
+      return name;
+   }
+   
+   MemoryStats memoryStats()
+   {
+      MemoryStats stats;
+      stats.bytes = totalBytes.load(std::memory_order_relaxed);
+      stats.peakBytes = peakTotalBytes.load(std::memory_order_relaxed);
+      
+      for (MemoryCounter * counter = counters.load(std::memory_order_acquire); counter; counter = counter->_next) {
+         MemoryUsage usage;
+         usage.category = counter->_category;
+         usage.name = counter->readableName();
+         usage.count = counter->_count.load(std::memory_order_relaxed);
+         usage.bytes = counter->_bytes.load(std::memory_order_relaxed);
+         usage.peakCount = counter->_peakCount.load(std::memory_order_relaxed);
+         usage.peakBytes = counter->_peakBytes.load(std::memory_order_relaxed);
+         stats.usage.push_back(usage);
+      }
+      
+      std::stable_sort(stats.usage.begin(), stats.usage.end(), [](MemoryUsage const& a, MemoryUsage const& b) {
+         return a.bytes > b.bytes;
+      });
+      return stats;
+   }
+   
+   void resetMemoryPeaks()
+   {
+      for (MemoryCounter * counter = counters.load(std::memory_order_acquire); counter; counter = counter->_next) {
+         counter->_peakCount = counter->_count.load(std::memory_order_relaxed);
+         counter->_peakBytes = counter->_bytes.load(std::memory_order_relaxed);
+      }
+      peakTotalBytes = totalBytes.load(std::memory_order_relaxed);
+   }
+   
+}}
@@ -0,0 +1,100 @@
+#include "flair/system/MessageChannel.h"
+#include "flair/system/Worker.h"
+#include "flair/internal/utils/MPSCQueue.h"
+
+#include <utility>
+
+namespace flair {
+namespace system {
+   
+   using flair::utils::ByteArray;
+   
+   MessageChannel::MessageChannel(std::shared_ptr<Worker> receiver) : _receiver(receiver), _state(MessageChannelState::OPEN), _messages(new flair::internal::utils::MPSCQueue<Message>())
+   {
+      
+   }
+   
+   MessageChannel::~MessageChannel()
+   {
+      delete _messages;
+   }
+   
+   bool MessageChannel::messageAvailable() const
+   {
+      return _messages->size_approx() > 0;
+   }
+   
+   MessageChannelState MessageChannel::state() const
+   {
+      return _state;
+   }
+   
+   bool MessageChannel::send(flair::JSON value)
+   {
+      Message message;
+      message.json = value;
+      return push(std::move(message));
+   }
+   
+   bool MessageChannel::send(std::shared_ptr<ByteArray> bytes)
+   {
+      if (!bytes || _state != MessageChannelState::OPEN) return false;
+      
+      // Swap the storage into a fresh ByteArray, the sender keeps an empty one
+      auto transferred = flair::make_shared<ByteArray>();
+      std::swap(transferred->_byteArray, bytes->_byteArray);
+      std::swap(transferred->_byteArrayLength, bytes->_byteArrayLength);
+      std::swap(transferred->_length, bytes->_length);
+      transferred->_endian = bytes->_endian;
+      bytes->_position = 0;
+      
+      Message message;
+      message.bytes = transferred;
+      return push(std::move(message));
+   }
+   
+   bool MessageChannel::receive(Message & message, bool blockUntilReceived)
+   {
+      auto receiver = _receiver.lock();
+      bool waited = false;
+      bool received = true;
+      
+      while (!_messages->pop(message)) {
+         if (_state != MessageChannelState::OPEN) {
+            _state = MessageChannelState::CLOSED;
+            received = false;
+            break;
+         }
+         if (!blockUntilReceived || !receiver) {
+            received = false;
+            break;
+         }
+         
+         receiver->wait(std::chrono::milliseconds(-1));
+         waited = true;
+      }
+      
+      // The wait may have taken a wakeup meant for the receiver's other channels
+      if (waited) receiver->wake();
+      return received;
+   }
+   
+   void MessageChannel::close()
+   {
+      MessageChannelState open = MessageChannelState::OPEN;
+      if (!_state.compare_exchange_strong(open, MessageChannelState::CLOSING)) return;
+      
+      // Lets a blocking receive see the state change
+      if (auto receiver = _receiver.lock()) receiver->wake();
+   }
+   
+   bool MessageChannel::push(Message && message)
+   {
+      if (_state != MessageChannelState::OPEN) return false;
+      
+      _messages->push(std::move(message));
+      if (auto receiver = _receiver.lock()) receiver->wake();
+      return true;
+   }
+   
+}}
@@ -4,6 +4,7 @@
 #include "flair/geom/Rectangle.h"
 #include "flair/internal/services/IWorkerService.h"
 #include "flair/internal/services/IAsyncIOService.h" // TODO: Worker Service should be self contained
+#include "flair/internal/utils/Profiler.h"
 
 #include "png.h"
 
@@ -44,6 +45,7 @@ namespace system {
       
       workerService->execute([this, bytes]() -> std::shared_ptr<IAsyncWorkerRequest::IWorkerResult> {
          // Do Work - Worker Thread
+         FLAIR_PROFILE_ZONE("PNG decode");
          
          // Check PNG Header
          bytes->position(0);
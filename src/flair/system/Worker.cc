@@ -0,0 +1,232 @@
+#include "flair/system/Worker.h"
+#include "flair/system/MessageChannel.h"
+#include "flair/events/Event.h"
+#include "flair/internal/services/IWorkerService.h"
+#include "flair/internal/utils/ThreadPool.h"
+#include "flair/internal/utils/Profiler.h"
+
+#include <algorithm>
+
+namespace {
+   thread_local flair::system::Worker * currentWorker = nullptr;
+}
+
+namespace flair {
+namespace system {
+   
+   using flair::events::Event;
+   using std::chrono::milliseconds;
+   using std::chrono::steady_clock;
+   
+   flair::internal::services::IWorkerService * Worker::workerService = nullptr;
+   
+   Worker::Worker(std::function<void()> entry) : _entry(entry), _primordial(false), _state(WorkerState::NEW), _terminating(false), _signaled(false), _nextTimer(1)
+   {
+   
+   }
+   
+   Worker::~Worker()
+   {
+      assert(_state != WorkerState::RUNNING || _primordial);
+   }
+   
+   std::shared_ptr<Worker> Worker::current()
+   {
+      if (currentWorker) return currentWorker->shared<Worker>();
+      
+      static std::shared_ptr<Worker> primordial;
+      static std::once_flag once;
+      std::call_once(once, []() {
+         primordial = flair::make_shared<Worker>();
+         primordial->_primordial = true;
+         primordial->_state = WorkerState::RUNNING;
+      });
+      return primordial;
+   }
+   
+   bool Worker::isSupported()
+   {
+      return true;
+   }
+   
+   bool Worker::isPrimordial() const
+   {
+      return _primordial;
+   }
+   
+   WorkerState Worker::state() const
+   {
+      return _state;
+   }
+   
+   std::shared_ptr<MessageChannel> Worker::createMessageChannel(std::shared_ptr<Worker> receiver)
+   {
+      assert(receiver);
+      
+      auto channel = flair::make_shared<MessageChannel>(receiver);
+      receiver->addChannel(channel);
+      return channel;
+   }
+   
+   void Worker::start()
+   {
+      if (_primordial || _state != WorkerState::NEW) return;
+      
+      // The thread keeps its worker alive until it is terminated
+      auto self = shared<Worker>();
+      _state = WorkerState::RUNNING;
+      _thread = std::thread([self]() { self->loop(); });
+   }
+   
+   bool Worker::terminate()
+   {
+      if (_primordial || _state != WorkerState::RUNNING) return false;
+      if (currentWorker == this) return false;
+      
+      _terminating = true;
+      wake();
+      if (_thread.joinable()) _thread.join();
+      
+      _state = WorkerState::TERMINATED;
+      return true;
+   }
+   
+   uint32_t Worker::setTimer(uint32_t delay, std::function<void()> callback, bool repeat)
+   {
+      Timer timer = { _nextTimer++, steady_clock::now() + milliseconds(delay), milliseconds(delay), repeat, callback };
+      _timers.push_back(timer);
+      return timer.id;
+   }
+   
+   void Worker::clearTimer(uint32_t id)
+   {
+      auto it = std::find_if(_timers.begin(), _timers.end(), [id](Timer const& timer) { return timer.id == id; });
+      if (it != _timers.end()) _timers.erase(it);
+   }
+   
+   void Worker::parallelFor(size_t count, std::function<void(size_t begin, size_t end)> body, size_t grain)
+   {
+      if (workerService) {
+         workerService->parallelFor(count, grain, body);
+         return;
+      }
+      
+      // No application running, e.g. in tools and tests
+      static flair::internal::utils::ThreadPool pool;
+      pool.parallelFor(count, grain, body);
+   }
+   
+   void Worker::addChannel(std::shared_ptr<MessageChannel> channel)
+   {
+      std::lock_guard<std::mutex> lock(_channelsMutex);
+      _channels.push_back(channel);
+   }
+   
+   void Worker::wake()
+   {
+      // Only the first wake of a batch takes the lock and notifies
+      if (_signaled.exchange(true)) return;
+      
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         if (_wakeHandler) _wakeHandler();
+      }
+      _condition.notify_all();
+   }
+   
+   void Worker::wait(milliseconds timeout)
+   {
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (timeout.count() < 0) {
+         _condition.wait(lock, [this]() { return _signaled.load(); });
+      }
+      else {
+         _condition.wait_for(lock, timeout, [this]() { return _signaled.load(); });
+      }
+      _signaled = false;
+   }
+   
+   milliseconds Worker::process()
+   {
+      FLAIR_PROFILE_ZONE("Worker::process");
+      
+      // The primordial worker never waits, so the next wake has to be let through here
+      if (_primordial) _signaled = false;
+      
+      {
+         std::lock_guard<std::mutex> lock(_channelsMutex);
+         
+         // Channels that closed and were drained are done for good
+         _channels.erase(std::remove_if(_channels.begin(), _channels.end(), [](std::shared_ptr<MessageChannel> const& channel) {
+            return channel->state() != MessageChannelState::OPEN && !channel->messageAvailable();
+         }), _channels.end());
+         
+         _pending.clear();
+         for (auto const& channel : _channels) {
+            if (channel->messageAvailable()) _pending.push_back(channel);
+         }
+      }
+      
+      // One event per channel and wakeup, listeners receive() the whole batch
+      for (auto const& channel : _pending) {
+         channel->dispatchEvent(flair::make_shared<Event>(Event::CHANNEL_MESSAGE));
+      }
+      _pending.clear();
+      
+      // Timers may set or clear timers, so they are looked up again before each call
+      auto now = steady_clock::now();
+      _dueTimers.clear();
+      for (auto const& timer : _timers) {
+         if (timer.due <= now) _dueTimers.push_back(timer.id);
+      }
+      
+      for (auto id : _dueTimers) {
+         auto it = std::find_if(_timers.begin(), _timers.end(), [id](Timer const& timer) { return timer.id == id; });
+         if (it == _timers.end()) continue;
+         
+         auto callback = it->callback;
+         if (it->repeat) {
+            it->due = std::max(it->due + it->interval, now);
+         }
+         else {
+            _timers.erase(it);
+         }
+         callback();
+      }
+      
+      return nextTimer();
+   }
+   
+   milliseconds Worker::nextTimer()
+   {
+      if (_timers.empty()) return milliseconds(-1);
+      
+      auto next = std::min_element(_timers.begin(), _timers.end(), [](Timer const& a, Timer const& b) { return a.due < b.due; })->due;
+      auto remaining = std::chrono::duration_cast<milliseconds>(next - steady_clock::now());
+      return std::max(remaining, milliseconds(0));
+   }
+   
+   void Worker::wakeHandler(std::function<void()> handler)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _wakeHandler = handler;
+   }
+   
+   void Worker::loop()
+   {
+      FLAIR_PROFILE_THREAD("worker");
+      currentWorker = this;
+      
+      if (_entry) _entry();
+      
+      while (!_terminating) {
+         auto timeout = process();
+         if (_terminating) break;
+         wait(timeout);
+      }
+      
+      _timers.clear();
+      currentWorker = nullptr;
+   }
+   
+}}
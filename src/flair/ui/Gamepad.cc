@@ -0,0 +1,67 @@
+#include "flair/ui/Gamepad.h"
+#include "flair/internal/services/IGamepadService.h"
+
+#include <cassert>
+
+namespace flair {
+   namespace ui {
+      
+      flair::internal::services::IGamepadService * Gamepad::gamepadService = nullptr;
+      
+      float Gamepad::deadZone()
+      {
+         assert(gamepadService);
+         return gamepadService->deadZone();
+      }
+      
+      float Gamepad::deadZone(float deadZone)
+      {
+         assert(gamepadService);
+         return gamepadService->deadZone(deadZone);
+      }
+      
+      bool Gamepad::backgroundPolling()
+      {
+         assert(gamepadService);
+         return gamepadService->backgroundPolling();
+      }
+      
+      bool Gamepad::backgroundPolling(bool backgroundPolling)
+      {
+         assert(gamepadService);
+         return gamepadService->backgroundPolling(backgroundPolling);
+      }
+      
+      bool Gamepad::connected(uint32_t device)
+      {
+         assert(gamepadService);
+         gamepadService->open();
+         flair::internal::services::GamepadState state;
+         gamepadService->state(device, &state);
+         return state.connected;
+      }
+      
+      bool Gamepad::button(uint32_t device, uint32_t button)
+      {
+         assert(gamepadService);
+         gamepadService->open();
+         if (button >= _BUTTON_COUNT) return false;
+         
+         flair::internal::services::GamepadState state;
+         gamepadService->state(device, &state);
+         return (state.buttons & (1u << button)) != 0;
+      }
+      
+      float Gamepad::axis(uint32_t device, uint32_t axis)
+      {
+         assert(gamepadService);
+         gamepadService->open();
+         if (axis >= _AXIS_COUNT) return 0.0f;
+         
+         flair::internal::services::GamepadState state;
+         gamepadService->state(device, &state);
+         return state.axes[axis];
+      }
+      
+   }
+}
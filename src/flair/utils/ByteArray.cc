@@ -1,4 +1,5 @@
 #include "flair/utils/ByteArray.h"
+#include "flair/system/Memory.h"
 
 #include "zlib.h"
 
@@ -8,6 +9,12 @@
 
 namespace {
    bool isBigEndian = *(uint16_t *)"\0\xff" < 0x100;
+   
+   flair::system::MemoryCounter & buffers()
+   {
+      static flair::system::MemoryCounter * counter = new flair::system::MemoryCounter(flair::system::MemoryCategory::BYTE_ARRAY, "ByteArray buffers");
+      return *counter;
+   }
 }
 
 namespace flair {
@@ -19,11 +26,13 @@ namespace utils {
       
       _byteArray = new uint8_t[BLOCK_SIZE];
       _byteArrayLength = BLOCK_SIZE;
+      buffers().add(1, BLOCK_SIZE);
    }
    
    ByteArray::~ByteArray()
    {
       delete[] _byteArray;
+      buffers().add(-1, -static_cast<int64_t>(_byteArrayLength));
    }
    
    size_t ByteArray::bytesAvailable()
@@ -64,6 +73,7 @@ namespace utils {
          delete[] _byteArray;
          _byteArray = newByteArray;
          
+         buffers().add(0, static_cast<int64_t>(newLength) - static_cast<int64_t>(_byteArrayLength));
          _byteArrayLength = newLength;
          _length = value;
          
@@ -99,6 +109,7 @@ namespace utils {
    {
       delete[] _byteArray;
       _byteArray = new uint8_t[BLOCK_SIZE];
+      buffers().add(0, static_cast<int64_t>(BLOCK_SIZE) - static_cast<int64_t>(_byteArrayLength));
       _byteArrayLength = BLOCK_SIZE;
       
       _length = 0;
@@ -141,12 +152,14 @@ namespace utils {
       } while (ret == Z_OK);
       deflateEnd(&strm);
       
-      // Move the _byteArray over
-      delete _byteArray;
+      // Move the _byteArray over, it is counted already and the target leaves nothing behind
+      delete[] _byteArray;
+      buffers().add(0, -static_cast<int64_t>(_byteArrayLength));
       _byteArray = target->_byteArray;
       _byteArrayLength = target->_byteArrayLength;
       _length = target->_length;
       target->_byteArray = nullptr;
+      target->_byteArrayLength = 0;
       
       _position = _length;
    }
@@ -187,12 +200,14 @@ namespace utils {
       } while (ret == Z_OK);
       inflateEnd(&strm);
       
-      // Move the _byteArray over
-      delete _byteArray;
+      // Move the _byteArray over, it is counted already and the target leaves nothing behind
+      delete[] _byteArray;
+      buffers().add(0, -static_cast<int64_t>(_byteArrayLength));
       _byteArray = target->_byteArray;
       _byteArrayLength = target->_byteArrayLength;
       _length = target->_length;
       target->_byteArray = nullptr;
+      target->_byteArrayLength = 0;
       
       _position = 0;
    }
@@ -0,0 +1,132 @@
+#include "flair/utils/Timer.h"
+#include "flair/events/TimerEvent.h"
+#include "flair/internal/services/ITimerService.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace {
+   uint32_t milliseconds(float delay)
+   {
+      return delay > 1.0f ? static_cast<uint32_t>(std::lround(delay)) : 1;
+   }
+}
+
+namespace flair {
+namespace utils {
+   
+   using flair::events::TimerEvent;
+   
+   flair::internal::services::ITimerService * Timer::timerService = nullptr;
+   
+   Timer::Timer(float delay, int repeatCount) : _delay(delay), _repeatCount(repeatCount), _currentCount(0), _id(0)
+   {
+      
+   }
+   
+   Timer::~Timer()
+   {
+      if (_id && timerService) timerService->cancel(_id);
+   }
+   
+   int Timer::currentCount() const
+   {
+      return _currentCount;
+   }
+   
+   float Timer::delay() const
+   {
+      return _delay;
+   }
+   
+   float Timer::delay(float value)
+   {
+      _delay = value;
+      
+      // A running timer starts over with the new delay
+      if (running()) {
+         stop();
+         start();
+      }
+      return _delay;
+   }
+   
+   int Timer::repeatCount() const
+   {
+      return _repeatCount;
+   }
+   
+   int Timer::repeatCount(int value)
+   {
+      _repeatCount = value;
+      if (_repeatCount > 0 && _currentCount >= _repeatCount) stop();
+      return _repeatCount;
+   }
+   
+   bool Timer::running() const
+   {
+      return _id != 0;
+   }
+   
+   void Timer::reset()
+   {
+      stop();
+      _currentCount = 0;
+   }
+   
+   void Timer::start()
+   {
+      assert(timerService);
+      if (running()) return;
+      
+      std::weak_ptr<Timer> timer = shared<Timer>();
+      uint32_t interval = milliseconds(_delay);
+      _id = timerService->schedule(interval, interval, [timer]() {
+         if (auto t = timer.lock()) t->onTimer();
+      });
+   }
+   
+   void Timer::stop()
+   {
+      if (!running()) return;
+      
+      if (timerService) timerService->cancel(_id);
+      _id = 0;
+   }
+   
+   void Timer::onTimer()
+   {
+      ++_currentCount;
+      dispatchEvent(flair::make_shared<TimerEvent>(TimerEvent::TIMER));
+      
+      if (_repeatCount > 0 && _currentCount >= _repeatCount) {
+         stop();
+         dispatchEvent(flair::make_shared<TimerEvent>(TimerEvent::TIMER_COMPLETE));
+      }
+   }
+   
+   uint32_t setTimeout(std::function<void()> closure, float delay)
+   {
+      assert(Timer::timerService);
+      return Timer::timerService->schedule(milliseconds(delay), 0, closure);
+   }
+   
+   uint32_t setInterval(std::function<void()> closure, float delay)
+   {
+      assert(Timer::timerService);
+      return Timer::timerService->schedule(milliseconds(delay), milliseconds(delay), closure);
+   }
+   
+   void clearTimeout(uint32_t id)
+   {
+      assert(Timer::timerService);
+      Timer::timerService->cancel(id);
+   }
+   
+   void clearInterval(uint32_t id)
+   {
+      assert(Timer::timerService);
+      Timer::timerService->cancel(id);
+   }
+   
+}}
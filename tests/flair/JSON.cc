@@ -1,9 +1,11 @@
 #include "flair/flair.h"
 #include "flair/JSON.h"
+#include "flair/utils/ByteArray.h"
 #include "gtest/gtest.h"
 
 namespace {
    using flair::JSON;
+   using flair::utils::ByteArray;
    
    class JSONTest : public ::testing::Test
    {
@@ -29,4 +31,35 @@ namespace {
       auto result = JSON::stringify(object);
       EXPECT_EQ(result, "{\"key1\": \"value1\", \"key2\": false, \"key3\": [1, 2, 3]}");
    }
+   
+   TEST_F(JSONTest, ParseBuffer)
+   {
+      // The buffer is not null terminated, parsing must stop at the given length
+      const char buffer[] = { '[', '1', '2', ',', ' ', 't', 'r', 'u', 'e', ']', '9', '9' };
+      
+      std::string err;
+      auto result = JSON::parse(buffer, 10, err);
+      EXPECT_TRUE(err.empty());
+      EXPECT_EQ(result[0].int_value(), 12);
+      EXPECT_TRUE(result[1].bool_value());
+      
+      JSON::parse(buffer, 4, err);
+      EXPECT_FALSE(err.empty());
+   }
+   
+   TEST_F(JSONTest, ParseAsync)
+   {
+      auto bytes = flair::make_shared<ByteArray>();
+      std::string text = "{ \"hello\": [1.5, \"world\"] }";
+      bytes->writeBytes(reinterpret_cast<uint8_t const*>(text.data()), 0, text.size());
+      
+      bool called = false;
+      JSON::parseAsync(bytes, [&called](JSON result, const std::string & err) {
+         called = true;
+         EXPECT_TRUE(err.empty());
+         EXPECT_DOUBLE_EQ(result["hello"][0].number_value(), 1.5);
+         EXPECT_EQ(result["hello"][1].string_value(), "world");
+      });
+      EXPECT_TRUE(called);
+   }
 }
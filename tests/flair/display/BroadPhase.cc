@@ -0,0 +1,158 @@
+#include "flair/flair.h"
+#include "flair/display/BroadPhase.h"
+#include "flair/display/Sprite.h"
+#include "gtest/gtest.h"
+
+namespace {
+   using flair::display::BroadPhase;
+   using flair::display::DisplayObject;
+   using flair::display::Sprite;
+   using flair::geom::Rectangle;
+   
+   class Box : public DisplayObject
+   {
+      friend flair::allocator;
+      
+   protected:
+      Box(float x, float y, float width, float height) : DisplayObject()
+      {
+         _x = x;
+         _y = y;
+         _width = width;
+         _height = height;
+      }
+      
+   public:
+      virtual ~Box() {}
+   };
+   
+   class BroadPhaseTest : public ::testing::Test
+   {
+   protected:
+      BroadPhaseTest() {}
+      virtual ~BroadPhaseTest() {}
+      
+      static bool hasPair(const std::vector<BroadPhase::Pair> & pairs, std::shared_ptr<DisplayObject> a, std::shared_ptr<DisplayObject> b)
+      {
+         for (auto const& pair : pairs) {
+            if ((pair.first == a && pair.second == b) || (pair.first == b && pair.second == a)) {
+               return true;
+            }
+         }
+         return false;
+      }
+   };
+   
+   TEST_F(BroadPhaseTest, WorldBounds)
+   {
+      auto parent = flair::make_shared<Sprite>();
+      auto box = flair::make_shared<Box>(5.0f, 10.0f, 20.0f, 30.0f);
+      parent->x(100.0f);
+      parent->addChild(box);
+      
+      Rectangle bounds = box->getBounds(nullptr);
+      EXPECT_FLOAT_EQ(105.0f, bounds.x());
+      EXPECT_FLOAT_EQ(10.0f, bounds.y());
+      EXPECT_FLOAT_EQ(20.0f, bounds.width());
+      EXPECT_FLOAT_EQ(30.0f, bounds.height());
+      
+      bounds = box->getBounds(parent);
+      EXPECT_FLOAT_EQ(5.0f, bounds.x());
+      
+      auto other = flair::make_shared<Box>(120.0f, 35.0f, 10.0f, 10.0f);
+      EXPECT_TRUE(box->hitTestObject(other));
+      other->y(40.0f);
+      EXPECT_FALSE(box->hitTestObject(other));
+   }
+   
+   TEST_F(BroadPhaseTest, SpriteBounds)
+   {
+      auto sprite = flair::make_shared<Sprite>();
+      sprite->x(100.0f);
+      
+      Rectangle bounds = sprite->getBounds(nullptr);
+      EXPECT_FLOAT_EQ(100.0f, bounds.x());
+      EXPECT_FLOAT_EQ(0.0f, bounds.width());
+      
+      sprite->addChild(flair::make_shared<Box>(0.0f, 0.0f, 10.0f, 10.0f));
+      sprite->addChild(flair::make_shared<Box>(20.0f, 30.0f, 10.0f, 10.0f));
+      
+      bounds = sprite->getBounds(nullptr);
+      EXPECT_FLOAT_EQ(100.0f, bounds.x());
+      EXPECT_FLOAT_EQ(0.0f, bounds.y());
+      EXPECT_FLOAT_EQ(30.0f, bounds.width());
+      EXPECT_FLOAT_EQ(40.0f, bounds.height());
+      
+      bounds = sprite->getBounds(sprite);
+      EXPECT_FLOAT_EQ(0.0f, bounds.x());
+      
+      auto other = flair::make_shared<Box>(125.0f, 35.0f, 10.0f, 10.0f);
+      EXPECT_TRUE(sprite->hitTestObject(other));
+      EXPECT_TRUE(other->hitTestObject(sprite));
+      
+      BroadPhase broadPhase;
+      broadPhase.add(sprite);
+      broadPhase.add(other);
+      EXPECT_EQ(1u, broadPhase.update().size());
+      
+      other->y(50.0f);
+      EXPECT_FALSE(sprite->hitTestObject(other));
+      EXPECT_TRUE(broadPhase.update().empty());
+   }
+   
+   TEST_F(BroadPhaseTest, Pairs)
+   {
+      BroadPhase broadPhase;
+      std::vector<std::shared_ptr<DisplayObject>> boxes;
+      for (int i = 0; i < 20; ++i) {
+         // Boxes along a diagonal, each overlapping only its neighbours
+         boxes.push_back(flair::make_shared<Box>(i * 8.0f, i * 8.0f, 10.0f, 10.0f));
+         broadPhase.add(boxes.back());
+      }
+      
+      auto const& pairs = broadPhase.update();
+      EXPECT_EQ(19u, pairs.size());
+      for (int i = 0; i < 19; ++i) {
+         EXPECT_TRUE(hasPair(pairs, boxes[i], boxes[i + 1]));
+      }
+      
+      // Move one box onto another and make sure the incremental order still finds it
+      boxes[0]->x(150.0f);
+      boxes[0]->y(150.0f);
+      broadPhase.update();
+      EXPECT_EQ(20u, broadPhase.pairs().size());
+      EXPECT_TRUE(hasPair(broadPhase.pairs(), boxes[0], boxes[18]));
+      EXPECT_TRUE(hasPair(broadPhase.pairs(), boxes[0], boxes[19]));
+      EXPECT_FALSE(hasPair(broadPhase.pairs(), boxes[0], boxes[1]));
+      
+      std::vector<std::shared_ptr<DisplayObject>> hits;
+      EXPECT_EQ(2u, broadPhase.query(Rectangle(155.0f, 155.0f, 1.0f, 1.0f), hits));
+   }
+   
+   TEST_F(BroadPhaseTest, NarrowPhaseAndRemoval)
+   {
+      BroadPhase broadPhase;
+      auto a = flair::make_shared<Box>(0.0f, 0.0f, 10.0f, 10.0f);
+      auto b = flair::make_shared<Box>(5.0f, 5.0f, 10.0f, 10.0f);
+      auto c = flair::make_shared<Box>(8.0f, 8.0f, 10.0f, 10.0f);
+      broadPhase.add(a);
+      broadPhase.add(b);
+      broadPhase.add(c);
+      EXPECT_EQ(3u, broadPhase.update().size());
+      
+      broadPhase.narrowPhase([&](const std::shared_ptr<DisplayObject> & first, const std::shared_ptr<DisplayObject> & second) {
+         return first != a && second != a;
+      });
+      EXPECT_EQ(1u, broadPhase.update().size());
+      
+      broadPhase.narrowPhase(nullptr);
+      broadPhase.remove(b);
+      EXPECT_FALSE(broadPhase.contains(b));
+      EXPECT_EQ(1u, broadPhase.update().size());
+      
+      c.reset();
+      broadPhase.update();
+      EXPECT_EQ(1u, broadPhase.size());
+      EXPECT_TRUE(broadPhase.pairs().empty());
+   }
+}
@@ -0,0 +1,176 @@
+#include "flair/flair.h"
+#include "flair/display/Inspector.h"
+#include "flair/display/Stage.h"
+#include "flair/display/Sprite.h"
+#include "flair/events/Event.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+namespace {
+   using flair::display::DisplayObject;
+   using flair::display::Inspector;
+   using flair::display::Sprite;
+   using flair::display::Stage;
+   using flair::events::Event;
+   
+   void spin(uint64_t nanoseconds)
+   {
+      uint64_t end = Inspector::now() + nanoseconds;
+      while (Inspector::now() < end);
+   }
+   
+   class Box : public DisplayObject
+   {
+      friend flair::allocator;
+      
+   protected:
+      Box() : DisplayObject() {}
+      
+   public:
+      virtual ~Box() {}
+   };
+   
+   // Spends a millisecond in every tick and has its box handle an event meanwhile
+   class Busy : public Sprite
+   {
+      friend flair::allocator;
+      
+   protected:
+      Busy() : Sprite() {}
+      
+   public:
+      void tick(float deltaSeconds) override
+      {
+         Sprite::tick(deltaSeconds);
+         spin(1000000);
+         if (numChildren()) getChildAt(0)->dispatchEvent(flair::make_shared<Event>("busy"));
+      }
+   };
+   
+   class TestStage : public Stage
+   {
+      friend flair::allocator;
+      
+   protected:
+      TestStage() : Stage() {}
+      
+   public:
+      using Stage::tick;
+   };
+   
+   class InspectorTest : public ::testing::Test
+   {
+   protected:
+      InspectorTest() {}
+      virtual ~InspectorTest() {}
+   };
+   
+   TEST_F(InspectorTest, ReportsSubtrees)
+   {
+      auto stage = flair::make_shared<TestStage>();
+      auto layer = flair::make_shared<Sprite>();
+      layer->name("layer");
+      layer->addChild(flair::make_shared<Box>());
+      layer->addChild(flair::make_shared<Box>());
+      stage->addChild(layer);
+      stage->addChild(flair::make_shared<Box>());
+      
+      auto inspector = flair::make_shared<Inspector>(stage);
+      auto report = inspector->report();
+      
+      ASSERT_EQ(5u, report.nodes.size());
+      EXPECT_EQ(0u, report.frames);
+      
+      EXPECT_EQ(-1, report.nodes[0].parent);
+      EXPECT_EQ(5u, report.nodes[0].objects);
+      
+      EXPECT_EQ("layer", report.nodes[1].name);
+      EXPECT_NE(std::string::npos, report.nodes[1].type.find("Sprite"));
+      EXPECT_EQ(0, report.nodes[1].parent);
+      EXPECT_EQ(1u, report.nodes[1].depth);
+      EXPECT_EQ(3u, report.nodes[1].objects);
+      
+      EXPECT_EQ(1, report.nodes[2].parent);
+      EXPECT_EQ(2u, report.nodes[2].depth);
+      EXPECT_EQ(0, report.nodes[4].parent);
+      EXPECT_EQ(1u, report.nodes[4].objects);
+   }
+   
+   TEST_F(InspectorTest, SamplesTickAndEventTime)
+   {
+      auto stage = flair::make_shared<TestStage>();
+      auto busy = flair::make_shared<Busy>();
+      auto box = flair::make_shared<Box>();
+      busy->addChild(box);
+      stage->addChild(busy);
+      stage->addChild(flair::make_shared<Sprite>());
+      
+      box->addEventListener("busy", [](std::shared_ptr<Event>) { spin(500000); });
+      
+      auto inspector = flair::make_shared<Inspector>(stage, 2);
+      stage->tick(0.016f);
+      EXPECT_FALSE(inspector->sampling());
+      
+      inspector->start();
+      EXPECT_TRUE(inspector->sampling());
+      for (int i = 0; i < 3; ++i) stage->tick(0.016f);
+      
+      auto report = inspector->report();
+      EXPECT_EQ(2u, report.frames);
+      ASSERT_EQ(4u, report.nodes.size());
+      
+      auto const& root = report.nodes[0];
+      auto const& node = report.nodes[1];
+      EXPECT_GE(node.tickTime, 1.4f);
+      EXPECT_GE(root.tickTime, node.tickTime);
+      
+      EXPECT_GE(report.nodes[2].eventTime, 0.4f);
+      EXPECT_GE(node.eventTime, report.nodes[2].eventTime);
+      EXPECT_GE(root.eventTime, node.eventTime);
+      EXPECT_LT(report.nodes[3].tickTime, 0.4f);
+      
+      inspector->stop();
+      EXPECT_FALSE(inspector->sampling());
+   }
+   
+   TEST_F(InspectorTest, IgnoresOtherThreads)
+   {
+      auto stage = flair::make_shared<TestStage>();
+      auto box = flair::make_shared<Box>();
+      stage->addChild(box);
+      box->addEventListener("busy", [](std::shared_ptr<Event>) { spin(100000); });
+      
+      auto inspector = flair::make_shared<Inspector>(stage, 1);
+      inspector->start();
+      stage->tick(0.016f);
+      
+      // A worker thread dispatching on the display list doesn't touch the samples
+      std::thread([&]() {
+         for (int i = 0; i < 10; ++i) box->dispatchEvent(flair::make_shared<Event>("busy"));
+      }).join();
+      EXPECT_EQ(0.0f, inspector->report().nodes[1].eventTime);
+      
+      box->dispatchEvent(flair::make_shared<Event>("busy"));
+      EXPECT_GT(inspector->report().nodes[1].eventTime, 0.0f);
+      inspector->stop();
+   }
+   
+   TEST_F(InspectorTest, ExportsJSON)
+   {
+      auto stage = flair::make_shared<TestStage>();
+      stage->addChild(flair::make_shared<Box>());
+      
+      auto inspector = flair::make_shared<Inspector>(stage);
+      inspector->start();
+      stage->tick(0.016f);
+      
+      flair::JSON json = *inspector;
+      EXPECT_EQ(1, json["frames"].int_value());
+      ASSERT_EQ(2u, json["nodes"].array_items().size());
+      EXPECT_EQ(2, json["nodes"][0]["objects"].int_value());
+      EXPECT_EQ(0, json["nodes"][1]["parent"].int_value());
+      EXPECT_TRUE(json["nodes"][1]["tickTime"].isNumber());
+   }
+   
+}
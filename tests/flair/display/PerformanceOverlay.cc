@@ -0,0 +1,161 @@
+#include "flair/flair.h"
+#include "flair/display/PerformanceOverlay.h"
+#include "flair/display/BitmapData.h"
+#include "flair/display/RenderSupport.h"
+#include "flair/internal/rendering/null/Texture.h"
+#include "flair/internal/services/null/RenderService.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+   using flair::display::BitmapData;
+   using flair::display::PerformanceOverlay;
+   using flair::display::RenderSupport;
+   using flair::geom::Rectangle;
+   using flair::internal::rendering::ITexture;
+   
+   // Remembers the rect of every upload made to the textures it creates
+   class UploadRenderService : public flair::internal::services::null::RenderService
+   {
+   public:
+      class Texture : public flair::internal::rendering::null::Texture
+      {
+      public:
+         Texture(int width, int height, PixelFormat format, Type type, std::vector<Rectangle> & uploads) : flair::internal::rendering::null::Texture(width, height, format, type), _uploads(uploads) {}
+         
+         void update(Rectangle rect, uint8_t const* pixels) override
+         {
+            _uploads.push_back(rect);
+         }
+         
+      private:
+         std::vector<Rectangle> & _uploads;
+      };
+      
+      ITexture * createTexture(int width, int height, ITexture::PixelFormat format, ITexture::Type type) override
+      {
+         return new Texture(width, height, format, type, uploads);
+      }
+      
+      std::vector<Rectangle> uploads;
+   };
+   
+   class TestBitmapData : public BitmapData
+   {
+   public:
+      static flair::internal::services::IRenderService * install(flair::internal::services::IRenderService * service)
+      {
+         auto previous = renderService;
+         renderService = service;
+         return previous;
+      }
+   };
+   
+   class TestSupport : public RenderSupport
+   {
+   public:
+      TestSupport(flair::internal::services::IRenderService * service)
+      {
+         _previous = renderService;
+         renderService = service;
+      }
+      
+      ~TestSupport()
+      {
+         renderService = _previous;
+      }
+      
+   private:
+      flair::internal::services::IRenderService * _previous;
+   };
+   
+   class PerformanceOverlayTest : public ::testing::Test
+   {
+   protected:
+      PerformanceOverlayTest() {}
+      virtual ~PerformanceOverlayTest() {}
+   };
+   
+   TEST_F(PerformanceOverlayTest, RedrawsFourTimesASecond)
+   {
+      auto overlay = flair::make_shared<PerformanceOverlay>();
+      for (int i = 0; i < 20; ++i) {
+         EXPECT_FALSE(overlay->due());
+         overlay->frame(12.5f, 10);
+      }
+      EXPECT_TRUE(overlay->due());
+      EXPECT_EQ("", overlay->lines()[0]);
+      
+      overlay->ioDepth(3, 12);
+      overlay->frame(12.5f, 10);
+      EXPECT_FALSE(overlay->due());
+      
+      auto const& lines = overlay->lines();
+      ASSERT_EQ(4u, lines.size());
+      EXPECT_EQ("80 FPS 12.5MS", lines[0]);
+      EXPECT_EQ("DRAW 10", lines[1]);
+      EXPECT_EQ(0u, lines[2].find("TEX "));
+      EXPECT_EQ("IO 3/12", lines[3]);
+   }
+   
+   TEST_F(PerformanceOverlayTest, AveragesSlowFrames)
+   {
+      auto overlay = flair::make_shared<PerformanceOverlay>();
+      overlay->frame(100.0f, 1);
+      overlay->frame(150.0f, 2);
+      overlay->frame(16.0f, 0);
+      
+      EXPECT_EQ("8 FPS 125MS", overlay->lines()[0]);
+      EXPECT_EQ("DRAW 2", overlay->lines()[1]);
+   }
+   
+   TEST_F(PerformanceOverlayTest, UploadsOnlyNewColumns)
+   {
+      UploadRenderService service;
+      auto previous = TestBitmapData::install(&service);
+      {
+         TestSupport support(&service);
+         auto overlay = flair::make_shared<PerformanceOverlay>();
+         auto render = [&]() {
+            service.uploads.clear();
+            overlay->render(&support, 1.0f, flair::geom::Matrix());
+            return service.uploads;
+         };
+         
+         // Four text lines and the whole graph the first time
+         auto uploads = render();
+         ASSERT_EQ(5u, uploads.size());
+         EXPECT_EQ(Rectangle(0, 0, 128, 40), uploads[4]);
+         EXPECT_TRUE(render().empty());
+         
+         overlay->frame(1.0f, 1);
+         uploads = render();
+         ASSERT_EQ(1u, uploads.size());
+         EXPECT_EQ(Rectangle(0, 0, 1, 40), uploads[0]);
+         
+         overlay->frame(1.0f, 1);
+         overlay->frame(1.0f, 1);
+         uploads = render();
+         ASSERT_EQ(1u, uploads.size());
+         EXPECT_EQ(Rectangle(1, 0, 2, 40), uploads[0]);
+         
+         // Across the right edge of the ring in two pieces
+         for (int i = 3; i < 126; ++i) overlay->frame(1.0f, 1);
+         render();
+         for (int i = 0; i < 4; ++i) overlay->frame(1.0f, 1);
+         uploads = render();
+         ASSERT_EQ(2u, uploads.size());
+         EXPECT_EQ(Rectangle(126, 0, 2, 40), uploads[0]);
+         EXPECT_EQ(Rectangle(0, 0, 2, 40), uploads[1]);
+         
+         // More than fit in the graph is all of it once
+         for (int i = 0; i < 200; ++i) overlay->frame(1.0f, 1);
+         uploads = render();
+         ASSERT_FALSE(uploads.empty());
+         EXPECT_EQ(Rectangle(0, 0, 128, 40), uploads.back());
+      }
+      TestBitmapData::install(previous);
+   }
+   
+}
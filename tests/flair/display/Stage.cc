@@ -0,0 +1,155 @@
+#include "flair/flair.h"
+#include "flair/display/Stage.h"
+#include "flair/display/Sprite.h"
+#include "flair/events/GamepadEvent.h"
+#include "gtest/gtest.h"
+
+namespace {
+   using flair::display::DisplayObject;
+   using flair::display::Sprite;
+   using flair::display::Stage;
+   using flair::geom::Point;
+   using flair::geom::Rectangle;
+   
+   class Box : public DisplayObject
+   {
+      friend flair::allocator;
+      
+   protected:
+      Box(float x, float y, float width, float height) : DisplayObject()
+      {
+         _x = x;
+         _y = y;
+         _width = width;
+         _height = height;
+      }
+      
+   public:
+      virtual ~Box() {}
+      
+      bool culled() const { return _culled; }
+      flair::geom::Rectangle worldBounds() const { return _worldBounds; }
+   };
+   
+   class TestStage : public Stage
+   {
+      friend flair::allocator;
+      
+   protected:
+      TestStage(int width, int height) : Stage()
+      {
+         _stageWidth = width;
+         _stageHeight = height;
+      }
+      
+   public:
+      using Stage::update;
+      
+      bool gamepadListened() const { return _gamepadListened; }
+   };
+   
+   class StageTest : public ::testing::Test
+   {
+   protected:
+      StageTest() {}
+      virtual ~StageTest() {}
+   };
+   
+   TEST_F(StageTest, HitTestPoints)
+   {
+      auto stage = flair::make_shared<Stage>();
+      auto layer = flair::make_shared<Sprite>();
+      auto below = flair::make_shared<Box>(0.0f, 0.0f, 100.0f, 100.0f);
+      auto above = flair::make_shared<Box>(50.0f, 50.0f, 100.0f, 100.0f);
+      auto hidden = flair::make_shared<Box>(200.0f, 0.0f, 50.0f, 50.0f);
+      auto untouchable = flair::make_shared<Box>(300.0f, 0.0f, 50.0f, 50.0f);
+      
+      layer->x(10.0f);
+      layer->addChild(below);
+      layer->addChild(above);
+      stage->addChild(layer);
+      stage->addChild(hidden);
+      stage->addChild(untouchable);
+      
+      hidden->visible(false);
+      untouchable->touchable(false);
+      
+      Point points[] = { Point(20.0f, 20.0f), Point(80.0f, 80.0f), Point(150.0f, 140.0f), Point(210.0f, 10.0f), Point(310.0f, 10.0f), Point(5.0f, 5.0f) };
+      std::shared_ptr<DisplayObject> targets[6];
+      stage->hitTestPoints(points, 6, targets);
+      
+      EXPECT_EQ(below, targets[0]);
+      EXPECT_EQ(above, targets[1]);
+      EXPECT_EQ(above, targets[2]);
+      EXPECT_EQ(nullptr, targets[3]);
+      EXPECT_EQ(nullptr, targets[4]);
+      EXPECT_EQ(nullptr, targets[5]);
+      
+      // Reordering children changes which one is on top
+      layer->setChildIndex(below, 1);
+      stage->hitTestPoints(points, 6, targets);
+      EXPECT_EQ(below, targets[1]);
+   }
+   
+   TEST_F(StageTest, Update)
+   {
+      auto stage = flair::make_shared<TestStage>(100, 100);
+      std::vector<std::shared_ptr<Sprite>> layers;
+      std::vector<std::shared_ptr<Box>> boxes;
+      
+      // Enough independent subtrees for the update to go parallel
+      for (int i = 0; i < 20; ++i) {
+         auto layer = flair::make_shared<Sprite>();
+         layer->x(i * 20.0f);
+         for (int j = 0; j < 50; ++j) {
+            auto box = flair::make_shared<Box>(0.0f, j * 10.0f, 10.0f, 10.0f);
+            layer->addChild(box);
+            boxes.push_back(box);
+         }
+         stage->addChild(layer);
+         layers.push_back(layer);
+      }
+      
+      auto check = [&]() {
+         for (auto const& box : boxes) {
+            Rectangle bounds = box->getBounds(nullptr);
+            ASSERT_EQ(bounds, box->worldBounds());
+            ASSERT_EQ(!bounds.intersects(Rectangle(0.0f, 0.0f, 100.0f, 100.0f)), box->culled());
+         }
+      };
+      
+      stage->update();
+      check();
+      EXPECT_FALSE(boxes[0]->culled());
+      EXPECT_TRUE(boxes[10]->culled());
+      EXPECT_TRUE(boxes[5 * 50]->culled());
+      
+      // Moving a container moves its whole subtree, moving a leaf only the leaf
+      layers[5]->x(-5.0f);
+      boxes[10]->y(50.0f);
+      stage->update();
+      check();
+      EXPECT_FALSE(boxes[5 * 50]->culled());
+      EXPECT_FALSE(boxes[10]->culled());
+      
+      // Removing a child only dirties the old parent
+      layers[0]->removeChild(boxes[0]);
+      stage->update();
+      check();
+   }
+   
+   TEST_F(StageTest, GamepadListeners)
+   {
+      auto stage = flair::make_shared<TestStage>(100, 100);
+      int dispatched = 0;
+      
+      stage->addEventListener(flair::events::Event::ENTER_FRAME, [&](std::shared_ptr<flair::events::Event>) { ++dispatched; });
+      EXPECT_FALSE(stage->gamepadListened());
+      
+      stage->addEventListener(flair::events::GamepadEvent::BUTTON_DOWN, [&](std::shared_ptr<flair::events::Event>) { ++dispatched; });
+      EXPECT_TRUE(stage->gamepadListened());
+      
+      stage->dispatchEvent(flair::make_shared<flair::events::Event>(flair::events::GamepadEvent::BUTTON_DOWN));
+      EXPECT_EQ(1, dispatched);
+   }
+}
@@ -2,10 +2,40 @@
 #include "flair/events/EventDispatcher.h"
 #include "gtest/gtest.h"
 
+#include <cstdlib>
+#include <new>
+
+namespace {
+   // Allocations of the calling thread, counted by the operator new below
+   thread_local uint64_t allocations = 0;
+}
+
+// Replaces the global operator new for the whole tests program, counting per thread so other
+// threads don't disturb a measurement
+void * operator new(std::size_t size)
+{
+   ++allocations;
+   void * pointer = std::malloc(size ? size : 1);
+   if (!pointer) throw std::bad_alloc();
+   return pointer;
+}
+
+void operator delete(void * pointer) noexcept
+{
+   std::free(pointer);
+}
+
 namespace {
    using flair::events::Event;
    using flair::events::EventDispatcher;
    
+   struct Counter
+   {
+      Counter() : count(0) {}
+      void onEvent(std::shared_ptr<Event>) { ++count; }
+      int count;
+   };
+   
    class EventDispatcherTest : public ::testing::Test
    {
    protected:
@@ -86,5 +116,63 @@ namespace {
       
       EXPECT_EQ(1, count);
    }
+   
+   TEST_F(EventDispatcherTest, Once)
+   {
+      int count = 0;
+      
+      auto eventDispatcher = flair::make_shared<EventDispatcher>();
+      eventDispatcher->addEventListener(Event::ACTIVATE, [&](std::shared_ptr<Event>) { count++; }, false, 0, true);
+      eventDispatcher->dispatchEvent(flair::make_shared<Event>(Event::ACTIVATE));
+      eventDispatcher->dispatchEvent(flair::make_shared<Event>(Event::ACTIVATE));
+      
+      EXPECT_EQ(1, count);
+      EXPECT_FALSE(eventDispatcher->hasEventListener(Event::ACTIVATE));
+   }
+   
+   TEST_F(EventDispatcherTest, RemoveWhileDispatching)
+   {
+      int completed = 0;
+      int failed = 0;
+      
+      auto eventDispatcher = flair::make_shared<EventDispatcher>();
+      auto onError = [&](std::shared_ptr<Event>) { failed++; };
+      auto onComplete = [&](std::shared_ptr<Event>) {
+         completed++;
+         eventDispatcher->removeEventListener(Event::ERROR, onError);
+         eventDispatcher->dispatchEvent(flair::make_shared<Event>(Event::ERROR));
+      };
+      
+      eventDispatcher->addEventListener(Event::COMPLETE, onComplete, false, 0, true);
+      eventDispatcher->addEventListener(Event::ERROR, onError);
+      eventDispatcher->dispatchEvent(flair::make_shared<Event>(Event::COMPLETE));
+      eventDispatcher->dispatchEvent(flair::make_shared<Event>(Event::COMPLETE));
+      
+      EXPECT_EQ(1, completed);
+      EXPECT_EQ(0, failed);
+      EXPECT_FALSE(eventDispatcher->hasEventListener(Event::COMPLETE));
+   }
+   
+   TEST_F(EventDispatcherTest, DispatchDoesNotAllocate)
+   {
+      auto eventDispatcher = flair::make_shared<EventDispatcher>();
+      auto nested = flair::make_shared<EventDispatcher>();
+      auto counter = std::make_shared<Counter>();
+      auto event = flair::make_shared<Event>(Event::ACTIVATE);
+      auto inner = flair::make_shared<Event>(Event::DEACTIVATE);
+      
+      // Member delegates capture more than fits in a function's own storage
+      eventDispatcher->addEventListener(Event::ACTIVATE, &Counter::onEvent, counter);
+      eventDispatcher->addEventListener(Event::ACTIVATE, &Counter::onEvent, counter, false, 1, true);
+      eventDispatcher->addEventListener(Event::ACTIVATE, [&](std::shared_ptr<Event>) { nested->dispatchEvent(inner); });
+      nested->addEventListener(Event::DEACTIVATE, &Counter::onEvent, counter);
+      
+      // The first dispatch grows the stack of listeners
+      eventDispatcher->dispatchEvent(event);
+      
+      uint64_t before = allocations;
+      for (int i = 0; i < 100; ++i) eventDispatcher->dispatchEvent(event);
+      EXPECT_EQ(before, allocations);
+      EXPECT_EQ(303, counter->count);
+   }
 }
-
@@ -102,4 +102,75 @@ namespace {
       EXPECT_FLOAT_EQ(-10.031801f, a.tx());
       EXPECT_FLOAT_EQ(-9.9680986f, a.ty());
    }
+   
+   TEST_F(MatrixTest, TransformPoints)
+   {
+      Matrix a;
+      a.translate(10, 10);
+      a.rotate(0.7f);
+      a.scale(2.0f, 0.5f);
+      
+      float points[14];
+      for (int i = 0; i < 14; ++i) {
+         points[i] = i * 3.5f - 20.0f;
+      }
+      
+      float out[14];
+      Matrix::transformPoints(a, points, out, 7);
+      
+      for (int i = 0; i < 7; ++i) {
+         Point p = a.transformPoint(Point(points[i * 2], points[i * 2 + 1]));
+         EXPECT_FLOAT_EQ(p.x(), out[i * 2]);
+         EXPECT_FLOAT_EQ(p.y(), out[i * 2 + 1]);
+      }
+   }
+   
+   TEST_F(MatrixTest, TransformRectangles)
+   {
+      Matrix a;
+      a.rotate(3.14159265f / 2.0f);
+      a.translate(5, 0);
+      
+      float rects[28];
+      for (int i = 0; i < 7; ++i) {
+         rects[i * 4] = i * 10.0f;
+         rects[i * 4 + 1] = 0.0f;
+         rects[i * 4 + 2] = 10.0f;
+         rects[i * 4 + 3] = 20.0f;
+      }
+      
+      Matrix::transformRectangles(a, rects, rects, 7);
+      
+      for (int i = 0; i < 7; ++i) {
+         EXPECT_NEAR(-15.0f, rects[i * 4], 0.0001f);
+         EXPECT_NEAR(i * 10.0f, rects[i * 4 + 1], 0.0001f);
+         EXPECT_NEAR(20.0f, rects[i * 4 + 2], 0.0001f);
+         EXPECT_NEAR(10.0f, rects[i * 4 + 3], 0.0001f);
+      }
+   }
+   
+   TEST_F(MatrixTest, Concat)
+   {
+      Matrix parents[3];
+      Matrix children[3];
+      for (int i = 0; i < 3; ++i) {
+         parents[i].rotate(0.3f * i);
+         parents[i].translate(i * 4.0f, 2.0f);
+         children[i].scale(1.5f, 0.5f + i);
+         children[i].translate(-3.0f, i * 7.0f);
+      }
+      
+      Matrix out[3];
+      Matrix::concat(parents, children, out, 3);
+      
+      for (int i = 0; i < 3; ++i) {
+         Matrix expected = parents[i] * children[i];
+         EXPECT_FLOAT_EQ(expected.a(), out[i].a());
+         EXPECT_FLOAT_EQ(expected.b(), out[i].b());
+         EXPECT_FLOAT_EQ(expected.c(), out[i].c());
+         EXPECT_FLOAT_EQ(expected.d(), out[i].d());
+         EXPECT_FLOAT_EQ(expected.tx(), out[i].tx());
+         EXPECT_FLOAT_EQ(expected.ty(), out[i].ty());
+      }
+   }
 }
@@ -0,0 +1,88 @@
+#include "flair/geom/Point.h"
+#include "flair/geom/Rectangle.h"
+#include "flair/geom/RectangleSet.h"
+#include "gtest/gtest.h"
+
+namespace {
+   using flair::geom::RectangleSet;
+   using flair::geom::Rectangle;
+   using flair::geom::Point;
+   
+   class RectangleSetTest : public ::testing::Test
+   {
+   protected:
+      RectangleSetTest()
+      {
+         // A grid with a ragged tail so both the vector and scalar paths are exercised
+         for (int i = 0; i < 71; ++i) {
+            rects.push_back(Rectangle((i % 9) * 12.0f - 20.0f, (i / 9) * 12.0f - 20.0f, 10.0f + (i % 3), 10.0f));
+            set.add(rects.back());
+         }
+      }
+      virtual ~RectangleSetTest() {}
+      
+      std::vector<Rectangle> rects;
+      RectangleSet set;
+   };
+   
+   TEST_F(RectangleSetTest, Storage)
+   {
+      EXPECT_EQ(71u, set.size());
+      
+      Rectangle r = set.rectangle(5);
+      EXPECT_FLOAT_EQ(rects[5].x(), r.x());
+      EXPECT_FLOAT_EQ(rects[5].y(), r.y());
+      EXPECT_FLOAT_EQ(rects[5].width(), r.width());
+      EXPECT_FLOAT_EQ(rects[5].height(), r.height());
+      
+      set.removeAt(5);
+      EXPECT_EQ(70u, set.size());
+      EXPECT_TRUE(set.rectangle(5) == rects[70]);
+   }
+   
+   TEST_F(RectangleSetTest, Intersecting)
+   {
+      Rectangle viewport(0.0f, 0.0f, 40.0f, 30.0f);
+      
+      std::vector<uint64_t> mask;
+      std::vector<uint32_t> indices;
+      set.intersectingMask(viewport, mask);
+      size_t count = set.intersecting(viewport, indices);
+      
+      ASSERT_EQ(2u, mask.size());
+      EXPECT_EQ(indices.size(), count);
+      
+      size_t expected = 0;
+      for (size_t i = 0; i < rects.size(); ++i) {
+         bool hit = rects[i].intersects(viewport);
+         EXPECT_EQ(hit, ((mask[i / 64] >> (i % 64)) & 1) != 0) << "rectangle " << i;
+         if (hit) {
+            ASSERT_LT(expected, indices.size());
+            EXPECT_EQ(i, indices[expected++]);
+         }
+      }
+      EXPECT_EQ(expected, count);
+   }
+   
+   TEST_F(RectangleSetTest, Containing)
+   {
+      Point p(22.0f, 5.0f);
+      
+      std::vector<uint64_t> mask;
+      std::vector<uint32_t> indices;
+      set.containingMask(p, mask);
+      set.containing(p, indices);
+      
+      size_t expected = 0;
+      for (size_t i = 0; i < rects.size(); ++i) {
+         bool hit = rects[i].containsPoint(p);
+         EXPECT_EQ(hit, ((mask[i / 64] >> (i % 64)) & 1) != 0) << "rectangle " << i;
+         if (hit) {
+            ASSERT_LT(expected, indices.size());
+            EXPECT_EQ(i, indices[expected++]);
+         }
+      }
+      EXPECT_EQ(expected, indices.size());
+      EXPECT_LT(0u, indices.size());
+   }
+}
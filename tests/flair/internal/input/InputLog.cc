@@ -0,0 +1,280 @@
+#include "flair/flair.h"
+#include "flair/internal/input/InputLog.h"
+#include "flair/internal/services/IKeyboardService.h"
+#include "flair/internal/services/IMouseService.h"
+#include "flair/internal/services/ITouchService.h"
+#include "flair/internal/services/base/GamepadService.h"
+#include "flair/utils/ByteArray.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+   using flair::internal::input::InputLog;
+   using flair::internal::services::GamepadState;
+   using flair::internal::services::GamepadTransition;
+   using flair::internal::services::IKeyboardService;
+   using flair::internal::services::IMouseService;
+   using flair::internal::services::ITouchService;
+   using flair::internal::services::TouchPoint;
+   using flair::utils::ByteArray;
+   
+   // The services keep what a frame collected, like the platform ones between two polls
+   class Keyboard : public IKeyboardService
+   {
+   public:
+      void modifiers(int shift, int alt, int ctrl, int os) override {}
+      void modifiers(int * shift, int * alt, int * ctrl, int * os) override {}
+      void key(uint32_t keyCode, int state, uint32_t timestamp) override {}
+      void key(uint32_t keyCode, int * state) override {}
+      bool capsLock() override { return false; }
+      bool numLock() override { return false; }
+      
+      void transitions(std::function<void(const KeyTransition & transition)> callback) override
+      {
+         for (auto const& key : keys) callback(key);
+      }
+      
+      void replay(const KeyTransition & transition) override { keys.push_back(transition); }
+      void clear() override { keys.clear(); }
+      
+      std::vector<KeyTransition> keys;
+   };
+   
+   class Mouse : public IMouseService
+   {
+   public:
+      Mouse() : X(0), Y(0) {}
+      
+      void motion(int X, int Y, int movementX, int movementY, uint32_t timestamp) override
+      {
+         flair::events::MouseEvent::Sample sample = { (float)X, (float)Y, (float)movementX, (float)movementY, timestamp };
+         samples.push_back(sample);
+      }
+      
+      void movement(int * X, int * Y) override {}
+      
+      void history(flair::events::MouseEvent::Sample const** samples, size_t * length) override
+      {
+         *samples = this->samples.data();
+         *length = this->samples.size();
+      }
+      
+      void location(int X, int Y) override { this->X = X; this->Y = Y; }
+      void location(int * X, int * Y) override { *X = this->X; *Y = this->Y; }
+      void button(uint32_t buttonCode, int state, uint32_t timestamp) override {}
+      void button(uint32_t buttonCode, int * state) override {}
+      
+      void buttonTransitions(std::function<void(const ButtonTransition & transition)> callback) override
+      {
+         for (auto const& button : buttons) callback(button);
+      }
+      
+      void replay(const ButtonTransition & transition) override { buttons.push_back(transition); }
+      
+      void clear() override
+      {
+         buttons.clear();
+         samples.clear();
+      }
+      
+      int X, Y;
+      std::vector<ButtonTransition> buttons;
+      std::vector<flair::events::MouseEvent::Sample> samples;
+   };
+   
+   class Touch : public ITouchService
+   {
+   public:
+      size_t activePoints() override { return touches.size(); }
+      
+      void touch(int64_t touchId, int phase, float X, float Y, float pressure, uint32_t timestamp) override
+      {
+         TouchPoint point = { touchId, phase, touches.empty(), X, Y, pressure, timestamp };
+         touches.push_back(point);
+      }
+      
+      void points(TouchPoint const** points, size_t * length) override
+      {
+         *points = touches.data();
+         *length = touches.size();
+      }
+      
+      void clear() override { touches.clear(); }
+      
+      std::vector<TouchPoint> touches;
+   };
+   
+   class Gamepads : public flair::internal::services::base::GamepadService
+   {
+   public:
+      bool backgroundPolling() override { return false; }
+      bool backgroundPolling(bool value) override { return false; }
+      void open() override {}
+      void deviceAdded(int deviceIndex) override {}
+      void deviceRemoved(int instanceId) override {}
+      
+      std::vector<GamepadTransition> collected()
+      {
+         std::vector<GamepadTransition> result;
+         transitions([&](const GamepadTransition & transition) { result.push_back(transition); });
+         return result;
+      }
+      
+   protected:
+      void read(uint32_t device, GamepadState * state) override {}
+   };
+   
+   class InputLogTest : public ::testing::Test
+   {
+   protected:
+      InputLogTest() {}
+      virtual ~InputLogTest() {}
+      
+      // Two frames with one of every record, the second without input
+      std::shared_ptr<ByteArray> record()
+      {
+         auto bytes = flair::make_shared<ByteArray>();
+         InputLog log(bytes);
+         log.begin();
+         
+         Keyboard keyboard;
+         Mouse mouse;
+         Touch touch;
+         Gamepads gamepads;
+         
+         keyboard.replay({ 65, 1, 100, 1, 0, 1, 0 });
+         mouse.replay({ 0, 1, 0, 104, 12, 34 });
+         mouse.motion(12, 34, 2, -3, 102);
+         mouse.location(12, 34);
+         touch.touch(7, 1, 0.25f, 0.75f, 0.5f, 103);
+         gamepads.replay({ GamepadTransition::AXIS, 1, 2, -0.5f, 101 });
+         log.record(0.016f, &keyboard, &mouse, &gamepads, &touch);
+         
+         keyboard.clear();
+         mouse.clear();
+         touch.clear();
+         gamepads.clear();
+         mouse.location(40, 50);
+         log.record(0.033f, &keyboard, &mouse, &gamepads, &touch);
+         
+         EXPECT_EQ(2u, log.frames());
+         return bytes;
+      }
+   };
+   
+   TEST_F(InputLogTest, ReplaysWhatWasRecorded)
+   {
+      auto bytes = record();
+      
+      // Through the serialized bytes, as a log read back from a file
+      std::vector<uint8_t> contents(bytes->length());
+      bytes->position(0);
+      bytes->readBytes(contents.data(), 0, contents.size());
+      auto file = flair::make_shared<ByteArray>();
+      file->writeBytes(contents.data(), 0, contents.size());
+      file->position(0);
+      
+      InputLog log(file);
+      ASSERT_TRUE(log.open());
+      
+      Keyboard keyboard;
+      Mouse mouse;
+      Touch touch;
+      Gamepads gamepads;
+      float delta = 0.0f;
+      
+      ASSERT_TRUE(log.replay(&delta, &keyboard, &mouse, &gamepads, &touch));
+      EXPECT_FLOAT_EQ(0.016f, delta);
+      
+      ASSERT_EQ(1u, keyboard.keys.size());
+      EXPECT_EQ(65u, keyboard.keys[0].keyCode);
+      EXPECT_EQ(1, keyboard.keys[0].state);
+      EXPECT_EQ(100u, keyboard.keys[0].timestamp);
+      EXPECT_EQ(1, keyboard.keys[0].shift);
+      EXPECT_EQ(1, keyboard.keys[0].ctrl);
+      
+      ASSERT_EQ(1u, mouse.buttons.size());
+      EXPECT_EQ(104u, mouse.buttons[0].timestamp);
+      EXPECT_EQ(12, mouse.buttons[0].X);
+      EXPECT_EQ(34, mouse.buttons[0].Y);
+      ASSERT_EQ(1u, mouse.samples.size());
+      EXPECT_EQ(2.0f, mouse.samples[0].movementX);
+      EXPECT_EQ(-3.0f, mouse.samples[0].movementY);
+      EXPECT_EQ(102u, mouse.samples[0].timestamp);
+      EXPECT_EQ(12, mouse.X);
+      EXPECT_EQ(34, mouse.Y);
+      
+      ASSERT_EQ(1u, touch.touches.size());
+      EXPECT_EQ(7, touch.touches[0].touchId);
+      EXPECT_EQ(0.75f, touch.touches[0].Y);
+      EXPECT_EQ(103u, touch.touches[0].timestamp);
+      
+      auto transitions = gamepads.collected();
+      ASSERT_EQ(1u, transitions.size());
+      EXPECT_EQ(GamepadTransition::AXIS, transitions[0].type);
+      EXPECT_EQ(1u, transitions[0].device);
+      EXPECT_EQ(-0.5f, transitions[0].value);
+      
+      // The quiet frame clears what the first one replayed
+      ASSERT_TRUE(log.replay(&delta, &keyboard, &mouse, &gamepads, &touch));
+      EXPECT_FLOAT_EQ(0.033f, delta);
+      EXPECT_TRUE(keyboard.keys.empty());
+      EXPECT_TRUE(mouse.buttons.empty());
+      EXPECT_TRUE(touch.touches.empty());
+      EXPECT_TRUE(gamepads.collected().empty());
+      EXPECT_EQ(40, mouse.X);
+      
+      EXPECT_FALSE(log.replay(&delta, &keyboard, &mouse, &gamepads, &touch));
+      EXPECT_EQ(2u, log.frames());
+   }
+   
+   TEST_F(InputLogTest, StopsAtATruncatedFrame)
+   {
+      auto bytes = record();
+      size_t length = bytes->length();
+      
+      // Cut inside a record of the first frame, nothing of it is replayed. Cut between two, the
+      // frame looks like one with less input.
+      std::vector<size_t> between = { 19, 31, 47, 68, 80 };
+      for (size_t cut = 7; cut < length - 13; ++cut) {
+         std::vector<uint8_t> contents(cut);
+         bytes->position(0);
+         bytes->readBytes(contents.data(), 0, cut);
+         auto file = flair::make_shared<ByteArray>();
+         file->writeBytes(contents.data(), 0, cut);
+         file->position(0);
+         
+         InputLog log(file);
+         ASSERT_TRUE(log.open());
+         
+         Keyboard keyboard;
+         Mouse mouse;
+         float delta = 0.0f;
+         bool whole = std::find(between.begin(), between.end(), cut) != between.end();
+         EXPECT_EQ(whole, log.replay(&delta, &keyboard, &mouse, nullptr, nullptr)) << cut;
+         EXPECT_EQ(whole && cut > 19, !keyboard.keys.empty()) << cut;
+         EXPECT_EQ(0u, file->bytesAvailable());
+         EXPECT_FALSE(log.replay(&delta, &keyboard, &mouse, nullptr, nullptr));
+      }
+      
+      // Into the second, the first still plays
+      std::vector<uint8_t> contents(length - 1);
+      bytes->position(0);
+      bytes->readBytes(contents.data(), 0, contents.size());
+      auto file = flair::make_shared<ByteArray>();
+      file->writeBytes(contents.data(), 0, contents.size());
+      file->position(0);
+      
+      InputLog log(file);
+      ASSERT_TRUE(log.open());
+      Keyboard keyboard;
+      float delta = 0.0f;
+      EXPECT_TRUE(log.replay(&delta, &keyboard, nullptr, nullptr, nullptr));
+      EXPECT_EQ(1u, keyboard.keys.size());
+      EXPECT_FALSE(log.replay(&delta, &keyboard, nullptr, nullptr, nullptr));
+      EXPECT_EQ(1u, log.frames());
+   }
+   
+}
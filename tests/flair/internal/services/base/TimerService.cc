@@ -0,0 +1,129 @@
+#include "flair/flair.h"
+#include "flair/internal/services/base/TimerService.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+   using flair::internal::services::base::TimerService;
+   
+   class TimerServiceTest : public ::testing::Test
+   {
+   protected:
+      TimerServiceTest() {}
+      virtual ~TimerServiceTest() {}
+   };
+   
+   TEST_F(TimerServiceTest, Cascade)
+   {
+      TimerService timers;
+      
+      // One delay on every wheel and on the slot edges between them
+      uint32_t delays[] = { 1, 63, 64, 65, 100, 4095, 4096, 5000, 262143, 262144, 300000 };
+      std::vector<uint64_t> fired;
+      for (auto delay : delays) {
+         timers.schedule(delay, 0, [&timers, &fired]() { fired.push_back(timers.now()); });
+      }
+      EXPECT_EQ(11u, timers.pending());
+      
+      for (uint64_t time = 7; time < 310000; time += 7) timers.update(time);
+      
+      ASSERT_EQ(11u, fired.size());
+      for (size_t i = 0; i < fired.size(); ++i) EXPECT_EQ(delays[i], fired[i]);
+      EXPECT_EQ(0u, timers.pending());
+      EXPECT_EQ(-1, timers.next());
+   }
+   
+   TEST_F(TimerServiceTest, Next)
+   {
+      TimerService timers;
+      EXPECT_EQ(-1, timers.next());
+      
+      timers.schedule(100, 0, []() {});
+      timers.update(63);
+      timers.schedule(50, 0, []() {});
+      
+      // The first timer is due in 37 milliseconds and still waits in the second wheel
+      int64_t next = timers.next();
+      EXPECT_GE(next, 1);
+      EXPECT_LE(next, 37);
+   }
+   
+   TEST_F(TimerServiceTest, NextIsNeverLate)
+   {
+      TimerService timers;
+      uint64_t target = 0;
+      uint32_t count = 0;
+      
+      // Updating only as far as next() says must still land on every due time
+      auto check = [&timers, &target, &count]() {
+         EXPECT_EQ(target, timers.now());
+         ++count;
+      };
+      
+      uint32_t delays[] = { 100, 700, 4100, 70000 };
+      for (auto delay : delays) timers.schedule(delay, 0, check);
+      timers.update(63);
+      timers.schedule(50, 0, check);
+      
+      for (int64_t next = timers.next(); next > 0; next = timers.next()) {
+         target = timers.now() + next;
+         timers.update(target);
+      }
+      EXPECT_EQ(5u, count);
+      EXPECT_EQ(70000u, timers.now());
+   }
+   
+   TEST_F(TimerServiceTest, CancelFromCallback)
+   {
+      TimerService timers;
+      
+      // A repeating timer that stops itself
+      uint32_t repeats = 0;
+      uint32_t repeating = 0;
+      repeating = timers.schedule(10, 10, [&]() {
+         if (++repeats == 3) {
+            EXPECT_TRUE(timers.cancel(repeating));
+         }
+      });
+      
+      // Two timers due in the same millisecond, whichever fires first cancels the other
+      uint32_t first = 0, second = 0, fired = 0;
+      first = timers.schedule(20, 0, [&]() { ++fired; timers.cancel(second); });
+      second = timers.schedule(20, 0, [&]() { ++fired; timers.cancel(first); });
+      
+      for (uint64_t time = 1; time <= 100; ++time) timers.update(time);
+      EXPECT_EQ(3u, repeats);
+      EXPECT_EQ(1u, fired);
+      EXPECT_FALSE(timers.active(repeating));
+      EXPECT_FALSE(timers.cancel(repeating));
+      EXPECT_FALSE(timers.active(first));
+      EXPECT_FALSE(timers.active(second));
+      EXPECT_EQ(0u, timers.pending());
+   }
+   
+   TEST_F(TimerServiceTest, RearmFromCallback)
+   {
+      TimerService timers;
+      std::vector<uint64_t> fired;
+      
+      // A one shot timer that schedules itself again, the new timer fires within the same update
+      std::function<void()> rearm = [&]() {
+         fired.push_back(timers.now());
+         if (fired.size() < 4) timers.schedule(fired.size() * 100, 0, rearm);
+      };
+      uint32_t id = timers.schedule(5, 0, rearm);
+      
+      timers.update(1000);
+      ASSERT_EQ(4u, fired.size());
+      EXPECT_EQ(5u, fired[0]);
+      EXPECT_EQ(105u, fired[1]);
+      EXPECT_EQ(305u, fired[2]);
+      EXPECT_EQ(605u, fired[3]);
+      
+      // The id of a completed timer stays invalid though its node is reused
+      EXPECT_FALSE(timers.active(id));
+      EXPECT_FALSE(timers.cancel(id));
+      EXPECT_EQ(0u, timers.pending());
+   }
+}
@@ -0,0 +1,239 @@
+#include "flair/flair.h"
+#include "flair/internal/services/capture/RenderService.h"
+#include "flair/internal/services/capture/RenderReplay.h"
+#include "flair/internal/services/null/RenderService.h"
+#include "flair/internal/rendering/null/Texture.h"
+#include "flair/utils/ByteArray.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+   using flair::geom::Matrix;
+   using flair::geom::Rectangle;
+   using flair::internal::rendering::ITexture;
+   using flair::internal::services::IWindowService;
+   using flair::internal::services::capture::RenderReplay;
+   using flair::utils::ByteArray;
+   
+   typedef flair::internal::services::capture::RenderService CaptureService;
+   
+   // Counts what reaches the backend, keeps the first pixel of the last upload
+   class CountingRenderService : public flair::internal::services::null::RenderService
+   {
+   public:
+      class Texture : public flair::internal::rendering::null::Texture
+      {
+      public:
+         Texture(int width, int height, PixelFormat format, Type type, CountingRenderService & service) : flair::internal::rendering::null::Texture(width, height, format, type), _service(service) {}
+         
+         void update(Rectangle rect, uint8_t const* pixels) override
+         {
+            _service.uploads++;
+            std::copy(pixels, pixels + 4, reinterpret_cast<uint8_t*>(&_service.lastPixel));
+         }
+         
+      private:
+         CountingRenderService & _service;
+      };
+      
+      CountingRenderService() : textures(0), draws(0), uploads(0), presents(0), lastPixel(0) {}
+      
+      ITexture * createTexture(int width, int height, ITexture::PixelFormat format, ITexture::Type type) override
+      {
+         textures++;
+         return new Texture(width, height, format, type, *this);
+      }
+      
+      void destroyTexture(ITexture * texture) override
+      {
+         textures--;
+         delete texture;
+      }
+      
+      void renderTexture(ITexture * texture, Rectangle srcRect, Rectangle dstRect) override { draws++; }
+      void renderTexture(ITexture * texture, Rectangle srcRect, Matrix transform) override { draws++; }
+      void present() override { presents++; }
+      
+      int textures;
+      int draws;
+      int uploads;
+      int presents;
+      uint32_t lastPixel;
+   };
+   
+   class Window : public IWindowService
+   {
+   public:
+      bool rootWindow() override { return true; }
+      Rectangle bounds() override { return Rectangle(0, 0, 320, 240); }
+      Rectangle bounds(Rectangle const& value) override { return value; }
+      bool active() override { return true; }
+      bool closing() override { return false; }
+      bool quiting() override { return false; }
+      bool minimzed() override { return false; }
+      bool maximized() override { return false; }
+      bool fullscreen() override { return false; }
+      bool visible() override { return true; }
+      uint32_t ticks() override { return 0; }
+      void create(std::string title, Rectangle const& bounds, uint32_t flags, bool root) override {}
+      void activate() override {}
+      void close() override {}
+      void minimize() override {}
+      void maximize() override {}
+      void restore() override {}
+      bool enterFullscreen(int width, int height, bool useClosestResolution) override { return false; }
+      void exitFullscreen() override {}
+      void poll(flair::internal::services::IGamepadService *, flair::internal::services::ITouchService *, flair::internal::services::IMouseService *, flair::internal::services::IKeyboardService *) override {}
+      void wait(int timeout) override {}
+      void wake() override {}
+   };
+   
+   class RenderCaptureTest : public ::testing::Test
+   {
+   protected:
+      RenderCaptureTest() {}
+      virtual ~RenderCaptureTest() {}
+      
+      static std::vector<uint8_t> contents(std::shared_ptr<ByteArray> bytes)
+      {
+         std::vector<uint8_t> result(bytes->length());
+         bytes->position(0);
+         bytes->readBytes(result.data(), 0, result.size());
+         bytes->position(0);
+         return result;
+      }
+      
+      static size_t occurrences(std::vector<uint8_t> const& haystack, std::vector<uint32_t> const& pixels)
+      {
+         auto first = reinterpret_cast<uint8_t const*>(pixels.data());
+         auto last = first + pixels.size() * 4;
+         size_t count = 0;
+         for (auto it = haystack.begin(); (it = std::search(it, haystack.end(), first, last)) != haystack.end(); ++it) count++;
+         return count;
+      }
+   };
+   
+   TEST_F(RenderCaptureTest, ReplaysWhatWasCaptured)
+   {
+      CountingRenderService backend;
+      Window window;
+      auto bytes = flair::make_shared<ByteArray>();
+      
+      std::vector<uint32_t> red(8, 0xffff0000), blue(8, 0xff0000ff);
+      auto upload = [](ITexture * texture, std::vector<uint32_t> const& pixels) {
+         texture->update(Rectangle(0, 0, 4, 2), reinterpret_cast<uint8_t const*>(pixels.data()));
+      };
+      
+      {
+         CaptureService capture(&backend, bytes, 2);
+         capture.create(&window, true);
+         auto texture = capture.createTexture(4, 2, ITexture::PixelFormat::BGRA, ITexture::Type::STATIC);
+         
+         upload(texture, red);
+         capture.clear();
+         capture.renderTexture(texture, Rectangle(0, 0, 4, 2), Matrix());
+         capture.renderTexture(texture, Rectangle(0, 0, 2, 2), Rectangle(10, 10, 2, 2));
+         capture.present();
+         EXPECT_FALSE(capture.finished());
+         
+         // The same content again is only referred to
+         upload(texture, red);
+         upload(texture, blue);
+         capture.renderTexture(texture, Rectangle(0, 0, 4, 2), Matrix(2.0f, 0.0f, 0.0f, 2.0f, 5.0f, 5.0f));
+         capture.present();
+         EXPECT_TRUE(capture.finished());
+         
+         // Past the requested frames the calls only reach the backend
+         size_t captured = bytes->length();
+         upload(texture, red);
+         capture.renderTexture(texture, Rectangle(0, 0, 4, 2), Matrix());
+         capture.present();
+         capture.destroyTexture(texture);
+         EXPECT_EQ(captured, bytes->length());
+      }
+      
+      EXPECT_EQ(4, backend.draws);
+      EXPECT_EQ(4, backend.uploads);
+      EXPECT_EQ(3, backend.presents);
+      EXPECT_EQ(0, backend.textures);
+      
+      auto captured = contents(bytes);
+      EXPECT_EQ(1u, occurrences(captured, red));
+      EXPECT_EQ(1u, occurrences(captured, blue));
+      
+      CountingRenderService replayed;
+      RenderReplay replay(bytes);
+      int width, height;
+      bool vsync;
+      ASSERT_TRUE(replay.open(&width, &height, &vsync));
+      EXPECT_EQ(320, width);
+      EXPECT_EQ(240, height);
+      EXPECT_TRUE(vsync);
+      
+      RenderReplay::FrameTiming timing;
+      ASSERT_TRUE(replay.next(&replayed, &timing));
+      EXPECT_EQ(0u, timing.frame);
+      EXPECT_EQ(2u, timing.drawCalls);
+      EXPECT_EQ(1u, timing.textureUploads);
+      EXPECT_EQ(0xffff0000, replayed.lastPixel);
+      
+      ASSERT_TRUE(replay.next(&replayed, &timing));
+      EXPECT_EQ(1u, timing.frame);
+      EXPECT_EQ(1u, timing.drawCalls);
+      EXPECT_EQ(2u, timing.textureUploads);
+      EXPECT_EQ(0xff0000ff, replayed.lastPixel);
+      
+      EXPECT_FALSE(replay.next(&replayed, &timing));
+      EXPECT_EQ(3, replayed.draws);
+      EXPECT_EQ(3, replayed.uploads);
+      EXPECT_EQ(2, replayed.presents);
+      
+      EXPECT_EQ(1, replayed.textures);
+      replay.close(&replayed);
+      EXPECT_EQ(0, replayed.textures);
+   }
+   
+   TEST_F(RenderCaptureTest, FinishesEarly)
+   {
+      CountingRenderService backend;
+      Window window;
+      auto bytes = flair::make_shared<ByteArray>();
+      
+      {
+         CaptureService capture(&backend, bytes, 60);
+         capture.create(&window, false);
+         auto texture = capture.createTexture(4, 2, ITexture::PixelFormat::BGRA, ITexture::Type::STATIC);
+         capture.renderTexture(texture, Rectangle(0, 0, 4, 2), Matrix());
+         capture.present();
+         
+         // The session ends here, the capture closes with the one frame
+         capture.finish();
+         EXPECT_TRUE(capture.finished());
+         
+         size_t captured = bytes->length();
+         capture.renderTexture(texture, Rectangle(0, 0, 4, 2), Matrix());
+         capture.present();
+         capture.finish();
+         capture.destroyTexture(texture);
+         EXPECT_EQ(captured, bytes->length());
+      }
+      
+      CountingRenderService replayed;
+      bytes->position(0);
+      RenderReplay replay(bytes);
+      int width, height;
+      bool vsync;
+      ASSERT_TRUE(replay.open(&width, &height, &vsync));
+      EXPECT_FALSE(vsync);
+      
+      RenderReplay::FrameTiming timing;
+      ASSERT_TRUE(replay.next(&replayed, &timing));
+      EXPECT_EQ(1u, timing.drawCalls);
+      EXPECT_FALSE(replay.next(&replayed, &timing));
+      replay.close(&replayed);
+      EXPECT_EQ(0, replayed.textures);
+   }
+   
+}
@@ -0,0 +1,185 @@
+#include "flair/internal/utils/Histogram.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+   using flair::internal::utils::Histogram;
+   
+   class HistogramTest : public ::testing::Test
+   {
+   protected:
+      HistogramTest() {}
+      virtual ~HistogramTest() {}
+      
+      // Spread over many powers of two, like latencies from microseconds to seconds
+      static std::vector<uint64_t> values(size_t count, uint64_t seed)
+      {
+         std::mt19937_64 random(seed);
+         std::uniform_real_distribution<double> exponent(0.0, 32.0);
+         std::vector<uint64_t> result;
+         for (size_t i = 0; i < count; ++i) result.push_back(static_cast<uint64_t>(std::exp2(exponent(random))));
+         return result;
+      }
+      
+      // The value of the given rank in the sorted values, the way percentile() counts ranks
+      static uint64_t reference(std::vector<uint64_t> sorted, double fraction)
+      {
+         std::sort(sorted.begin(), sorted.end());
+         size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(fraction * sorted.size())));
+         return sorted[rank - 1];
+      }
+      
+      const std::vector<double> fractions = { 0.0, 0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0 };
+   };
+   
+   TEST_F(HistogramTest, Empty)
+   {
+      Histogram histogram;
+      EXPECT_EQ(0u, histogram.count());
+      EXPECT_EQ(0u, histogram.min());
+      EXPECT_EQ(0u, histogram.max());
+      EXPECT_EQ(0.0, histogram.mean());
+      EXPECT_EQ(0u, histogram.percentile(0.5));
+   }
+   
+   TEST_F(HistogramTest, ExactBelowLinearRange)
+   {
+      Histogram histogram;
+      for (uint64_t value = 0; value < 32; ++value) histogram.record(value);
+      
+      for (uint64_t rank = 1; rank <= 32; ++rank) EXPECT_EQ(rank - 1, histogram.percentile(rank / 32.0));
+      EXPECT_EQ(15.5, histogram.mean());
+   }
+   
+   TEST_F(HistogramTest, MatchesSortedReference)
+   {
+      auto recorded = values(100000, 1);
+      Histogram histogram;
+      for (auto value : recorded) histogram.record(value);
+      
+      EXPECT_EQ(recorded.size(), histogram.count());
+      EXPECT_EQ(*std::min_element(recorded.begin(), recorded.end()), histogram.min());
+      EXPECT_EQ(*std::max_element(recorded.begin(), recorded.end()), histogram.max());
+      
+      // Never below the actual value and at most 1/16 above it
+      for (auto fraction : fractions) {
+         uint64_t expected = reference(recorded, fraction);
+         uint64_t actual = histogram.percentile(fraction);
+         EXPECT_GE(actual, expected) << fraction;
+         EXPECT_LE(actual, expected + expected / 16) << fraction;
+      }
+      EXPECT_EQ(histogram.max(), histogram.percentile(1.0));
+   }
+   
+   TEST_F(HistogramTest, BucketBoundaries)
+   {
+      Histogram histogram;
+      auto median = [&](uint64_t value) {
+         histogram.reset();
+         histogram.record(value);
+         histogram.record(UINT64_MAX);
+         return histogram.percentile(0.5);
+      };
+      
+      // Every bucket above the linear range, its first and last value share its top while the
+      // value before it tops the bucket below
+      for (uint32_t shift = 1; shift <= 58; ++shift) {
+         for (uint64_t sub = 16; sub < 32; ++sub) {
+            uint64_t first = sub << shift;
+            uint64_t last = first + (uint64_t(1) << shift) - 1;
+            ASSERT_EQ(last, median(first)) << first;
+            ASSERT_EQ(last, median(last)) << last;
+            ASSERT_EQ(first - 1, median(first - 1)) << first;
+            ASSERT_LE(last - first, first / 16);
+         }
+      }
+      
+      // The last bucket runs to the top of the range, clamped to what was recorded
+      histogram.reset();
+      histogram.record(UINT64_MAX - 1);
+      EXPECT_EQ(UINT64_MAX - 1, histogram.percentile(1.0));
+      EXPECT_EQ(UINT64_MAX, median(UINT64_MAX - 1));
+   }
+   
+   TEST_F(HistogramTest, MergeMatchesOneHistogram)
+   {
+      auto first = values(5000, 2);
+      auto second = values(20000, 3);
+      
+      Histogram a, b, all;
+      for (auto value : first) {
+         a.record(value);
+         all.record(value);
+      }
+      for (auto value : second) {
+         b.record(value);
+         all.record(value);
+      }
+      
+      Histogram merged;
+      merged.merge(a);
+      merged.merge(Histogram());
+      merged.merge(b);
+      
+      EXPECT_EQ(all.count(), merged.count());
+      EXPECT_EQ(all.min(), merged.min());
+      EXPECT_EQ(all.max(), merged.max());
+      EXPECT_DOUBLE_EQ(all.mean(), merged.mean());
+      
+      std::vector<uint64_t> recorded(first);
+      recorded.insert(recorded.end(), second.begin(), second.end());
+      for (auto fraction : fractions) {
+         EXPECT_EQ(all.percentile(fraction), merged.percentile(fraction)) << fraction;
+         
+         uint64_t expected = reference(recorded, fraction);
+         EXPECT_GE(merged.percentile(fraction), expected) << fraction;
+         EXPECT_LE(merged.percentile(fraction), expected + expected / 16) << fraction;
+      }
+   }
+   
+   TEST_F(HistogramTest, ResetForgetsEverything)
+   {
+      Histogram histogram;
+      for (auto value : values(1000, 4)) histogram.record(value);
+      histogram.record(1);
+      
+      histogram.reset();
+      EXPECT_EQ(0u, histogram.count());
+      EXPECT_EQ(0u, histogram.min());
+      EXPECT_EQ(0u, histogram.max());
+      EXPECT_EQ(0.0, histogram.mean());
+      EXPECT_EQ(0u, histogram.percentile(0.99));
+      
+      // No trace of the earlier minimum or of the old counts
+      histogram.record(1000);
+      histogram.record(3000);
+      EXPECT_EQ(1000u, histogram.min());
+      EXPECT_EQ(3000u, histogram.max());
+      EXPECT_EQ(2000.0, histogram.mean());
+      EXPECT_EQ(1023u, histogram.percentile(0.5));
+      EXPECT_EQ(3000u, histogram.percentile(0.99));
+   }
+   
+   TEST_F(HistogramTest, LatencyStatsInMilliseconds)
+   {
+      Histogram microseconds;
+      for (uint64_t value = 1; value <= 100; ++value) microseconds.record(value * 1000);
+      
+      auto stats = flair::internal::utils::latencyStats(microseconds);
+      EXPECT_EQ(100u, stats.count);
+      EXPECT_FLOAT_EQ(1.0f, stats.min);
+      EXPECT_FLOAT_EQ(50.5f, stats.mean);
+      EXPECT_FLOAT_EQ(100.0f, stats.max);
+      EXPECT_GE(stats.p50, 50.0f);
+      EXPECT_LE(stats.p50, 50.0f * 17 / 16);
+      EXPECT_GE(stats.p90, 90.0f);
+      EXPECT_LE(stats.p90, 90.0f * 17 / 16);
+      EXPECT_GE(stats.p99, 99.0f);
+      EXPECT_LE(stats.p99, 100.0f);
+   }
+   
+}
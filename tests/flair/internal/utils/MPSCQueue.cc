@@ -0,0 +1,138 @@
+#include "flair/internal/utils/MPSCQueue.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+   using flair::internal::utils::MPSCQueue;
+   
+   class MPSCQueueTest : public ::testing::Test
+   {
+   protected:
+      MPSCQueueTest() {}
+      virtual ~MPSCQueueTest() {}
+      
+      // Producer in the high half, its running count in the low half
+      static uint64_t value(uint32_t producer, uint32_t sequence)
+      {
+         return (uint64_t(producer) << 32) | sequence;
+      }
+   };
+   
+   TEST_F(MPSCQueueTest, PushAndPop)
+   {
+      MPSCQueue<int> queue;
+      int result = 0;
+      EXPECT_FALSE(queue.pop(result));
+      
+      EXPECT_TRUE(queue.push(1));
+      EXPECT_FALSE(queue.push(2));
+      EXPECT_EQ(2u, queue.size_approx());
+      
+      EXPECT_TRUE(queue.pop(result));
+      EXPECT_EQ(1, result);
+      EXPECT_TRUE(queue.pop(result));
+      EXPECT_EQ(2, result);
+      EXPECT_FALSE(queue.pop(result));
+      
+      // Empty again, the next push has to wake the consumer
+      EXPECT_TRUE(queue.push(3));
+   }
+   
+   TEST_F(MPSCQueueTest, ProducersKeepTheirOrder)
+   {
+      const uint32_t producers = 8;
+      const uint32_t pushes = 20000;
+      
+      MPSCQueue<uint64_t> queue;
+      std::vector<std::thread> threads;
+      for (uint32_t producer = 0; producer < producers; ++producer) {
+         threads.emplace_back([&queue, producer]() {
+            for (uint32_t sequence = 0; sequence < pushes; ++sequence) queue.push(value(producer, sequence));
+         });
+      }
+      
+      // Popped while the producers are still pushing, each one has to come out in the order it
+      // went in with nothing lost or seen twice
+      std::vector<uint32_t> next(producers, 0);
+      uint64_t received = 0;
+      bool ordered = true;
+      while (received < uint64_t(producers) * pushes) {
+         uint64_t result;
+         if (!queue.pop(result)) {
+            std::this_thread::yield();
+            continue;
+         }
+         
+         uint32_t producer = uint32_t(result >> 32);
+         ASSERT_LT(producer, producers);
+         if (uint32_t(result) != next[producer]) ordered = false;
+         next[producer] = uint32_t(result) + 1;
+         ++received;
+      }
+      
+      for (auto & thread : threads) thread.join();
+      
+      EXPECT_TRUE(ordered);
+      for (uint32_t producer = 0; producer < producers; ++producer) EXPECT_EQ(pushes, next[producer]);
+      
+      uint64_t result;
+      EXPECT_FALSE(queue.pop(result));
+      EXPECT_EQ(0u, queue.size_approx());
+   }
+   
+   TEST_F(MPSCQueueTest, DrainEmptiesTheQueue)
+   {
+      const uint32_t producers = 4;
+      const uint32_t pushes = 5000;
+      
+      MPSCQueue<uint64_t> queue;
+      std::vector<std::thread> threads;
+      for (uint32_t producer = 0; producer < producers; ++producer) {
+         threads.emplace_back([&queue, producer]() {
+            for (uint32_t sequence = 0; sequence < pushes; ++sequence) queue.push(value(producer, sequence));
+         });
+      }
+      
+      std::vector<uint32_t> next(producers, 0);
+      size_t drained = 0;
+      bool ordered = true;
+      auto consume = [&](uint64_t result) {
+         uint32_t producer = uint32_t(result >> 32);
+         if (producer >= producers || uint32_t(result) != next[producer]) ordered = false;
+         else next[producer]++;
+      };
+      while (drained < producers * pushes) drained += queue.drain(consume);
+      for (auto & thread : threads) thread.join();
+      
+      EXPECT_TRUE(ordered);
+      EXPECT_EQ(producers * pushes, drained);
+      EXPECT_EQ(0u, queue.drain(consume));
+      EXPECT_EQ(0u, queue.size_approx());
+      
+      uint64_t result;
+      EXPECT_FALSE(queue.pop(result));
+   }
+   
+   TEST_F(MPSCQueueTest, DrainStopsAtWhatWasQueued)
+   {
+      MPSCQueue<int> queue;
+      for (int i = 0; i < 3; ++i) queue.push(i);
+      
+      // Every value pushes another one, the drain still returns after the three it started with
+      std::vector<int> seen;
+      EXPECT_EQ(3u, queue.drain([&](int value) {
+         seen.push_back(value);
+         queue.push(value + 3);
+      }));
+      EXPECT_EQ((std::vector<int> { 0, 1, 2 }), seen);
+      EXPECT_EQ(3u, queue.size_approx());
+      
+      EXPECT_EQ(3u, queue.drain([&](int value) { seen.push_back(value); }));
+      EXPECT_EQ((std::vector<int> { 0, 1, 2, 3, 4, 5 }), seen);
+      EXPECT_EQ(0u, queue.drain([&](int value) { seen.push_back(value); }));
+   }
+   
+}
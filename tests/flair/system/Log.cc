@@ -0,0 +1,115 @@
+#include "flair/flair.h"
+#include "flair/system/Log.h"
+#include "flair/system/Memory.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace {
+   using flair::system::LogLevel;
+   
+   class Traced : public flair::Object
+   {
+      friend class flair::allocator;
+      
+   protected:
+      Traced() {}
+      
+   public:
+      std::string toString() const override { return "[object Traced]"; }
+   };
+   
+   class LogTest : public ::testing::Test
+   {
+   protected:
+      LogTest() {}
+      virtual ~LogTest()
+      {
+         flair::system::logLevel(LogLevel::FINE);
+      }
+      
+      std::string capture(std::function<void()> body)
+      {
+         flair::system::flushLog();
+         testing::internal::CaptureStdout();
+         body();
+         flair::system::flushLog();
+         return testing::internal::GetCapturedStdout();
+      }
+   };
+   
+   TEST_F(LogTest, FormatsArgumentsOnTheLogThread)
+   {
+      auto output = capture([]() {
+         std::string text = "text";
+         flair::trace("trace", 42, -7, 3u, 1.5, text, flair::make_shared<Traced>());
+         text = "changed";
+      });
+      EXPECT_EQ("trace 42 -7 3 1.500000 text [object Traced]\n", output);
+   }
+   
+   TEST_F(LogTest, FiltersLevels)
+   {
+      auto output = capture([]() {
+         flair::system::logLevel(LogLevel::WARNING);
+         FLAIR_LOG_FINE("fine");
+         FLAIR_LOG_INFO("info");
+         FLAIR_LOG_WARNING("warning", 1);
+         FLAIR_LOG_SEVERE("severe", 2);
+      });
+      EXPECT_EQ("[warning] warning 1\n[severe] severe 2\n", output);
+   }
+   
+   TEST_F(LogTest, CollectsEveryThread)
+   {
+      const int threads = 4;
+      const int messages = 500;
+      uint64_t dropped = flair::system::droppedLogMessages();
+      
+      auto output = capture([=]() {
+         std::vector<std::thread> writers;
+         for (int i = 0; i < threads; ++i) {
+            writers.push_back(std::thread([=]() {
+               for (int j = 0; j < messages; ++j) flair::trace("thread", i, "message", j);
+            }));
+         }
+         for (auto & writer : writers) writer.join();
+      });
+      
+      EXPECT_EQ(dropped, flair::system::droppedLogMessages());
+      EXPECT_EQ(threads * messages, std::count(output.begin(), output.end(), '\n'));
+      for (int i = 0; i < threads; ++i) {
+         EXPECT_NE(std::string::npos, output.find("thread " + std::to_string(i) + " message " + std::to_string(messages - 1) + "\n"));
+      }
+   }
+   
+   TEST_F(LogTest, ReusesTheBuffersOfExitedThreads)
+   {
+      auto buffers = []() {
+         for (auto const& usage : flair::system::memoryStats().usage) {
+            if (usage.name == "log buffers") return usage.count;
+         }
+         return int64_t(0);
+      };
+      
+      const int threads = 50;
+      int64_t before = 0;
+      auto output = capture([&]() {
+         flair::trace("before");
+         before = buffers();
+         
+         for (int i = 0; i < threads; ++i) {
+            std::thread([=]() { flair::trace("short lived", i); }).join();
+            flair::system::flushLog();
+         }
+      });
+      
+      // Each thread took over the drained buffer the one before it left behind
+      EXPECT_LE(buffers(), before + 1);
+      EXPECT_EQ(threads + 1, std::count(output.begin(), output.end(), '\n'));
+      EXPECT_NE(std::string::npos, output.find("short lived " + std::to_string(threads - 1) + "\n"));
+   }
+   
+}
@@ -0,0 +1,103 @@
+#include "flair/flair.h"
+#include "flair/events/EventDispatcher.h"
+#include "flair/system/Memory.h"
+#include "flair/utils/ByteArray.h"
+#include "gtest/gtest.h"
+
+namespace {
+   using flair::system::MemoryCategory;
+   using flair::system::MemoryUsage;
+   using flair::utils::ByteArray;
+   
+   class Tracked : public flair::Object
+   {
+      friend class flair::allocator;
+      
+   protected:
+      Tracked() {}
+      
+   private:
+      char payload[100];
+   };
+   
+   class MemoryTest : public ::testing::Test
+   {
+   protected:
+      MemoryTest() {}
+      virtual ~MemoryTest() {}
+      
+      MemoryUsage usage(MemoryCategory category, std::string const& name)
+      {
+         for (auto const& usage : flair::system::memoryStats().usage) {
+            if (usage.category == category && usage.name.find(name) != std::string::npos) return usage;
+         }
+         return MemoryUsage { category, name, 0, 0, 0, 0 };
+      }
+   };
+   
+   TEST_F(MemoryTest, CountsObjectsPerClass)
+   {
+      auto before = usage(MemoryCategory::OBJECT, "Tracked");
+      {
+         auto a = flair::make_shared<Tracked>();
+         auto b = flair::make_shared<Tracked>();
+         
+         auto live = usage(MemoryCategory::OBJECT, "Tracked");
+         EXPECT_EQ(before.count + 2, live.count);
+         EXPECT_EQ(before.bytes + 2 * static_cast<int64_t>(sizeof(Tracked)), live.bytes);
+      }
+      
+      auto after = usage(MemoryCategory::OBJECT, "Tracked");
+      EXPECT_EQ(before.count, after.count);
+      EXPECT_GE(after.peakCount, before.count + 2);
+   }
+   
+   TEST_F(MemoryTest, TracksByteArrayBuffers)
+   {
+      auto before = usage(MemoryCategory::BYTE_ARRAY, "ByteArray");
+      {
+         auto bytes = flair::make_shared<ByteArray>();
+         bytes->length(10000);
+         
+         auto live = usage(MemoryCategory::BYTE_ARRAY, "ByteArray");
+         EXPECT_EQ(before.count + 1, live.count);
+         EXPECT_GE(live.bytes - before.bytes, 10000);
+         
+         bytes->compress();
+         bytes->uncompress();
+         EXPECT_EQ(before.count + 1, usage(MemoryCategory::BYTE_ARRAY, "ByteArray").count);
+      }
+      
+      auto after = usage(MemoryCategory::BYTE_ARRAY, "ByteArray");
+      EXPECT_EQ(before.count, after.count);
+      EXPECT_EQ(before.bytes, after.bytes);
+   }
+   
+   TEST_F(MemoryTest, ResetsPeaks)
+   {
+      {
+         auto a = flair::make_shared<Tracked>();
+         auto b = flair::make_shared<Tracked>();
+      }
+      flair::system::resetMemoryPeaks();
+      
+      auto usage = this->usage(MemoryCategory::OBJECT, "Tracked");
+      EXPECT_EQ(usage.count, usage.peakCount);
+      
+      auto stats = flair::system::memoryStats();
+      EXPECT_EQ(stats.bytes, stats.peakBytes);
+   }
+   
+   TEST_F(MemoryTest, CountsEventListeners)
+   {
+      auto before = usage(MemoryCategory::EVENT_LISTENER, "listeners");
+      {
+         auto dispatcher = flair::make_shared<flair::events::EventDispatcher>();
+         dispatcher->addEventListener("a", [](std::shared_ptr<flair::events::Event>) {});
+         dispatcher->addEventListener("b", [](std::shared_ptr<flair::events::Event>) {});
+         EXPECT_EQ(before.count + 2, usage(MemoryCategory::EVENT_LISTENER, "listeners").count);
+      }
+      EXPECT_EQ(before.count, usage(MemoryCategory::EVENT_LISTENER, "listeners").count);
+   }
+   
+}
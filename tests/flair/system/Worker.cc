@@ -0,0 +1,179 @@
+#include "flair/flair.h"
+#include "flair/events/Event.h"
+#include "flair/system/Worker.h"
+#include "flair/system/MessageChannel.h"
+#include "flair/utils/ByteArray.h"
+#include "gtest/gtest.h"
+
+namespace {
+   using flair::events::Event;
+   using flair::system::MessageChannel;
+   using flair::system::MessageChannelState;
+   using flair::system::Worker;
+   using flair::system::WorkerState;
+   using flair::utils::ByteArray;
+   
+   class WorkerTest : public ::testing::Test
+   {
+   protected:
+      WorkerTest() {}
+      virtual ~WorkerTest() {}
+   };
+   
+   TEST_F(WorkerTest, Primordial)
+   {
+      auto primordial = Worker::current();
+      EXPECT_TRUE(primordial->isPrimordial());
+      EXPECT_EQ(WorkerState::RUNNING, primordial->state());
+      EXPECT_FALSE(primordial->terminate());
+      
+      auto worker = flair::make_shared<Worker>();
+      EXPECT_FALSE(worker->isPrimordial());
+      EXPECT_EQ(WorkerState::NEW, worker->state());
+      EXPECT_FALSE(worker->terminate());
+   }
+   
+   TEST_F(WorkerTest, KeepsStateBetweenMessages)
+   {
+      std::shared_ptr<MessageChannel> requests, replies;
+      
+      auto worker = flair::make_shared<Worker>([&]() {
+         auto total = std::make_shared<int>(0);
+         auto inbound = requests, outbound = replies;
+         inbound->addEventListener(Event::CHANNEL_MESSAGE, [=](std::shared_ptr<Event> event) {
+            MessageChannel::Message message;
+            while (inbound->receive(message)) {
+               *total += message.json.int_value();
+               outbound->send(*total);
+            }
+         });
+      });
+      
+      requests = Worker::current()->createMessageChannel(worker);
+      replies = worker->createMessageChannel(Worker::current());
+      worker->start();
+      EXPECT_EQ(WorkerState::RUNNING, worker->state());
+      
+      for (int i = 1; i <= 100; ++i) {
+         EXPECT_TRUE(requests->send(i));
+      }
+      
+      MessageChannel::Message message;
+      for (int i = 1; i <= 100; ++i) {
+         ASSERT_TRUE(replies->receive(message, true));
+         EXPECT_EQ(i * (i + 1) / 2, message.json.int_value());
+      }
+      EXPECT_FALSE(replies->receive(message));
+      
+      EXPECT_TRUE(worker->terminate());
+      EXPECT_EQ(WorkerState::TERMINATED, worker->state());
+   }
+   
+   TEST_F(WorkerTest, TransfersByteArray)
+   {
+      auto channel = Worker::current()->createMessageChannel(Worker::current());
+      
+      auto bytes = flair::make_shared<ByteArray>();
+      for (int i = 0; i < 4096; ++i) bytes->writeInt(i);
+      
+      EXPECT_TRUE(channel->send(bytes));
+      EXPECT_EQ(0, bytes->length());
+      
+      MessageChannel::Message message;
+      ASSERT_TRUE(channel->receive(message));
+      ASSERT_NE(nullptr, message.bytes);
+      EXPECT_EQ(4096 * 4, message.bytes->length());
+      
+      message.bytes->position(0);
+      for (int i = 0; i < 4096; ++i) EXPECT_EQ(i, message.bytes->readInt());
+      
+      // The sender can keep writing into its emptied ByteArray
+      bytes->writeInt(7);
+      bytes->position(0);
+      EXPECT_EQ(7, bytes->readInt());
+   }
+   
+   TEST_F(WorkerTest, Timers)
+   {
+      std::shared_ptr<MessageChannel> replies;
+      
+      auto worker = flair::make_shared<Worker>([&]() {
+         auto outbound = replies;
+         auto worker = Worker::current();
+         auto ticks = std::make_shared<int>(0);
+         auto interval = std::make_shared<uint32_t>(0);
+         
+         uint32_t cleared = worker->setTimer(1, [=]() { outbound->send("cleared"); });
+         worker->clearTimer(cleared);
+         
+         *interval = worker->setTimer(1, [=]() {
+            if (++*ticks == 3) {
+               worker->clearTimer(*interval);
+               outbound->send("interval");
+            }
+         }, true);
+         
+         worker->setTimer(2, [=]() { outbound->send("timeout"); });
+      });
+      
+      replies = worker->createMessageChannel(Worker::current());
+      worker->start();
+      
+      MessageChannel::Message first, second;
+      ASSERT_TRUE(replies->receive(first, true));
+      ASSERT_TRUE(replies->receive(second, true));
+      EXPECT_TRUE(first.json.string_value() == "interval" || second.json.string_value() == "interval");
+      EXPECT_TRUE(first.json.string_value() == "timeout" || second.json.string_value() == "timeout");
+      
+      EXPECT_TRUE(worker->terminate());
+      EXPECT_FALSE(replies->receive(first));
+   }
+   
+   TEST_F(WorkerTest, Close)
+   {
+      std::shared_ptr<MessageChannel> replies;
+      
+      auto worker = flair::make_shared<Worker>([&]() {
+         auto outbound = replies;
+         outbound->send(1);
+         outbound->close();
+         EXPECT_FALSE(outbound->send(2));
+      });
+      
+      replies = worker->createMessageChannel(Worker::current());
+      worker->start();
+      
+      MessageChannel::Message message;
+      ASSERT_TRUE(replies->receive(message, true));
+      EXPECT_EQ(1, message.json.int_value());
+      EXPECT_FALSE(replies->receive(message, true));
+      EXPECT_EQ(MessageChannelState::CLOSED, replies->state());
+      
+      EXPECT_TRUE(worker->terminate());
+   }
+   
+   
+   TEST_F(WorkerTest, ParallelFor)
+   {
+      std::vector<int> values(10000, 0);
+      for (size_t grain : { size_t(0), size_t(1), size_t(7), size_t(20000) }) {
+         Worker::parallelFor(values.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) values[i] += int(i);
+         }, grain);
+      }
+      for (size_t i = 0; i < values.size(); ++i) ASSERT_EQ(int(i) * 4, values[i]);
+      
+      // Nested loops run inline on the thread that reached them
+      std::atomic<int> total(0);
+      Worker::parallelFor(8, [&](size_t begin, size_t end) {
+         for (size_t i = begin; i < end; ++i) {
+            Worker::parallelFor(8, [&](size_t innerBegin, size_t innerEnd) { total += int(innerEnd - innerBegin); }, 1);
+         }
+      }, 1);
+      EXPECT_EQ(64, total);
+      
+      EXPECT_THROW(Worker::parallelFor(100, [](size_t begin, size_t end) {
+         if (begin <= 50 && 50 < end) throw std::runtime_error("range");
+      }, 1), std::runtime_error);
+   }
+}
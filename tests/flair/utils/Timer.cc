@@ -0,0 +1,69 @@
+#include "flair/flair.h"
+#include "flair/utils/Timer.h"
+#include "flair/events/TimerEvent.h"
+#include "flair/internal/services/base/TimerService.h"
+#include "gtest/gtest.h"
+
+namespace {
+   using flair::events::TimerEvent;
+   using flair::internal::services::base::TimerService;
+   using flair::utils::Timer;
+   
+   // Hands the service to the timers the way the application does
+   class ServiceTimer : public Timer
+   {
+   public:
+      static void install(TimerService * service) { timerService = service; }
+   };
+   
+   class TimerTest : public ::testing::Test
+   {
+   protected:
+      TimerTest() {}
+      virtual ~TimerTest()
+      {
+         ServiceTimer::install(nullptr);
+      }
+   };
+   
+   TEST_F(TimerTest, Repeats)
+   {
+      TimerService service;
+      ServiceTimer::install(&service);
+      
+      int ticks = 0, completes = 0;
+      auto timer = flair::make_shared<Timer>(10.0f, 3);
+      timer->addEventListener(TimerEvent::TIMER, [&ticks](std::shared_ptr<flair::events::Event>) { ++ticks; });
+      timer->addEventListener(TimerEvent::TIMER_COMPLETE, [&completes](std::shared_ptr<flair::events::Event>) { ++completes; });
+      timer->start();
+      
+      for (uint64_t time = 1; time <= 100; ++time) service.update(time);
+      EXPECT_EQ(3, timer->currentCount());
+      EXPECT_EQ(1, completes);
+      EXPECT_FALSE(timer->running());
+      EXPECT_EQ(0u, service.pending());
+   }
+   
+   TEST_F(TimerTest, OutlivesTheService)
+   {
+      auto stopped = flair::make_shared<Timer>(10.0f);
+      auto destroyed = flair::make_shared<Timer>(10.0f);
+      
+      // Stands in for the service of an application that shuts down with timers running
+      auto service = new TimerService();
+      ServiceTimer::install(service);
+      stopped->start();
+      destroyed->start();
+      EXPECT_EQ(2u, service->pending());
+      
+      ServiceTimer::install(nullptr);
+      delete service;
+      
+      // Neither touches the service that is gone
+      stopped->stop();
+      EXPECT_FALSE(stopped->running());
+      
+      EXPECT_TRUE(destroyed->running());
+      destroyed.reset();
+   }
+}
@@ -0,0 +1,72 @@
+#include "Allocations.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new for the whole bench program, one relaxed increment on top
+// of malloc.
+
+namespace {
+   std::atomic<uint64_t> count(0);
+   
+   void * allocate(std::size_t size)
+   {
+      count.fetch_add(1, std::memory_order_relaxed);
+      return std::malloc(size ? size : 1);
+   }
+}
+
+namespace flair {
+namespace bench {
+   
+   uint64_t allocations()
+   {
+      return count.load(std::memory_order_relaxed);
+   }
+   
+}}
+
+void * operator new(std::size_t size)
+{
+   void * pointer = allocate(size);
+   if (!pointer) throw std::bad_alloc();
+   return pointer;
+}
+
+void * operator new[](std::size_t size)
+{
+   void * pointer = allocate(size);
+   if (!pointer) throw std::bad_alloc();
+   return pointer;
+}
+
+void * operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+   return allocate(size);
+}
+
+void * operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+   return allocate(size);
+}
+
+void operator delete(void * pointer) noexcept
+{
+   std::free(pointer);
+}
+
+void operator delete[](void * pointer) noexcept
+{
+   std::free(pointer);
+}
+
+void operator delete(void * pointer, std::nothrow_t const&) noexcept
+{
+   std::free(pointer);
+}
+
+void operator delete[](void * pointer, std::nothrow_t const&) noexcept
+{
+   std::free(pointer);
+}
@@ -0,0 +1,15 @@
+#ifndef flair_bench_Allocations_h
+#define flair_bench_Allocations_h
+
+#include <cstdint>
+
+namespace flair {
+namespace bench {
+   
+   // Calls to operator new in the bench program from any thread since startup, take the
+   // difference around what is measured
+   uint64_t allocations();
+   
+}}
+
+#endif
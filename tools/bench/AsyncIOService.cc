@@ -0,0 +1,80 @@
+#include "Benchmark.h"
+
+#ifdef FLAIR_IO_UV
+
+#include "flair/internal/services/uv/AsyncIOService.h"
+#include "flair/internal/services/uv/WorkerService.h"
+
+#include <thread>
+
+namespace {
+   using namespace flair::internal::services;
+   
+   const int BATCH = 256;
+   
+   // Started once and left running, the loop thread and the pool would otherwise be part of
+   // every repetition
+   struct Services
+   {
+      Services()
+      {
+         asyncIOService = new uv::AsyncIOService();
+         workerService = new uv::WorkerService();
+         workerService->init(asyncIOService);
+      }
+      
+      // Polls as the frame loop would, until count requests came back
+      void wait(int const& completed, int count)
+      {
+         while (completed < count) {
+            asyncIOService->poll();
+            if (completed < count) std::this_thread::yield();
+         }
+      }
+      
+      uv::AsyncIOService * asyncIOService;
+      uv::WorkerService * workerService;
+   };
+   
+   Services & services()
+   {
+      static Services * services = new Services();
+      return *services;
+   }
+   
+   std::shared_ptr<IAsyncWorkerRequest::IWorkerResult> nothing()
+   {
+      return nullptr;
+   }
+   
+   // Enqueue, run on the pool, deliver on the next poll, one request at a time
+   FLAIR_BENCHMARK(AsyncIOServiceRoundTrip)
+   {
+      auto & io = services();
+      int completed = 0;
+      
+      while (state.next()) {
+         io.workerService->execute(nothing, [&completed](std::shared_ptr<IAsyncWorkerRequest>) { ++completed; });
+         io.wait(completed, completed + 1);
+      }
+   }
+   
+   // Many requests in flight, as when a level streams in
+   FLAIR_BENCHMARK(AsyncIOServiceThroughput)
+   {
+      auto & io = services();
+      int completed = 0;
+      state.items(BATCH);
+      
+      while (state.next()) {
+         completed = 0;
+         for (int i = 0; i < BATCH; ++i) {
+            io.workerService->execute(nothing, [&completed](std::shared_ptr<IAsyncWorkerRequest>) { ++completed; });
+         }
+         io.wait(completed, BATCH);
+      }
+   }
+   
+}
+
+#endif
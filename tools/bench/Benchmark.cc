@@ -0,0 +1,325 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <thread>
+
+namespace {
+   using flair::bench::Benchmark;
+   using flair::bench::Result;
+   using flair::bench::State;
+   
+   struct Entry
+   {
+      std::string name;
+      Benchmark benchmark;
+   };
+   
+   // Filled at static initialization, before main
+   std::vector<Entry> & registry()
+   {
+      static std::vector<Entry> entries;
+      return entries;
+   }
+   
+   struct Options
+   {
+      Options() : repetitions(10), warmup(1), minTime(50.0), iterations(0), list(false) {}
+      
+      std::string filter;
+      uint32_t repetitions;
+      uint32_t warmup;
+      
+      // Milliseconds a repetition should take at least, the iteration count is calibrated to it
+      double minTime;
+      
+      // Fixed iteration count instead of calibrating, 0 to calibrate
+      uint64_t iterations;
+      
+      std::string json;
+      std::string compare;
+      bool list;
+   };
+   
+   const uint64_t MAX_ITERATIONS = uint64_t(1) << 32;
+   
+   State measure(Benchmark const& benchmark, uint64_t iterations)
+   {
+      State state(iterations);
+      benchmark(state);
+      state.pause();
+      return state;
+   }
+   
+   // Grows the iteration count until a repetition takes at least minTime
+   uint64_t calibrate(Benchmark const& benchmark, double minTime)
+   {
+      double target = minTime * 1e6;
+      uint64_t iterations = 1;
+      while (iterations < MAX_ITERATIONS) {
+         double elapsed = static_cast<double>(measure(benchmark, iterations).elapsed());
+         if (elapsed >= target) break;
+         
+         // Aim a little past the target so the next round usually ends it
+         double factor = elapsed > 0.0 ? target * 1.4 / elapsed : 100.0;
+         iterations = static_cast<uint64_t>(iterations * std::min(std::max(factor, 2.0), 100.0));
+      }
+      return std::min(iterations, MAX_ITERATIONS);
+   }
+   
+   Result summarize(std::string const& name, uint64_t iterations, std::vector<double> samples, State const& last)
+   {
+      Result result;
+      result.name = name;
+      result.iterations = iterations;
+      result.samples = samples;
+      
+      std::sort(samples.begin(), samples.end());
+      size_t count = samples.size();
+      result.min = samples.front();
+      result.max = samples.back();
+      result.median = count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+      
+      double sum = 0.0;
+      for (double sample : samples) sum += sample;
+      result.mean = sum / count;
+      
+      double squares = 0.0;
+      for (double sample : samples) squares += (sample - result.mean) * (sample - result.mean);
+      result.stddev = count > 1 ? std::sqrt(squares / (count - 1)) : 0.0;
+      
+      result.itemsPerSecond = last.items() * 1e9 / result.median;
+      result.bytesPerSecond = last.bytes() * 1e9 / result.median;
+      return result;
+   }
+   
+   std::string formatTime(double nanoseconds)
+   {
+      char buffer[32];
+      if (nanoseconds < 1e3) std::snprintf(buffer, sizeof(buffer), "%.2f ns", nanoseconds);
+      else if (nanoseconds < 1e6) std::snprintf(buffer, sizeof(buffer), "%.2f us", nanoseconds / 1e3);
+      else std::snprintf(buffer, sizeof(buffer), "%.2f ms", nanoseconds / 1e6);
+      return buffer;
+   }
+   
+   std::string formatRate(Result const& result)
+   {
+      char buffer[32];
+      if (result.bytesPerSecond > 0.0) std::snprintf(buffer, sizeof(buffer), "%.1f MB/s", result.bytesPerSecond / 1048576.0);
+      else if (result.itemsPerSecond > 0.0) std::snprintf(buffer, sizeof(buffer), "%.3g items/s", result.itemsPerSecond);
+      else buffer[0] = '\0';
+      return buffer;
+   }
+   
+   bool parseOptions(int argc, char ** argv, Options & options)
+   {
+      for (int i = 1; i < argc; ++i) {
+         const char * argument = argv[i];
+         const char * value = std::strchr(argument, '=');
+         std::string name = value ? std::string(argument, value - argument) : argument;
+         value = value ? value + 1 : "";
+         
+         if (name == "--filter") options.filter = value;
+         else if (name == "--repetitions") options.repetitions = std::max(1, std::atoi(value));
+         else if (name == "--warmup") options.warmup = std::max(0, std::atoi(value));
+         else if (name == "--min-time") options.minTime = std::atof(value);
+         else if (name == "--iterations") options.iterations = std::strtoull(value, nullptr, 10);
+         else if (name == "--json") options.json = value;
+         else if (name == "--compare") options.compare = value;
+         else if (name == "--list") options.list = true;
+         else {
+            std::fprintf(stderr, "usage: bench [--filter=text] [--repetitions=10] [--warmup=1] [--min-time=ms] [--iterations=n] [--json=out.json] [--compare=baseline.json] [--list]\n");
+            return false;
+         }
+      }
+      return true;
+   }
+   
+   // Median times by benchmark name, and the iteration counts they were taken with
+   bool loadBaseline(std::string const& path, std::map<std::string, flair::JSON> & baseline)
+   {
+      std::ifstream file(path);
+      if (!file) return false;
+      
+      std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+      std::string error;
+      flair::JSON json = flair::JSON::parse(contents, error);
+      if (!error.empty()) return false;
+      
+      for (auto const& benchmark : json["benchmarks"].array_items()) {
+         baseline[benchmark["name"].string_value()] = benchmark;
+      }
+      return true;
+   }
+}
+
+namespace flair {
+namespace bench {
+   
+   State::State(uint64_t iterations) : _iterations(iterations), _next(0), _running(false), _elapsed(0), _items(0), _bytes(0)
+   {
+   
+   }
+   
+   uint64_t State::iterations() const
+   {
+      return _iterations;
+   }
+   
+   uint64_t State::elapsed() const
+   {
+      return _elapsed;
+   }
+   
+   uint64_t State::items() const
+   {
+      return _items;
+   }
+   
+   uint64_t State::items(uint64_t value)
+   {
+      return _items = value;
+   }
+   
+   uint64_t State::bytes() const
+   {
+      return _bytes;
+   }
+   
+   uint64_t State::bytes(uint64_t value)
+   {
+      return _bytes = value;
+   }
+   
+   void State::pause()
+   {
+      if (!_running) return;
+      
+      _elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+      _running = false;
+   }
+   
+   void State::resume()
+   {
+      if (_running) return;
+      
+      _running = true;
+      _start = std::chrono::steady_clock::now();
+   }
+   
+   flair::JSON Result::toJSON() const
+   {
+      return flair::JSON::Object {
+         { "name", name },
+         { "iterations", static_cast<double>(iterations) },
+         { "samples", samples },
+         { "min", min },
+         { "median", median },
+         { "mean", mean },
+         { "stddev", stddev },
+         { "max", max },
+         { "itemsPerSecond", itemsPerSecond },
+         { "bytesPerSecond", bytesPerSecond }
+      };
+   }
+   
+   Registration::Registration(const char * name, Benchmark benchmark)
+   {
+      registry().push_back(Entry{ name, benchmark });
+   }
+   
+   int run(int argc, char ** argv)
+   {
+      Options options;
+      if (!parseOptions(argc, argv, options)) return 1;
+      
+      std::vector<Entry> entries;
+      for (auto const& entry : registry()) {
+         if (entry.name.find(options.filter) != std::string::npos) entries.push_back(entry);
+      }
+      std::sort(entries.begin(), entries.end(), [](Entry const& a, Entry const& b) { return a.name < b.name; });
+      
+      if (options.list) {
+         for (auto const& entry : entries) std::printf("%s\n", entry.name.c_str());
+         return 0;
+      }
+      
+      std::map<std::string, flair::JSON> baseline;
+      if (!options.compare.empty() && !loadBaseline(options.compare, baseline)) {
+         std::fprintf(stderr, "Could not read %s\n", options.compare.c_str());
+         return 1;
+      }
+
+#ifndef NDEBUG
+      std::fprintf(stderr, "Warning: built without NDEBUG, the numbers are not representative\n");
+#endif
+      
+      std::printf("%-36s %12s %12s %12s %8s %16s%s\n", "benchmark", "iterations", "median", "min", "stddev", "throughput", baseline.empty() ? "" : "      change");
+      
+      std::vector<Result> results;
+      for (auto const& entry : entries) {
+         // Against a baseline the same work is measured again unless told otherwise
+         uint64_t iterations = options.iterations;
+         auto previous = baseline.find(entry.name);
+         if (!iterations && previous != baseline.end()) iterations = static_cast<uint64_t>(previous->second["iterations"].number_value());
+         if (!iterations) iterations = calibrate(entry.benchmark, options.minTime);
+         
+         for (uint32_t i = 0; i < options.warmup; ++i) {
+            measure(entry.benchmark, iterations);
+         }
+         
+         std::vector<double> samples;
+         State last(iterations);
+         for (uint32_t i = 0; i < options.repetitions; ++i) {
+            last = measure(entry.benchmark, iterations);
+            samples.push_back(static_cast<double>(last.elapsed()) / iterations);
+         }
+         
+         Result result = summarize(entry.name, iterations, samples, last);
+         results.push_back(result);
+         
+         std::string change;
+         if (previous != baseline.end()) {
+            double median = previous->second["median"].number_value();
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%+11.1f%%", median > 0.0 ? (result.median - median) / median * 100.0 : 0.0);
+            change = buffer;
+         }
+         
+         std::printf("%-36s %12llu %12s %12s %7.1f%% %16s%s\n", result.name.c_str(), static_cast<unsigned long long>(iterations), formatTime(result.median).c_str(),
+            formatTime(result.min).c_str(), result.mean > 0.0 ? result.stddev / result.mean * 100.0 : 0.0, formatRate(result).c_str(), change.c_str());
+         std::fflush(stdout);
+      }
+      
+      if (!options.json.empty()) {
+#ifdef NDEBUG
+         const char * build = "release";
+#else
+         const char * build = "debug";
+#endif
+         flair::JSON json = flair::JSON::Object {
+            { "context", flair::JSON::Object {
+               { "build", build },
+               { "threads", static_cast<int>(std::thread::hardware_concurrency()) },
+               { "repetitions", static_cast<int>(options.repetitions) },
+               { "warmup", static_cast<int>(options.warmup) }
+            } },
+            { "benchmarks", results }
+         };
+         
+         std::ofstream file(options.json);
+         file << json.stringify() << '\n';
+         if (!file) {
+            std::fprintf(stderr, "Could not write %s\n", options.json.c_str());
+            return 1;
+         }
+      }
+      return 0;
+   }
+   
+}}
@@ -0,0 +1,117 @@
+#ifndef flair_bench_Benchmark_h
+#define flair_bench_Benchmark_h
+
+#include "flair/flair.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace flair {
+namespace bench {
+   
+   // Handed to a benchmark for one repetition. The clock runs from the first next() to the one
+   // that returns false, so setup before the loop is not measured:
+   //
+   //    FLAIR_BENCHMARK(Name) { setup(); while (state.next()) { work(); } }
+   class State
+   {
+   public:
+      State(uint64_t iterations);
+      
+   // Properties
+   public:
+      uint64_t iterations() const;
+      
+      // Nanoseconds measured so far
+      uint64_t elapsed() const;
+      
+      // Work done by one iteration, reported as throughput
+      uint64_t items() const;
+      uint64_t items(uint64_t value);
+      
+      uint64_t bytes() const;
+      uint64_t bytes(uint64_t value);
+      
+   // Methods
+   public:
+      bool next()
+      {
+         if (_next < _iterations) {
+            if (_next++ == 0) resume();
+            return true;
+         }
+         pause();
+         return false;
+      }
+      
+      // Leaves per iteration setup out of the measurement
+      void pause();
+      void resume();
+      
+   private:
+      uint64_t _iterations;
+      uint64_t _next;
+      
+      std::chrono::steady_clock::time_point _start;
+      bool _running;
+      uint64_t _elapsed;
+      
+      uint64_t _items;
+      uint64_t _bytes;
+   };
+   
+   // Per operation times over the measured repetitions, in nanoseconds
+   struct Result
+   {
+      std::string name;
+      uint64_t iterations;
+      std::vector<double> samples;
+      
+      double min;
+      double median;
+      double mean;
+      double stddev;
+      double max;
+      
+      // 0 where the benchmark did not say what an iteration processes
+      double itemsPerSecond;
+      double bytesPerSecond;
+      
+      flair::JSON toJSON() const;
+   };
+   
+   typedef std::function<void(State &)> Benchmark;
+   
+   // Adds a benchmark to those run(), FLAIR_BENCHMARK does this at static initialization
+   struct Registration
+   {
+      Registration(const char * name, Benchmark benchmark);
+   };
+   
+   // Runs the registered benchmarks as the command line selects and prints a table, returns the
+   // exit code of the bench program
+   int run(int argc, char ** argv);
+   
+   // Keeps the compiler from optimizing away a result that is never used
+   template <class T>
+   inline void keep(T const& value)
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      asm volatile("" : : "r,m"(value) : "memory");
+#else
+      static volatile char sink;
+      sink = *reinterpret_cast<char const volatile*>(&value);
+#endif
+   }
+   
+}}
+
+#define FLAIR_BENCHMARK(name) \
+   static void name(flair::bench::State & state); \
+   static flair::bench::Registration name##Registration(#name, name); \
+   static void name(flair::bench::State & state)
+
+#endif
@@ -0,0 +1,126 @@
+#include "Benchmark.h"
+#include "flair/utils/ByteArray.h"
+
+#include <vector>
+
+namespace {
+   using flair::utils::ByteArray;
+   
+   const int VALUES = 1024;
+   const size_t COMPRESS_SIZE = 64 * 1024;
+   
+   // Repetitive enough to compress about as well as typical save data
+   void fill(std::shared_ptr<ByteArray> const& bytes)
+   {
+      bytes->clear();
+      uint32_t seed = 1;
+      for (size_t i = 0; i < COMPRESS_SIZE / 4; ++i) {
+         seed = seed * 1664525 + 1013904223;
+         bytes->writeInt(i % 64 < 48 ? static_cast<int32_t>(i & 0xff) : static_cast<int32_t>(seed >> 8));
+      }
+   }
+   
+   FLAIR_BENCHMARK(ByteArrayWriteInt)
+   {
+      auto bytes = flair::make_shared<ByteArray>();
+      state.items(VALUES);
+      state.bytes(VALUES * 4);
+      
+      while (state.next()) {
+         bytes->position(0);
+         for (int i = 0; i < VALUES; ++i) bytes->writeInt(i);
+      }
+   }
+   
+   FLAIR_BENCHMARK(ByteArrayReadInt)
+   {
+      auto bytes = flair::make_shared<ByteArray>();
+      for (int i = 0; i < VALUES; ++i) bytes->writeInt(i);
+      state.items(VALUES);
+      state.bytes(VALUES * 4);
+      
+      int32_t sum = 0;
+      while (state.next()) {
+         bytes->position(0);
+         for (int i = 0; i < VALUES; ++i) sum += bytes->readInt();
+      }
+      flair::bench::keep(sum);
+   }
+   
+   FLAIR_BENCHMARK(ByteArrayWriteDouble)
+   {
+      auto bytes = flair::make_shared<ByteArray>();
+      state.items(VALUES);
+      state.bytes(VALUES * 8);
+      
+      while (state.next()) {
+         bytes->position(0);
+         for (int i = 0; i < VALUES; ++i) bytes->writeDouble(i * 0.5);
+      }
+   }
+   
+   FLAIR_BENCHMARK(ByteArrayReadDouble)
+   {
+      auto bytes = flair::make_shared<ByteArray>();
+      for (int i = 0; i < VALUES; ++i) bytes->writeDouble(i * 0.5);
+      state.items(VALUES);
+      state.bytes(VALUES * 8);
+      
+      double sum = 0.0;
+      while (state.next()) {
+         bytes->position(0);
+         for (int i = 0; i < VALUES; ++i) sum += bytes->readDouble();
+      }
+      flair::bench::keep(sum);
+   }
+   
+   FLAIR_BENCHMARK(ByteArrayWriteReadUTF)
+   {
+      auto bytes = flair::make_shared<ByteArray>();
+      std::string text = "The quick brown fox jumps over the lazy dog";
+      state.items(VALUES);
+      
+      while (state.next()) {
+         bytes->position(0);
+         for (int i = 0; i < VALUES; ++i) bytes->writeUTF(text);
+         bytes->position(0);
+         for (int i = 0; i < VALUES; ++i) flair::bench::keep(bytes->readUTF());
+      }
+   }
+   
+   FLAIR_BENCHMARK(ByteArrayCompress)
+   {
+      auto bytes = flair::make_shared<ByteArray>();
+      state.bytes(COMPRESS_SIZE);
+      
+      while (state.next()) {
+         state.pause();
+         fill(bytes);
+         state.resume();
+         
+         bytes->compress();
+      }
+   }
+   
+   FLAIR_BENCHMARK(ByteArrayUncompress)
+   {
+      auto bytes = flair::make_shared<ByteArray>();
+      fill(bytes);
+      bytes->compress();
+      
+      std::vector<uint8_t> compressed(bytes->length());
+      bytes->position(0);
+      bytes->readBytes(compressed.data(), 0, compressed.size());
+      state.bytes(COMPRESS_SIZE);
+      
+      while (state.next()) {
+         state.pause();
+         bytes->clear();
+         bytes->writeBytes(compressed.data(), 0, compressed.size());
+         state.resume();
+         
+         bytes->uncompress();
+      }
+   }
+   
+}
@@ -0,0 +1,75 @@
+#include "Benchmark.h"
+#include "Headless.h"
+#include "flair/display/Sprite.h"
+
+#include <vector>
+
+namespace {
+   using flair::bench::HeadlessStage;
+   using flair::display::DisplayObject;
+   using flair::display::Sprite;
+   
+   const int CHILDREN = 256;
+   
+   std::vector<std::shared_ptr<DisplayObject>> sprites()
+   {
+      std::vector<std::shared_ptr<DisplayObject>> children;
+      for (int i = 0; i < CHILDREN; ++i) {
+         auto sprite = flair::make_shared<Sprite>();
+         sprite->name("sprite" + std::to_string(i));
+         children.push_back(sprite);
+      }
+      return children;
+   }
+   
+   FLAIR_BENCHMARK(DisplayObjectContainerAddRemove)
+   {
+      auto container = flair::make_shared<Sprite>();
+      auto children = sprites();
+      state.items(CHILDREN);
+      
+      while (state.next()) {
+         for (auto const& child : children) container->addChild(child);
+         for (auto const& child : children) container->removeChild(child);
+      }
+   }
+   
+   // Every child is added to and removed from the stage, with the events that go with it
+   FLAIR_BENCHMARK(DisplayObjectContainerAddRemoveOnStage)
+   {
+      auto stage = flair::make_shared<HeadlessStage>();
+      auto container = flair::make_shared<Sprite>();
+      stage->addChild(container);
+      auto children = sprites();
+      state.items(CHILDREN);
+      
+      while (state.next()) {
+         for (auto const& child : children) container->addChild(child);
+         container->removeChildren();
+      }
+   }
+   
+   FLAIR_BENCHMARK(DisplayObjectContainerAddAtFront)
+   {
+      auto container = flair::make_shared<Sprite>();
+      auto children = sprites();
+      state.items(CHILDREN);
+      
+      while (state.next()) {
+         for (auto const& child : children) container->addChildAt(child, 0);
+         container->removeChildren();
+      }
+   }
+   
+   FLAIR_BENCHMARK(DisplayObjectContainerGetChildByName)
+   {
+      auto container = flair::make_shared<Sprite>();
+      for (auto const& child : sprites()) container->addChild(child);
+      std::string name = "sprite" + std::to_string(CHILDREN / 2);
+      
+      while (state.next()) {
+         flair::bench::keep(container->getChildByName(name));
+      }
+   }
+   
+}
@@ -0,0 +1,81 @@
+#include "Benchmark.h"
+#include "flair/events/Event.h"
+#include "flair/events/EventDispatcher.h"
+
+namespace {
+   using flair::events::Event;
+   using flair::events::EventDispatcher;
+   
+   // Listeners are told apart by type, so every one that should stay registered needs its own
+   template <int N>
+   struct Listener
+   {
+      int * calls;
+      
+      void operator()(std::shared_ptr<Event>)
+      {
+         ++*calls;
+      }
+   };
+   
+   FLAIR_BENCHMARK(EventDispatcherAddRemove)
+   {
+      auto dispatcher = flair::make_shared<EventDispatcher>();
+      int calls = 0;
+      
+      while (state.next()) {
+         dispatcher->addEventListener(Event::ENTER_FRAME, Listener<0>{ &calls });
+         dispatcher->removeEventListener(Event::ENTER_FRAME, Listener<0>{ &calls });
+      }
+   }
+   
+   FLAIR_BENCHMARK(EventDispatcherDispatch)
+   {
+      auto dispatcher = flair::make_shared<EventDispatcher>();
+      auto event = flair::make_shared<Event>(Event::ENTER_FRAME);
+      int calls = 0;
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<0>{ &calls });
+      
+      while (state.next()) {
+         dispatcher->dispatchEvent(event);
+      }
+      flair::bench::keep(calls);
+   }
+   
+   FLAIR_BENCHMARK(EventDispatcherDispatchEightListeners)
+   {
+      auto dispatcher = flair::make_shared<EventDispatcher>();
+      auto event = flair::make_shared<Event>(Event::ENTER_FRAME);
+      int calls = 0;
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<0>{ &calls });
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<1>{ &calls }, false, 10);
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<2>{ &calls });
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<3>{ &calls }, false, -10);
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<4>{ &calls });
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<5>{ &calls });
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<6>{ &calls });
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<7>{ &calls });
+      
+      // A listener of another type in between, as most dispatchers have
+      dispatcher->addEventListener(Event::COMPLETE, Listener<0>{ &calls });
+      state.items(8);
+      
+      while (state.next()) {
+         dispatcher->dispatchEvent(event);
+      }
+      flair::bench::keep(calls);
+   }
+   
+   FLAIR_BENCHMARK(EventDispatcherDispatchNewEvent)
+   {
+      auto dispatcher = flair::make_shared<EventDispatcher>();
+      int calls = 0;
+      dispatcher->addEventListener(Event::ENTER_FRAME, Listener<0>{ &calls });
+      
+      while (state.next()) {
+         dispatcher->dispatchEvent(flair::make_shared<Event>(Event::ENTER_FRAME));
+      }
+      flair::bench::keep(calls);
+   }
+   
+}
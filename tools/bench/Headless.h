@@ -0,0 +1,69 @@
+#ifndef flair_bench_Headless_h
+#define flair_bench_Headless_h
+
+#include "flair/flair.h"
+#include "flair/display/BitmapData.h"
+#include "flair/display/RenderSupport.h"
+#include "flair/display/Stage.h"
+#include "flair/internal/services/null/RenderService.h"
+
+namespace flair {
+namespace bench {
+   
+   // A stage that can be driven frame by frame without an application
+   class HeadlessStage : public flair::display::Stage
+   {
+      friend class flair::allocator;
+      
+   protected:
+      HeadlessStage(int width = 1280, int height = 720) : Stage()
+      {
+         _stageWidth = width;
+         _stageHeight = height;
+      }
+      
+   public:
+      // Tick, update and render as the application loop does them
+      void frame(flair::display::RenderSupport * support, float deltaSeconds)
+      {
+         tick(deltaSeconds);
+         update();
+         render(support, alpha(), geom::Matrix());
+      }
+      
+      using Stage::tick;
+      using Stage::update;
+   };
+   
+   // Renders through the null backend, which accepts every call and draws nothing. Bitmap data
+   // made while one exists gets null textures, keep it alive until that bitmap data is gone.
+   class HeadlessRenderSupport : public flair::display::RenderSupport
+   {
+   public:
+      HeadlessRenderSupport()
+      {
+         RenderSupport::renderService = &_renderService;
+         Textures::install(&_renderService);
+      }
+      
+      virtual ~HeadlessRenderSupport()
+      {
+         RenderSupport::renderService = nullptr;
+         Textures::install(nullptr);
+      }
+      
+   private:
+      struct Textures : public flair::display::BitmapData
+      {
+         static void install(flair::internal::services::IRenderService * service)
+         {
+            BitmapData::renderService = service;
+         }
+      };
+      
+      flair::internal::services::null::RenderService _renderService;
+   };
+   
+}}
+
+#endif
@@ -0,0 +1,58 @@
+#include "Benchmark.h"
+
+namespace {
+   using flair::JSON;
+   
+   // Something like a level or a sprite sheet description, about 40KB
+   JSON document()
+   {
+      JSON::Array entities;
+      for (int i = 0; i < 256; ++i) {
+         entities.push_back(JSON::Object {
+            { "name", "entity" + std::to_string(i) },
+            { "x", i * 12.5 },
+            { "y", i * -3.25 },
+            { "visible", i % 3 != 0 },
+            { "frame", JSON::Object { { "x", i * 16 }, { "y", 0 }, { "w", 16 }, { "h", 16 } } },
+            { "tags", JSON::Array { "sprite", "layer" + std::to_string(i % 4) } }
+         });
+      }
+      return JSON::Object { { "version", 3 }, { "title", "Benchmark \"level\"\n" }, { "entities", entities } };
+   }
+   
+   FLAIR_BENCHMARK(JSONParse)
+   {
+      std::string text = document().stringify();
+      state.bytes(text.size());
+      
+      std::string error;
+      while (state.next()) {
+         flair::bench::keep(JSON::parse(text, error));
+      }
+   }
+   
+   FLAIR_BENCHMARK(JSONParseBuffer)
+   {
+      std::string text = document().stringify();
+      state.bytes(text.size());
+      
+      std::string error;
+      while (state.next()) {
+         flair::bench::keep(JSON::parse(text.data(), text.size(), error));
+      }
+   }
+   
+   FLAIR_BENCHMARK(JSONStringify)
+   {
+      JSON json = document();
+      std::string text;
+      state.bytes(json.stringify().size());
+      
+      while (state.next()) {
+         text.clear();
+         json.stringify(text);
+      }
+      flair::bench::keep(text);
+   }
+   
+}
@@ -0,0 +1,99 @@
+#include "Benchmark.h"
+#include "flair/geom/Matrix.h"
+#include "flair/geom/Point.h"
+
+#include <vector>
+
+namespace {
+   using flair::geom::Matrix;
+   using flair::geom::Point;
+   
+   const size_t COUNT = 1024;
+   
+   Matrix transform(size_t i)
+   {
+      Matrix m;
+      m.scale(1.0f + i % 7 * 0.1f, 1.0f);
+      m.rotate(i * 0.01f);
+      m.translate(i * 2.0f, i * -1.0f);
+      return m;
+   }
+   
+   FLAIR_BENCHMARK(MatrixMultiply)
+   {
+      std::vector<Matrix> parents, children, out(COUNT);
+      for (size_t i = 0; i < COUNT; ++i) {
+         parents.push_back(transform(i));
+         children.push_back(transform(COUNT - i));
+      }
+      state.items(COUNT);
+      
+      while (state.next()) {
+         for (size_t i = 0; i < COUNT; ++i) out[i] = parents[i] * children[i];
+         flair::bench::keep(out);
+      }
+   }
+   
+   FLAIR_BENCHMARK(MatrixConcat)
+   {
+      std::vector<Matrix> parents, children, out(COUNT);
+      for (size_t i = 0; i < COUNT; ++i) {
+         parents.push_back(transform(i));
+         children.push_back(transform(COUNT - i));
+      }
+      state.items(COUNT);
+      
+      while (state.next()) {
+         Matrix::concat(parents.data(), children.data(), out.data(), COUNT);
+         flair::bench::keep(out);
+      }
+   }
+   
+   FLAIR_BENCHMARK(MatrixTransformPoint)
+   {
+      Matrix m = transform(3);
+      std::vector<Point> points, out(COUNT);
+      for (size_t i = 0; i < COUNT; ++i) points.push_back(Point(i * 1.5f, i * -0.5f));
+      state.items(COUNT);
+      
+      while (state.next()) {
+         for (size_t i = 0; i < COUNT; ++i) out[i] = m.transformPoint(points[i]);
+         flair::bench::keep(out);
+      }
+   }
+   
+   FLAIR_BENCHMARK(MatrixTransformPoints)
+   {
+      Matrix m = transform(3);
+      std::vector<float> points, out(COUNT * 2);
+      for (size_t i = 0; i < COUNT; ++i) {
+         points.push_back(i * 1.5f);
+         points.push_back(i * -0.5f);
+      }
+      state.items(COUNT);
+      
+      while (state.next()) {
+         Matrix::transformPoints(m, points.data(), out.data(), COUNT);
+         flair::bench::keep(out);
+      }
+   }
+   
+   FLAIR_BENCHMARK(MatrixTransformRectangles)
+   {
+      Matrix m = transform(3);
+      std::vector<float> rectangles, out(COUNT * 4);
+      for (size_t i = 0; i < COUNT; ++i) {
+         rectangles.push_back(i * 1.5f);
+         rectangles.push_back(i * -0.5f);
+         rectangles.push_back(32.0f);
+         rectangles.push_back(16.0f);
+      }
+      state.items(COUNT);
+      
+      while (state.next()) {
+         Matrix::transformRectangles(m, rectangles.data(), out.data(), COUNT);
+         flair::bench::keep(out);
+      }
+   }
+   
+}
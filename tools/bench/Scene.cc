@@ -0,0 +1,366 @@
+#include "Scene.h"
+#include "Allocations.h"
+#include "Benchmark.h"
+#include "flair/display/Bitmap.h"
+#include "flair/display/BitmapData.h"
+#include "flair/display/Sprite.h"
+#include "flair/system/Memory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+   using flair::bench::HeadlessRenderSupport;
+   using flair::bench::HeadlessStage;
+   using flair::bench::SceneOptions;
+   using flair::bench::SceneSize;
+   using flair::display::Bitmap;
+   using flair::display::BitmapData;
+   using flair::display::DisplayObject;
+   using flair::display::Sprite;
+   
+   const float FRAME_SECONDS = 1.0f / 60.0f;
+   
+   // The standard distributions differ between libraries, this gives the same scene everywhere
+   class Random
+   {
+   public:
+      Random(uint32_t seed) : _state(seed ? seed : 1) {}
+      
+      uint32_t next()
+      {
+         _state ^= _state << 13;
+         _state ^= _state >> 17;
+         _state ^= _state << 5;
+         return _state;
+      }
+      
+      // In [0, 1)
+      float unit()
+      {
+         return (next() >> 8) / 16777216.0f;
+      }
+      
+   private:
+      uint32_t _state;
+   };
+   
+   // A container that moves some of its children about their place every tick, the way game
+   // code animates from a tick override
+   class Layer : public Sprite
+   {
+      friend class flair::allocator;
+      
+   protected:
+      Layer() : Sprite(), _time(0.0f) {}
+      
+   public:
+      virtual ~Layer() {}
+      
+      void animate(DisplayObject * child, float phase)
+      {
+         _motions.push_back(Motion{ child, child->x(), child->y(), phase });
+      }
+      
+      void tick(float deltaSeconds) override
+      {
+         Sprite::tick(deltaSeconds);
+         
+         _time += deltaSeconds;
+         for (auto const& motion : _motions) {
+            float angle = _time * 2.0f + motion.phase;
+            motion.object->x(motion.x + std::sin(angle) * 8.0f);
+            motion.object->y(motion.y + std::cos(angle) * 8.0f);
+            motion.object->rotation(std::sin(angle * 0.5f) * 10.0f);
+         }
+      }
+      
+   protected:
+      struct Motion
+      {
+         DisplayObject * object;
+         float x;
+         float y;
+         float phase;
+      };
+      
+      std::vector<Motion> _motions;
+      float _time;
+   };
+   
+   struct Generator
+   {
+      Generator(SceneOptions const& options) : options(options), random(options.seed), size{ 0, 0, 0 }
+      {
+         for (uint32_t i = 0; i < std::max<uint32_t>(options.textures, 1); ++i) {
+            int side = 16 << (random.next() % 4);
+            textures.push_back(flair::make_shared<BitmapData>(side, side));
+         }
+      }
+      
+      // Fills layer with children spread over width by height
+      void fill(std::shared_ptr<Layer> const& layer, uint32_t level, float width, float height)
+      {
+         size.containers++;
+         
+         for (uint32_t i = 0; i < options.breadth; ++i) {
+            std::shared_ptr<DisplayObject> child;
+            if (level == options.depth || random.unit() < options.bitmaps) {
+               child = flair::make_shared<Bitmap>(textures[random.next() % textures.size()]);
+               child->x(random.unit() * width);
+               child->y(random.unit() * height);
+               size.bitmaps++;
+            }
+            else {
+               auto container = flair::make_shared<Layer>();
+               container->x(random.unit() * width / 2.0f);
+               container->y(random.unit() * height / 2.0f);
+               fill(container, level + 1, width / 2.0f, height / 2.0f);
+               child = container;
+            }
+            
+            layer->addChild(child);
+            if (random.unit() < options.animated) {
+               layer->animate(child.get(), random.unit() * 6.2831853f);
+               size.animated++;
+            }
+         }
+      }
+      
+      SceneOptions const& options;
+      Random random;
+      SceneSize size;
+      std::vector<std::shared_ptr<BitmapData>> textures;
+   };
+   
+   struct FrameSamples
+   {
+      std::vector<double> frame;
+      std::vector<double> tick;
+      std::vector<double> update;
+      std::vector<double> render;
+      std::vector<double> allocations;
+      std::vector<double> drawCalls;
+   };
+   
+   double milliseconds(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / 1e6;
+   }
+   
+   // Runs frames of the stage, sampling each when samples is set
+   void runFrames(HeadlessStage * stage, HeadlessRenderSupport * support, uint32_t frames, FrameSamples * samples)
+   {
+      for (uint32_t i = 0; i < frames; ++i) {
+         uint64_t allocations = flair::bench::allocations();
+         uint64_t drawCalls = support->drawCalls();
+         
+         auto begin = std::chrono::steady_clock::now();
+         stage->tick(FRAME_SECONDS);
+         auto ticked = std::chrono::steady_clock::now();
+         stage->update();
+         auto updated = std::chrono::steady_clock::now();
+         stage->render(support, stage->alpha(), flair::geom::Matrix());
+         auto end = std::chrono::steady_clock::now();
+         
+         if (!samples) continue;
+         
+         samples->frame.push_back(milliseconds(begin, end));
+         samples->tick.push_back(milliseconds(begin, ticked));
+         samples->update.push_back(milliseconds(ticked, updated));
+         samples->render.push_back(milliseconds(updated, end));
+         samples->allocations.push_back(static_cast<double>(flair::bench::allocations() - allocations));
+         samples->drawCalls.push_back(static_cast<double>(support->drawCalls() - drawCalls));
+      }
+   }
+   
+   void printStatistic(const char * name, flair::bench::FrameStatistic const& statistic)
+   {
+      std::printf("%-16s %10.3f %10.3f %10.3f %10.3f %10.3f\n", name, statistic.mean, statistic.p50, statistic.p90, statistic.p99, statistic.max);
+   }
+   
+   // Every frame of the default scene, comparable across commits like the other benchmarks
+   FLAIR_BENCHMARK(SceneFrame)
+   {
+      HeadlessRenderSupport support;
+      auto stage = flair::bench::generateScene(SceneOptions());
+      runFrames(stage.get(), &support, 10, nullptr);
+      
+      while (state.next()) {
+         stage->tick(FRAME_SECONDS);
+         stage->update();
+         stage->render(&support, stage->alpha(), flair::geom::Matrix());
+      }
+   }
+}
+
+namespace flair {
+namespace bench {
+   
+   flair::JSON SceneOptions::toJSON() const
+   {
+      return flair::JSON::Object {
+         { "breadth", static_cast<int>(breadth) },
+         { "depth", static_cast<int>(depth) },
+         { "bitmaps", bitmaps },
+         { "animated", animated },
+         { "textures", static_cast<int>(textures) },
+         { "seed", static_cast<double>(seed) }
+      };
+   }
+   
+   std::shared_ptr<HeadlessStage> generateScene(SceneOptions const& options, SceneSize * size)
+   {
+      auto stage = flair::make_shared<HeadlessStage>();
+      auto root = flair::make_shared<Layer>();
+      
+      float width = stage->stageWidth() * 2.0f;
+      float height = stage->stageHeight() * 2.0f;
+      root->x(-width / 4.0f);
+      root->y(-height / 4.0f);
+      
+      Generator generator(options);
+      generator.fill(root, 0, width, height);
+      stage->addChild(root);
+      
+      if (size) *size = generator.size;
+      return stage;
+   }
+   
+   FrameStatistic FrameStatistic::of(std::vector<double> values)
+   {
+      FrameStatistic statistic = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+      if (values.empty()) return statistic;
+      
+      std::sort(values.begin(), values.end());
+      
+      // Nearest rank
+      auto percentile = [&values](double p) {
+         size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+         return values[std::min(std::max<size_t>(rank, 1), values.size()) - 1];
+      };
+      
+      double sum = 0.0;
+      for (double value : values) sum += value;
+      
+      statistic.mean = sum / values.size();
+      statistic.p50 = percentile(50.0);
+      statistic.p90 = percentile(90.0);
+      statistic.p99 = percentile(99.0);
+      statistic.max = values.back();
+      return statistic;
+   }
+   
+   flair::JSON FrameStatistic::toJSON() const
+   {
+      return flair::JSON::Object {
+         { "mean", mean },
+         { "p50", p50 },
+         { "p90", p90 },
+         { "p99", p99 },
+         { "max", max }
+      };
+   }
+   
+   int runScene(int argc, char ** argv)
+   {
+      SceneOptions options;
+      uint32_t frames = 600;
+      uint32_t warmup = 60;
+      std::string json;
+      
+      for (int i = 1; i < argc; ++i) {
+         const char * argument = argv[i];
+         const char * value = std::strchr(argument, '=');
+         std::string name = value ? std::string(argument, value - argument) : argument;
+         value = value ? value + 1 : "";
+         
+         if (name == "--breadth") options.breadth = std::max(1, std::atoi(value));
+         else if (name == "--depth") options.depth = std::max(0, std::atoi(value));
+         else if (name == "--bitmaps") options.bitmaps = static_cast<float>(std::atof(value));
+         else if (name == "--animated") options.animated = static_cast<float>(std::atof(value));
+         else if (name == "--textures") options.textures = std::max(1, std::atoi(value));
+         else if (name == "--seed") options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+         else if (name == "--frames") frames = std::max(1, std::atoi(value));
+         else if (name == "--warmup") warmup = std::max(0, std::atoi(value));
+         else if (name == "--json") json = value;
+         else {
+            std::fprintf(stderr, "usage: bench scene [--breadth=8] [--depth=4] [--bitmaps=0.5] [--animated=0.2] [--textures=16] [--seed=1] [--frames=600] [--warmup=60] [--json=out.json]\n");
+            return 1;
+         }
+      }
+
+#ifndef NDEBUG
+      std::fprintf(stderr, "Warning: built without NDEBUG, the numbers are not representative\n");
+#endif
+      
+      HeadlessRenderSupport support;
+      SceneSize size;
+      auto stage = generateScene(options, &size);
+      
+      int64_t textureBytes = 0;
+      for (auto const& usage : flair::system::memoryStats().usage) {
+         if (usage.category == flair::system::MemoryCategory::TEXTURE) textureBytes += usage.bytes;
+      }
+      
+      std::printf("scene: %u containers, %u bitmaps, %u animated, %u textures (%.1f MB)\n", size.containers, size.bitmaps, size.animated, options.textures, textureBytes / 1048576.0);
+      std::printf("%u frames after %u warmup\n\n", frames, warmup);
+      
+      runFrames(stage.get(), &support, warmup, nullptr);
+      
+      FrameSamples samples;
+      runFrames(stage.get(), &support, frames, &samples);
+      
+      FrameStatistic frame = FrameStatistic::of(samples.frame);
+      FrameStatistic tick = FrameStatistic::of(samples.tick);
+      FrameStatistic update = FrameStatistic::of(samples.update);
+      FrameStatistic render = FrameStatistic::of(samples.render);
+      FrameStatistic allocations = FrameStatistic::of(samples.allocations);
+      FrameStatistic drawCalls = FrameStatistic::of(samples.drawCalls);
+      
+      std::printf("%-16s %10s %10s %10s %10s %10s\n", "per frame", "mean", "p50", "p90", "p99", "max");
+      printStatistic("frame ms", frame);
+      printStatistic("tick ms", tick);
+      printStatistic("update ms", update);
+      printStatistic("render ms", render);
+      printStatistic("allocations", allocations);
+      printStatistic("draw calls", drawCalls);
+      
+      if (!json.empty()) {
+#ifdef NDEBUG
+         const char * build = "release";
+#else
+         const char * build = "debug";
+#endif
+         flair::JSON report = flair::JSON::Object {
+            { "build", build },
+            { "options", options },
+            { "containers", static_cast<int>(size.containers) },
+            { "bitmaps", static_cast<int>(size.bitmaps) },
+            { "animated", static_cast<int>(size.animated) },
+            { "textureBytes", static_cast<double>(textureBytes) },
+            { "frames", static_cast<int>(frames) },
+            { "frameTime", frame },
+            { "tickTime", tick },
+            { "updateTime", update },
+            { "renderTime", render },
+            { "allocations", allocations },
+            { "drawCalls", drawCalls }
+         };
+         
+         std::ofstream file(json);
+         file << report.stringify() << '\n';
+         if (!file) {
+            std::fprintf(stderr, "Could not write %s\n", json.c_str());
+            return 1;
+         }
+      }
+      return 0;
+   }
+   
+}}
@@ -0,0 +1,72 @@
+#ifndef flair_bench_Scene_h
+#define flair_bench_Scene_h
+
+#include "flair/flair.h"
+#include "Headless.h"
+
+#include <vector>
+
+namespace flair {
+namespace bench {
+   
+   // Shape of a generated scene. The same options and seed always give the same tree.
+   struct SceneOptions
+   {
+      SceneOptions() : breadth(8), depth(4), bitmaps(0.5f), animated(0.2f), textures(16), seed(1) {}
+      
+      // Children of every container, and levels of containers below the root
+      uint32_t breadth;
+      uint32_t depth;
+      
+      // Fraction of the children of a container that are bitmaps, the rest are containers.
+      // The deepest level is all bitmaps.
+      float bitmaps;
+      
+      // Fraction of all objects that move every frame
+      float animated;
+      
+      // Distinct bitmap data the bitmaps share, from 16x16 to 128x128
+      uint32_t textures;
+      
+      uint32_t seed;
+      
+      flair::JSON toJSON() const;
+   };
+   
+   struct SceneSize
+   {
+      uint32_t containers;
+      uint32_t bitmaps;
+      uint32_t animated;
+   };
+   
+   // Builds a tree like a production scene: nested layers of bitmaps spread over twice the
+   // stage, so part of it is culled, with some objects moving about their place in tick.
+   // Bitmap data is made through the current render service, build under a
+   // HeadlessRenderSupport.
+   std::shared_ptr<HeadlessStage> generateScene(SceneOptions const& options, SceneSize * size = nullptr);
+   
+   // Distribution of one per frame measurement
+   struct FrameStatistic
+   {
+      double mean;
+      double p50;
+      double p90;
+      double p99;
+      double max;
+      
+      static FrameStatistic of(std::vector<double> values);
+      
+      flair::JSON toJSON() const;
+   };
+   
+   // Runs frames of tick, update and render of a generated scene through the null renderer,
+   // the bench "scene" command. Frame times are in milliseconds.
+   //
+   //    bench scene [--breadth=8] [--depth=4] [--bitmaps=0.5] [--animated=0.2] [--textures=16]
+   //                [--seed=1] [--frames=600] [--warmup=60] [--json=out.json]
+   int runScene(int argc, char ** argv);
+   
+}}
+
+#endif
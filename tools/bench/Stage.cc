@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+#include "Headless.h"
+#include "flair/display/Bitmap.h"
+#include "flair/display/BitmapData.h"
+#include "flair/display/Sprite.h"
+
+namespace {
+   using flair::bench::HeadlessRenderSupport;
+   using flair::bench::HeadlessStage;
+   using flair::display::Bitmap;
+   using flair::display::BitmapData;
+   using flair::display::Sprite;
+   
+   const int LAYERS = 32;
+   const int BITMAPS = 32;
+   
+   // Layers of bitmaps in a grid over the stage, some of it off screen
+   std::shared_ptr<HeadlessStage> scene()
+   {
+      auto stage = flair::make_shared<HeadlessStage>();
+      auto bitmapData = flair::make_shared<BitmapData>(32, 32);
+      
+      for (int i = 0; i < LAYERS; ++i) {
+         auto layer = flair::make_shared<Sprite>();
+         layer->x(i * 48.0f);
+         for (int j = 0; j < BITMAPS; ++j) {
+            auto bitmap = flair::make_shared<Bitmap>(bitmapData);
+            bitmap->y(j * 32.0f);
+            layer->addChild(bitmap);
+         }
+         stage->addChild(layer);
+      }
+      stage->update();
+      return stage;
+   }
+   
+   FLAIR_BENCHMARK(StageTick)
+   {
+      HeadlessRenderSupport support;
+      auto stage = scene();
+      state.items(LAYERS * BITMAPS);
+      
+      while (state.next()) {
+         stage->tick(1.0f / 60.0f);
+      }
+   }
+   
+   FLAIR_BENCHMARK(StageUpdateStill)
+   {
+      HeadlessRenderSupport support;
+      auto stage = scene();
+      state.items(LAYERS * BITMAPS);
+      
+      while (state.next()) {
+         stage->update();
+      }
+   }
+   
+   // Every layer moves, so every world transform and bound is brought up to date
+   FLAIR_BENCHMARK(StageUpdateMoving)
+   {
+      HeadlessRenderSupport support;
+      auto stage = scene();
+      state.items(LAYERS * BITMAPS);
+      
+      float offset = 0.0f;
+      while (state.next()) {
+         offset = offset > 100.0f ? 0.0f : offset + 1.0f;
+         for (int i = 0; i < LAYERS; ++i) stage->getChildAt(i)->y(offset);
+         stage->update();
+      }
+   }
+   
+   FLAIR_BENCHMARK(StageRender)
+   {
+      HeadlessRenderSupport support;
+      auto stage = scene();
+      state.items(LAYERS * BITMAPS);
+      
+      while (state.next()) {
+         stage->render(&support, stage->alpha(), flair::geom::Matrix());
+      }
+   }
+   
+   FLAIR_BENCHMARK(StageFrame)
+   {
+      HeadlessRenderSupport support;
+      auto stage = scene();
+      state.items(LAYERS * BITMAPS);
+      
+      while (state.next()) {
+         stage->frame(&support, 1.0f / 60.0f);
+      }
+   }
+   
+}
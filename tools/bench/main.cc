@@ -0,0 +1,22 @@
+#include "Benchmark.h"
+#include "Scene.h"
+
+#include <cstring>
+
+// Times the engine's hot paths. Build the Release configuration, save a baseline with --json
+// and pass it to --compare on a later commit to see the change in the median of each benchmark.
+//
+//    bench [--filter=text] [--repetitions=10] [--warmup=1] [--min-time=ms] [--iterations=n]
+//          [--json=out.json] [--compare=baseline.json] [--list]
+//
+// The scene command instead runs frames of a generated scene and reports their distribution,
+// see Scene.h.
+//
+//    bench scene [options]
+
+int main(int argc, char ** argv)
+{
+   if (argc > 1 && std::strcmp(argv[1], "scene") == 0) return flair::bench::runScene(argc - 1, argv + 1);
+   
+   return flair::bench::run(argc, argv);
+}
@@ -0,0 +1,115 @@
+#include "flair/flair.h"
+#include "flair/utils/ByteArray.h"
+#include "flair/internal/services/capture/RenderReplay.h"
+#include "flair/internal/services/null/RenderService.h"
+
+#ifdef FLAIR_PLATFORM_SDL
+#include "flair/internal/services/sdl/WindowService.h"
+#include "flair/internal/services/sdl/RenderService.h"
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Replays a render capture (see the renderCapture application descriptor option) against a
+// backend and prints the time spent on every frame.
+//
+//    renderreplay <capture> [--backend=null|sdl] [--quiet]
+
+using flair::utils::ByteArray;
+using namespace flair::internal::services;
+
+int main(int argc, char ** argv)
+{
+   std::string path;
+   std::string backend = "null";
+   bool quiet = false;
+   
+   for (int i = 1; i < argc; ++i) {
+      if (strncmp(argv[i], "--backend=", 10) == 0) backend = argv[i] + 10;
+      else if (strcmp(argv[i], "--quiet") == 0) quiet = true;
+      else path = argv[i];
+   }
+   
+   if (path.empty()) {
+      fprintf(stderr, "usage: renderreplay <capture> [--backend=null|sdl] [--quiet]\n");
+      return 1;
+   }
+   
+   std::ifstream file(path, std::ios::binary);
+   if (!file) {
+      fprintf(stderr, "Could not open %s\n", path.c_str());
+      return 1;
+   }
+   
+   std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+   auto bytes = flair::make_shared<ByteArray>();
+   bytes->writeBytes(contents.data(), 0, contents.size());
+   bytes->position(0);
+   
+   capture::RenderReplay replay(bytes);
+   int width, height;
+   bool vsync;
+   if (!replay.open(&width, &height, &vsync)) {
+      fprintf(stderr, "%s is not a render capture\n", path.c_str());
+      return 1;
+   }
+   
+#ifdef FLAIR_PLATFORM_SDL
+   IWindowService * windowService = nullptr;
+#endif
+   IRenderService * renderService = nullptr;
+   
+   if (backend == "null") {
+      renderService = new null::RenderService();
+   }
+#ifdef FLAIR_PLATFORM_SDL
+   else if (backend == "sdl") {
+      windowService = new sdl::WindowService();
+      windowService->create("renderreplay", flair::geom::Rectangle(-1, -1, width > 0 ? width : 640, height > 0 ? height : 480), 0, true);
+      windowService->activate();
+      
+      // Never wait for vsync, the timings should show the cost of the calls
+      renderService = new sdl::RenderService();
+      renderService->create(windowService, false);
+   }
+#endif
+   else {
+      fprintf(stderr, "Unknown backend %s\n", backend.c_str());
+      return 1;
+   }
+   
+   std::vector<double> times;
+   capture::RenderReplay::FrameTiming timing;
+   while (replay.next(renderService, &timing)) {
+      times.push_back(timing.milliseconds);
+      if (!quiet) printf("frame %u: %.3f ms, %u draws, %u uploads\n", timing.frame, timing.milliseconds, timing.drawCalls, timing.textureUploads);
+   }
+   replay.close(renderService);
+   
+   if (!times.empty()) {
+      std::vector<double> sorted = times;
+      std::sort(sorted.begin(), sorted.end());
+      double total = 0.0;
+      for (auto time : times) total += time;
+      
+      printf("%zu frames on %s: avg %.3f ms, min %.3f ms, median %.3f ms, p95 %.3f ms, max %.3f ms\n", times.size(), backend.c_str(),
+         total / times.size(), sorted.front(), sorted[sorted.size() / 2], sorted[(sorted.size() * 95) / 100], sorted.back());
+   }
+   
+#ifdef FLAIR_PLATFORM_SDL
+   if (windowService) {
+      delete static_cast<sdl::RenderService*>(renderService);
+      delete static_cast<sdl::WindowService*>(windowService);
+      return 0;
+   }
+#endif
+   
+   delete static_cast<null::RenderService*>(renderService);
+   return 0;
+}